@@ -0,0 +1,296 @@
+#ifndef GDWG_ALL_PAIRS_SHORTEST_PATHS_HPP
+#define GDWG_ALL_PAIRS_SHORTEST_PATHS_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/dijkstra.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Dense V x V shortest-path distances, indexed by the positions in nodes().
+	template<typename N, typename E>
+	class distance_matrix {
+	public:
+		using size_type = std::size_t;
+
+		// `distances` is row-major with `stride` columns per row; entries at or above `limit` are
+		// unreachable.
+		distance_matrix(std::vector<N> nodes, std::vector<E> distances, size_type stride, E limit)
+		: nodes_{std::move(nodes)}
+		, distances_{std::move(distances)}
+		, stride_{stride}
+		, limit_{limit} {}
+
+		[[nodiscard]] auto nodes() const noexcept -> std::vector<N> const& {
+			return this->nodes_;
+		}
+
+		[[nodiscard]] auto size() const noexcept -> size_type {
+			return this->nodes_.size();
+		}
+
+		[[nodiscard]] auto distance(size_type src, size_type dst) const -> std::optional<E> {
+			auto const d = this->distances_[src * this->stride_ + dst];
+			if (d >= this->limit_) {
+				return std::nullopt;
+			}
+			return d;
+		}
+
+		[[nodiscard]] auto distance(N const& src, N const& dst) const -> std::optional<E> {
+			auto const s = std::lower_bound(this->nodes_.cbegin(), this->nodes_.cend(), src);
+			auto const d = std::lower_bound(this->nodes_.cbegin(), this->nodes_.cend(), dst);
+			if (s == this->nodes_.cend() or src < *s or d == this->nodes_.cend() or dst < *d) {
+				throw std::runtime_error("Cannot call gdwg::distance_matrix<N, E>::distance if src "
+				                         "or dst node don't exist in the graph");
+			}
+			return this->distance(static_cast<size_type>(s - this->nodes_.cbegin()),
+			                      static_cast<size_type>(d - this->nodes_.cbegin()));
+		}
+
+	private:
+		std::vector<N> nodes_;
+		std::vector<E> distances_;
+		size_type stride_;
+		E limit_;
+	};
+
+	namespace detail {
+		inline constexpr auto floyd_warshall_block = std::size_t{64};
+
+		// The value used for "no path". Integral distances use half the maximum so that adding two
+		// of them cannot overflow.
+		template<typename E>
+		constexpr auto distance_infinity() noexcept -> E {
+			if constexpr (std::numeric_limits<E>::has_infinity) {
+				return std::numeric_limits<E>::infinity();
+			}
+			else {
+				return std::numeric_limits<E>::max() / 2;
+			}
+		}
+
+		// Anything at or above this is treated as unreachable. For integral distances a negative
+		// edge added to infinity lands just below it, so the cut-off sits well beneath infinity.
+		template<typename E>
+		constexpr auto distance_limit() noexcept -> E {
+			if constexpr (std::numeric_limits<E>::has_infinity) {
+				return std::numeric_limits<E>::infinity();
+			}
+			else {
+				return distance_infinity<E>() / 2;
+			}
+		}
+
+		// Min-plus update of block c through blocks a and b, where c may alias a or b (the diagonal,
+		// row and column phases), so k has to be the outermost loop. The inner loop is a contiguous,
+		// branch-free min over one row, which compilers turn into packed SIMD min/add.
+		template<typename E>
+		auto min_plus_dependent(E* c, E const* a, E const* b, std::size_t stride, E limit) -> void {
+			for (auto k = std::size_t{0}; k < floyd_warshall_block; ++k) {
+				auto const* bk = b + k * stride;
+				for (auto i = std::size_t{0}; i < floyd_warshall_block; ++i) {
+					auto const aik = a[i * stride + k];
+					if (aik >= limit) {
+						continue;
+					}
+					auto* ci = c + i * stride;
+					for (auto j = std::size_t{0}; j < floyd_warshall_block; ++j) {
+						ci[j] = std::min(ci[j], static_cast<E>(aik + bk[j]));
+					}
+				}
+			}
+		}
+
+		// As above, for a block c that shares no storage with a or b. Keeping a row of c hot across
+		// the whole k loop halves the memory traffic of the dependent form.
+		template<typename E>
+		auto min_plus_independent(E* c, E const* a, E const* b, std::size_t stride, E limit)
+		   -> void {
+			for (auto i = std::size_t{0}; i < floyd_warshall_block; ++i) {
+				auto* ci = c + i * stride;
+				auto const* ai = a + i * stride;
+				for (auto k = std::size_t{0}; k < floyd_warshall_block; ++k) {
+					auto const aik = ai[k];
+					if (aik >= limit) {
+						continue;
+					}
+					auto const* bk = b + k * stride;
+					for (auto j = std::size_t{0}; j < floyd_warshall_block; ++j) {
+						ci[j] = std::min(ci[j], static_cast<E>(aik + bk[j]));
+					}
+				}
+			}
+		}
+
+		// Bellman-Ford potentials from a virtual source joined to every node with weight zero,
+		// computed with a FIFO work queue so that only nodes whose potential changed are rescanned.
+		// Throws if a negative cycle is found.
+		template<typename N, typename E>
+		auto johnson_potentials(csr<N, E> const& g) -> std::vector<E> {
+			auto const n = g.node_count();
+			auto potentials = std::vector<E>(n, E{0});
+			if (std::none_of(g.weights.cbegin(), g.weights.cend(), [](E w) { return w < E{0}; })) {
+				return potentials;
+			}
+
+			// A shortest path has fewer than n edges, so a longer one means a negative cycle.
+			auto hops = std::vector<std::size_t>(n, 0U);
+			auto queued = std::vector<char>(n, 1);
+			auto queue = std::deque<std::size_t>(n);
+			std::iota(queue.begin(), queue.end(), std::size_t{0});
+			while (not queue.empty()) {
+				auto const u = queue.front();
+				queue.pop_front();
+				queued[u] = 0;
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					auto const v = g.targets[e];
+					auto const candidate = static_cast<E>(potentials[u] + g.weights[e]);
+					if (candidate < potentials[v]) {
+						potentials[v] = candidate;
+						hops[v] = hops[u] + 1U;
+						if (hops[v] >= n) {
+							throw std::runtime_error("Cannot call gdwg::johnson on a graph with a "
+							                         "negative cycle");
+						}
+						if (queued[v] == 0) {
+							queued[v] = 1;
+							queue.push_back(v);
+						}
+					}
+				}
+			}
+			return potentials;
+		}
+	} // namespace detail
+
+	// All-pairs shortest paths over a dense copy of `g`, using cache-blocked Floyd-Warshall. Each
+	// multi-edge contributes its minimum weight. Intended for dense graphs of up to a few thousand
+	// nodes; the matrix takes O(V^2) memory. Throws if `g` has a negative cycle.
+	template<typename N, typename E>
+	auto floyd_warshall(graph<N, E> const& g) -> distance_matrix<N, E> {
+		static_assert(std::is_arithmetic_v<E>, "gdwg::floyd_warshall requires arithmetic weights");
+		constexpr auto block = detail::floyd_warshall_block;
+		constexpr auto infinity = detail::distance_infinity<E>();
+		constexpr auto limit = detail::distance_limit<E>();
+
+		auto adjacency = g.to_csr();
+		auto const n = adjacency.node_count();
+		auto const blocks = (n + block - 1U) / block;
+		auto const stride = blocks * block;
+		auto distances = std::vector<E>(stride * stride, infinity);
+
+		for (auto u = std::size_t{0}; u < n; ++u) {
+			auto* row = distances.data() + u * stride;
+			row[u] = E{0};
+			for (auto e = adjacency.offsets[u]; e < adjacency.offsets[u + 1U]; ++e) {
+				auto& d = row[adjacency.targets[e]];
+				d = std::min(d, adjacency.weights[e]);
+			}
+		}
+
+		auto* const d = distances.data();
+		auto const at = [d, stride](std::size_t bi, std::size_t bj) {
+			return d + bi * block * stride + bj * block;
+		};
+		for (auto kb = std::size_t{0}; kb < blocks; ++kb) {
+			auto* const pivot = at(kb, kb);
+			detail::min_plus_dependent(pivot, pivot, pivot, stride, limit);
+
+			// The pivot row and column only depend on the pivot block.
+			detail::parallel_for_dynamic(0U, 2U * blocks, [&](std::size_t i, std::size_t) {
+				auto const b = i / 2U;
+				if (b == kb) {
+					return;
+				}
+				if (i % 2U == 0U) {
+					auto* const c = at(kb, b);
+					detail::min_plus_dependent(c, pivot, c, stride, limit);
+				}
+				else {
+					auto* const c = at(b, kb);
+					detail::min_plus_dependent(c, c, pivot, stride, limit);
+				}
+			});
+
+			// Every other block only depends on its own pivot row and column blocks.
+			detail::parallel_for_dynamic(0U, blocks * blocks, [&](std::size_t i, std::size_t) {
+				auto const bi = i / blocks;
+				auto const bj = i % blocks;
+				if (bi == kb or bj == kb) {
+					return;
+				}
+				detail::min_plus_independent(at(bi, bj), at(bi, kb), at(kb, bj), stride, limit);
+			});
+		}
+
+		if constexpr (std::is_signed_v<E>) {
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				if (d[u * stride + u] < E{0}) {
+					throw std::runtime_error("Cannot call gdwg::floyd_warshall on a graph with a "
+					                         "negative cycle");
+				}
+			}
+		}
+		return distance_matrix<N, E>(std::move(adjacency.nodes), std::move(distances), stride, limit);
+	}
+
+	// All-pairs shortest paths for sparse graphs using Johnson's algorithm: one Bellman-Ford pass
+	// computes potentials that make every edge weight non-negative, then Dijkstra runs from every
+	// source in parallel. Nothing V x V is ever stored; instead `visit(src, distances)` is called
+	// once per source, where distances[j] is the distance from src to g.nodes()[j], or
+	// std::numeric_limits<E>::max() if it is unreachable. `visit` is called concurrently from
+	// several threads and the span is only valid for the duration of the call. Each multi-edge
+	// contributes its minimum weight. Throws if `g` has a negative cycle.
+	template<typename N, typename E, typename F>
+	auto johnson(graph<N, E> const& g, F visit) -> void {
+		static_assert(std::is_arithmetic_v<E>, "gdwg::johnson requires arithmetic weights");
+		constexpr auto unreachable = detail::dijkstra<E>::unreachable;
+
+		auto adjacency = g.to_csr().lightest_edges();
+		auto const n = adjacency.node_count();
+		auto const potentials = detail::johnson_potentials(adjacency);
+		for (auto u = std::size_t{0}; u < n; ++u) {
+			for (auto e = adjacency.offsets[u]; e < adjacency.offsets[u + 1U]; ++e) {
+				auto& w = adjacency.weights[e];
+				// Rounding can leave a floating point weight a hair below zero.
+				auto const v = adjacency.targets[e];
+				w = std::max(E{0}, static_cast<E>(w + potentials[u] - potentials[v]));
+			}
+		}
+
+		constexpr auto batch = std::size_t{16};
+		auto const workers = detail::worker_count(n, batch);
+		auto searches = std::vector<detail::dijkstra<E>>(workers, detail::dijkstra<E>(n));
+		auto rows = std::vector<std::vector<E>>(workers, std::vector<E>(n));
+		detail::parallel_for_dynamic(
+		   0U,
+		   n,
+		   [&](std::size_t src, std::size_t worker) {
+			   auto const distances = searches[worker].run(adjacency, src);
+			   auto& row = rows[worker];
+			   for (auto v = std::size_t{0}; v < n; ++v) {
+				   row[v] = distances[v] == unreachable
+				               ? unreachable
+				               : static_cast<E>(distances[v] - potentials[src] + potentials[v]);
+			   }
+			   visit(adjacency.nodes[src], std::span<E const>(row));
+		   },
+		   batch,
+		   workers);
+	}
+} // namespace gdwg
+
+#endif // GDWG_ALL_PAIRS_SHORTEST_PATHS_HPP
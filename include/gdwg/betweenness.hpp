@@ -0,0 +1,255 @@
+#ifndef GDWG_BETWEENNESS_HPP
+#define GDWG_BETWEENNESS_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	struct betweenness_options {
+		// Measure paths by the sum of their (lightest) edge weights instead of by hop count.
+		// Weights must then be positive.
+		bool weighted = false;
+		// When positive, estimate from a uniform sample of source nodes rather than from all of
+		// them, taking enough samples that, with probability at least 1 - delta, every normalised
+		// score is within epsilon of the exact one. If that would take n samples or more, the
+		// exact scores are computed instead.
+		double epsilon = 0.0;
+		double delta = 0.1;
+		std::mt19937::result_type seed = std::mt19937::default_seed;
+		// Divide by (n - 1)(n - 2), the number of ordered pairs of other nodes.
+		bool normalised = false;
+	};
+
+	namespace detail {
+		// Number of sources to sample for an (epsilon, delta) guarantee on every node at once.
+		// Each sample contributes n * dependency / ((n - 1)(n - 2)), which lies in [0, n / (n - 1)],
+		// so Hoeffding's inequality with a union bound over the n nodes gives the count.
+		inline auto betweenness_samples(std::size_t n, double epsilon, double delta)
+		   -> std::size_t {
+			auto const nodes = static_cast<double>(n);
+			auto const range = nodes / (nodes - 1.0);
+			auto const samples =
+			   std::ceil(range * range * std::log(2.0 * nodes / delta) / (2.0 * epsilon * epsilon));
+			return samples >= nodes ? n : static_cast<std::size_t>(samples);
+		}
+
+		// One single-source stage of Brandes' algorithm: counts shortest paths from the source,
+		// then walks the nodes back in order of distance to accumulate each node's dependency on
+		// the source. Distances have type D, which is the weight type for weighted lengths and
+		// std::size_t for hop counts. Only the nodes a run reached are reset, so one object serves
+		// many sources, and successors are found by re-checking distances, so no predecessor
+		// lists are stored.
+		template<typename D, bool Weighted>
+		class brandes {
+		public:
+			explicit brandes(std::size_t nodes)
+			: distances_(nodes, unreachable)
+			, paths_(nodes, 0.0)
+			, dependencies_(nodes, 0.0) {}
+
+			template<typename N, typename E>
+			auto accumulate(csr<N, E> const& g, std::size_t source, std::vector<double>& scores)
+			   -> void {
+				this->reset();
+				this->search(g, source);
+				for (auto i = this->order_.size(); i-- > 1U;) {
+					auto const w = this->order_[i];
+					auto dependency = 0.0;
+					for (auto e = g.offsets[w]; e < g.offsets[w + 1U]; ++e) {
+						auto const x = g.targets[e];
+						if (x != w and this->distances_[x] == this->step(g, w, e)) {
+							dependency += (1.0 + this->dependencies_[x]) / this->paths_[x];
+						}
+					}
+					this->dependencies_[w] = this->paths_[w] * dependency;
+					scores[w] += this->dependencies_[w];
+				}
+			}
+
+		private:
+			static constexpr auto unreachable = std::numeric_limits<D>::max();
+
+			std::vector<D> distances_;
+			std::vector<double> paths_;
+			std::vector<double> dependencies_;
+			// Reached nodes in non-decreasing order of distance.
+			std::vector<std::size_t> order_;
+			std::vector<std::pair<D, std::size_t>> heap_;
+
+			template<typename N, typename E>
+			[[nodiscard]] auto step(csr<N, E> const& g, std::size_t u, std::size_t e) const -> D {
+				if constexpr (Weighted) {
+					return static_cast<D>(this->distances_[u] + g.weights[e]);
+				}
+				else {
+					return this->distances_[u] + 1U;
+				}
+			}
+
+			// Breadth-first search for hop counts, Dijkstra for weighted lengths. Either way, a
+			// node's path count is complete before it is expanded.
+			template<typename N, typename E>
+			auto search(csr<N, E> const& g, std::size_t source) -> void {
+				this->distances_[source] = D{0};
+				this->paths_[source] = 1.0;
+				if constexpr (not Weighted) {
+					this->order_.push_back(source);
+					for (auto i = std::size_t{0}; i < this->order_.size(); ++i) {
+						auto const u = this->order_[i];
+						for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+							auto const v = g.targets[e];
+							auto const next = this->step(g, u, e);
+							if (this->distances_[v] == unreachable) {
+								this->distances_[v] = next;
+								this->order_.push_back(v);
+							}
+							if (this->distances_[v] == next) {
+								this->paths_[v] += this->paths_[u];
+							}
+						}
+					}
+					return;
+				}
+
+				this->heap_.emplace_back(D{0}, source);
+				while (not this->heap_.empty()) {
+					std::pop_heap(this->heap_.begin(), this->heap_.end(), std::greater<>{});
+					auto const [d, u] = this->heap_.back();
+					this->heap_.pop_back();
+					if (d > this->distances_[u]) {
+						continue;
+					}
+					this->order_.push_back(u);
+					for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+						auto const v = g.targets[e];
+						auto const candidate = this->step(g, u, e);
+						if (candidate < this->distances_[v]) {
+							this->distances_[v] = candidate;
+							this->paths_[v] = this->paths_[u];
+							this->heap_.emplace_back(candidate, v);
+							std::push_heap(this->heap_.begin(), this->heap_.end(), std::greater<>{});
+						}
+						else if (candidate == this->distances_[v] and v != u) {
+							this->paths_[v] += this->paths_[u];
+						}
+					}
+				}
+			}
+
+			auto reset() -> void {
+				for (auto const v : this->order_) {
+					this->distances_[v] = unreachable;
+					this->paths_[v] = 0.0;
+					this->dependencies_[v] = 0.0;
+				}
+				this->order_.clear();
+			}
+		};
+
+		// Sums the dependencies of every node on each of `sources`, with one brandes object and
+		// one score vector per std::thread worker, merged at the end.
+		template<typename D, bool Weighted, typename N, typename E>
+		auto accumulate_dependencies(csr<N, E> const& g, std::vector<std::size_t> const& sources)
+		   -> std::vector<double> {
+			auto const n = g.node_count();
+			auto const workers = worker_count(sources.size(), 1U);
+			auto searches = std::vector<brandes<D, Weighted>>(workers, brandes<D, Weighted>(n));
+			auto partial = std::vector<std::vector<double>>(workers, std::vector<double>(n, 0.0));
+			parallel_for_dynamic(
+			   0U,
+			   sources.size(),
+			   [&](std::size_t i, std::size_t worker) {
+				   searches[worker].accumulate(g, sources[i], partial[worker]);
+			   },
+			   1U,
+			   workers);
+
+			auto scores = std::move(partial.front());
+			for (auto worker = std::size_t{1}; worker < workers; ++worker) {
+				std::transform(scores.cbegin(),
+				               scores.cend(),
+				               partial[worker].cbegin(),
+				               scores.begin(),
+				               std::plus<>{});
+			}
+			return scores;
+		}
+	} // namespace detail
+
+	// Betweenness centrality of every node of `g` by Brandes' algorithm, returned in the same
+	// order as g.nodes(): for each node, the sum over ordered pairs of other nodes of the fraction
+	// of shortest paths between them that pass through it. Multi-edges count once, at their
+	// lightest weight, and self-loops are ignored. Sources are spread across std::thread workers.
+	template<typename N, typename E>
+	auto betweenness_centrality(graph<N, E> const& g, betweenness_options const& options = {})
+	   -> std::vector<double> {
+		auto const adjacency = g.to_csr().lightest_edges();
+		auto const n = adjacency.node_count();
+		if (options.weighted) {
+			if constexpr (std::is_arithmetic_v<E>) {
+				if (std::any_of(adjacency.weights.cbegin(),
+				                adjacency.weights.cend(),
+				                [](E const& weight) { return not(weight > E{0}); }))
+				{
+					throw std::runtime_error("Cannot call gdwg::betweenness_centrality with weighted "
+					                         "lengths unless every weight is positive");
+				}
+			}
+			else {
+				throw std::runtime_error("Cannot call gdwg::betweenness_centrality with weighted "
+				                         "lengths on non-arithmetic weights");
+			}
+		}
+		if (n < 3U) {
+			return std::vector<double>(n, 0.0);
+		}
+
+		auto sources = std::vector<std::size_t>(n);
+		std::iota(sources.begin(), sources.end(), std::size_t{0});
+		auto scale = 1.0;
+		if (options.epsilon > 0.0) {
+			auto const samples = detail::betweenness_samples(n, options.epsilon, options.delta);
+			if (samples < n) {
+				auto engine = std::mt19937{options.seed};
+				for (auto i = std::size_t{0}; i < samples; ++i) {
+					auto pick = std::uniform_int_distribution<std::size_t>{i, n - 1U};
+					std::swap(sources[i], sources[pick(engine)]);
+				}
+				sources.resize(samples);
+				scale = static_cast<double>(n) / static_cast<double>(samples);
+			}
+		}
+
+		auto scores = std::vector<double>{};
+		if constexpr (std::is_arithmetic_v<E>) {
+			if (options.weighted) {
+				scores = detail::accumulate_dependencies<E, true>(adjacency, sources);
+			}
+		}
+		if (not options.weighted) {
+			scores = detail::accumulate_dependencies<std::size_t, false>(adjacency, sources);
+		}
+		if (options.normalised) {
+			scale /= static_cast<double>(n - 1U) * static_cast<double>(n - 2U);
+		}
+		for (auto& score : scores) {
+			score *= scale;
+		}
+		return scores;
+	}
+} // namespace gdwg
+
+#endif // GDWG_BETWEENNESS_HPP
@@ -0,0 +1,257 @@
+#ifndef GDWG_BREADTH_FIRST_SEARCH_HPP
+#define GDWG_BREADTH_FIRST_SEARCH_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Selects the breadth_first_search implementation. `top_down` expands each level from its
+	// frontier. `direction_optimising` also builds the in-edges and switches to searching
+	// upwards from unreached nodes while the frontier is large. `automatic` picks
+	// `direction_optimising` for graphs with many edges and `top_down` otherwise.
+	enum class bfs_algorithm { automatic, top_down, direction_optimising };
+
+	struct breadth_first_tree {
+		static constexpr auto unreached = std::numeric_limits<std::size_t>::max();
+
+		// Hops from the source to each node, or `unreached`.
+		std::vector<std::size_t> distances;
+		// Index (in node order) of the node each node was reached from, or `unreached`. The
+		// source is its own parent.
+		std::vector<std::size_t> parents;
+	};
+
+	namespace detail {
+		// One bit per node. Workers may write different words concurrently.
+		class node_bitmap {
+		public:
+			static constexpr auto bits = std::size_t{64};
+
+			explicit node_bitmap(std::size_t nodes)
+			: words_((nodes + bits - 1U) / bits, 0U) {}
+
+			[[nodiscard]] auto test(std::size_t v) const noexcept -> bool {
+				return ((this->words_[v / bits] >> (v % bits)) & 1U) != 0U;
+			}
+
+			auto set(std::size_t v) noexcept -> void {
+				this->words_[v / bits] |= std::uint64_t{1} << (v % bits);
+			}
+
+			[[nodiscard]] auto word_count() const noexcept -> std::size_t {
+				return this->words_.size();
+			}
+
+			[[nodiscard]] auto word(std::size_t i) const noexcept -> std::uint64_t {
+				return this->words_[i];
+			}
+
+			auto set_word(std::size_t i, std::uint64_t word) noexcept -> void {
+				this->words_[i] = word;
+			}
+
+			auto clear() noexcept -> void {
+				std::fill(this->words_.begin(), this->words_.end(), std::uint64_t{0});
+			}
+
+		private:
+			std::vector<std::uint64_t> words_;
+		};
+
+		// Beamer, Asanović and Patterson's direction-optimising search. A top-down step scans the
+		// out-edges of the frontier and claims unreached nodes with a compare-and-swap on their
+		// parent. A bottom-up step has every unreached node scan its in-edges for a parent in the
+		// frontier, stopping at the first, and keeps the frontier as a bitmap whose words are
+		// split between workers. Searching switches to bottom-up once the frontier's out-edges
+		// outnumber a fraction of the edges still unexplored, and back once the frontier shrinks
+		// to a small fraction of the nodes. Without `in`, every step is top-down.
+		template<typename N, typename E>
+		class direction_optimising_bfs {
+		public:
+			direction_optimising_bfs(csr<N, E> const& out, csr<N, E> const* in)
+			: out_(out)
+			, in_(in)
+			, parents_(out.node_count())
+			, current_(out.node_count())
+			, next_(out.node_count()) {}
+
+			auto run(std::size_t source) -> breadth_first_tree {
+				auto const n = this->out_.node_count();
+				this->distances_.assign(n, breadth_first_tree::unreached);
+				for (auto& parent : this->parents_) {
+					parent.store(breadth_first_tree::unreached, std::memory_order_relaxed);
+				}
+				this->parents_[source].store(source, std::memory_order_relaxed);
+				this->distances_[source] = 0U;
+
+				auto queue = std::vector<std::size_t>{source};
+				auto unexplored_edges = this->out_.edge_count();
+				auto frontier_edges = this->out_.degree(source);
+				auto depth = std::size_t{0};
+				while (not queue.empty()) {
+					if (this->in_ != nullptr and frontier_edges > unexplored_edges / alpha) {
+						this->current_.clear();
+						for (auto const v : queue) {
+							this->current_.set(v);
+						}
+						auto awake = queue.size();
+						auto previous = awake;
+						do {
+							previous = awake;
+							awake = this->bottom_up_step(++depth);
+							std::swap(this->current_, this->next_);
+						} while (awake >= previous or awake > n / beta);
+						queue = this->bitmap_to_queue();
+						frontier_edges = 1U;
+					}
+					else {
+						unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+						frontier_edges = this->top_down_step(queue, ++depth);
+					}
+				}
+
+				auto tree = breadth_first_tree{};
+				tree.distances = std::move(this->distances_);
+				tree.parents.resize(n);
+				for (auto v = std::size_t{0}; v < n; ++v) {
+					tree.parents[v] = this->parents_[v].load(std::memory_order_relaxed);
+				}
+				return tree;
+			}
+
+		private:
+			static constexpr auto alpha = std::size_t{15};
+			static constexpr auto beta = std::size_t{18};
+
+			csr<N, E> const& out_;
+			csr<N, E> const* in_;
+			std::vector<std::atomic<std::size_t>> parents_;
+			std::vector<std::size_t> distances_;
+			node_bitmap current_;
+			node_bitmap next_;
+
+			// Replaces `queue` with the nodes it reaches first and returns their out-degree total.
+			auto top_down_step(std::vector<std::size_t>& queue, std::size_t depth) -> std::size_t {
+				constexpr auto grain = std::size_t{256};
+				auto const workers = worker_count(queue.size(), grain);
+				auto found = std::vector<std::vector<std::size_t>>(workers);
+				auto edges = std::vector<std::size_t>(workers, 0U);
+				parallel_chunks(
+				   0U,
+				   queue.size(),
+				   [&](std::size_t first, std::size_t last, std::size_t worker) {
+					   for (auto i = first; i < last; ++i) {
+						   auto const u = queue[i];
+						   for (auto const v : this->out_.neighbours(u)) {
+							   auto expected = breadth_first_tree::unreached;
+							   if (this->parents_[v].load(std::memory_order_relaxed) == expected
+							       and this->parents_[v].compare_exchange_strong(
+							          expected, u, std::memory_order_relaxed))
+							   {
+								   this->distances_[v] = depth;
+								   found[worker].push_back(v);
+								   edges[worker] += this->out_.degree(v);
+							   }
+						   }
+					   }
+				   },
+				   grain);
+				queue.clear();
+				for (auto const& part : found) {
+					queue.insert(queue.end(), part.cbegin(), part.cend());
+				}
+				return std::accumulate(edges.cbegin(), edges.cend(), std::size_t{0});
+			}
+
+			// Fills `next_` with the unreached nodes that have an in-neighbour in `current_` and
+			// returns how many there are. Each worker owns whole words, so no bit is shared.
+			auto bottom_up_step(std::size_t depth) -> std::size_t {
+				constexpr auto grain = std::size_t{64};
+				auto const n = this->out_.node_count();
+				auto const words = this->current_.word_count();
+				auto awake = std::vector<std::size_t>(worker_count(words, grain), 0U);
+				parallel_chunks(
+				   0U,
+				   words,
+				   [&](std::size_t first, std::size_t last, std::size_t worker) {
+					   auto count = std::size_t{0};
+					   for (auto w = first; w < last; ++w) {
+						   auto word = std::uint64_t{0};
+						   auto const end = std::min(n, (w + 1U) * node_bitmap::bits);
+						   for (auto v = w * node_bitmap::bits; v < end; ++v) {
+							   if (this->distances_[v] != breadth_first_tree::unreached) {
+								   continue;
+							   }
+							   for (auto const u : this->in_->neighbours(v)) {
+								   if (this->current_.test(u)) {
+									   this->parents_[v].store(u, std::memory_order_relaxed);
+									   this->distances_[v] = depth;
+									   word |= std::uint64_t{1} << (v % node_bitmap::bits);
+									   ++count;
+									   break;
+								   }
+							   }
+						   }
+						   this->next_.set_word(w, word);
+					   }
+					   awake[worker] = count;
+				   },
+				   grain);
+				return std::accumulate(awake.cbegin(), awake.cend(), std::size_t{0});
+			}
+
+			[[nodiscard]] auto bitmap_to_queue() const -> std::vector<std::size_t> {
+				auto queue = std::vector<std::size_t>{};
+				for (auto w = std::size_t{0}; w < this->current_.word_count(); ++w) {
+					for (auto word = this->current_.word(w); word != 0U; word &= word - 1U) {
+						auto const bit = static_cast<std::size_t>(std::countr_zero(word));
+						queue.push_back(w * node_bitmap::bits + bit);
+					}
+				}
+				return queue;
+			}
+		};
+	} // namespace detail
+
+	// Breadth-first search from `source`, giving the hop distance and a parent for every node in
+	// the same order as g.nodes(). Distances are exact; which of several parents at the same
+	// depth a node gets depends on scheduling, since each level is spread across std::thread
+	// workers.
+	template<typename N, typename E>
+	auto breadth_first_search(graph<N, E> const& g,
+	                          N const& source,
+	                          bfs_algorithm algorithm = bfs_algorithm::automatic)
+	   -> breadth_first_tree {
+		constexpr auto direction_threshold = std::size_t{1} << 16U;
+		if (not g.is_node(source)) {
+			throw std::runtime_error("Cannot call gdwg::breadth_first_search if source node doesn't "
+			                         "exist in the graph");
+		}
+		auto const adjacency = g.to_csr();
+		if (algorithm == bfs_algorithm::automatic) {
+			algorithm = adjacency.edge_count() < direction_threshold
+			               ? bfs_algorithm::top_down
+			               : bfs_algorithm::direction_optimising;
+		}
+		auto const s = adjacency.index_of(source);
+		if (algorithm == bfs_algorithm::top_down) {
+			return detail::direction_optimising_bfs<N, E>(adjacency, nullptr).run(s);
+		}
+		auto const reverse = adjacency.transpose();
+		return detail::direction_optimising_bfs<N, E>(adjacency, &reverse).run(s);
+	}
+} // namespace gdwg
+
+#endif // GDWG_BREADTH_FIRST_SEARCH_HPP
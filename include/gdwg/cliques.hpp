@@ -0,0 +1,366 @@
+#ifndef GDWG_CLIQUES_HPP
+#define GDWG_CLIQUES_HPP
+
+#include "gdwg/detail/undirected.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+#include "gdwg/triangles.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	namespace detail {
+		// Nodes in a degeneracy order, found by repeatedly removing a node of smallest remaining
+		// degree. Each node then has at most d neighbours later in the order, where d is the
+		// degeneracy of the graph. Nodes are bucketed by degree as in Batagelj and Zaversnik's
+		// peeling, so this takes linear time.
+		inline auto degeneracy_order(undirected_adjacency const& g) -> std::vector<std::size_t> {
+			auto const n = g.node_count();
+			auto degrees = std::vector<std::size_t>(n);
+			auto max_degree = std::size_t{0};
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				degrees[u] = g.degree(u);
+				max_degree = std::max(max_degree, degrees[u]);
+			}
+			auto bucket_start = std::vector<std::size_t>(max_degree + 2U, 0U);
+			for (auto const d : degrees) {
+				++bucket_start[d + 1U];
+			}
+			std::partial_sum(bucket_start.cbegin(), bucket_start.cend(), bucket_start.begin());
+
+			auto order = std::vector<std::size_t>(n);
+			auto position = std::vector<std::size_t>(n);
+			auto cursor = bucket_start;
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				position[u] = cursor[degrees[u]]++;
+				order[position[u]] = u;
+			}
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				auto const v = order[i];
+				for (auto const u : g.neighbours(v)) {
+					if (degrees[u] <= degrees[v]) {
+						continue;
+					}
+					auto const front = bucket_start[degrees[u]];
+					auto const w = order[front];
+					std::swap(order[front], order[position[u]]);
+					std::swap(position[u], position[w]);
+					++bucket_start[degrees[u]];
+					--degrees[u];
+				}
+			}
+			return order;
+		}
+
+		constexpr auto word_bits = std::size_t{64};
+
+		inline auto word_count(std::size_t bits) noexcept -> std::size_t {
+			return (bits + word_bits - 1U) / word_bits;
+		}
+
+		inline auto set_bit(std::uint64_t* words, std::size_t i) noexcept -> void {
+			words[i / word_bits] |= std::uint64_t{1} << (i % word_bits);
+		}
+
+		inline auto clear_bit(std::uint64_t* words, std::size_t i) noexcept -> void {
+			words[i / word_bits] &= ~(std::uint64_t{1} << (i % word_bits));
+		}
+
+		inline auto none_set(std::uint64_t const* words, std::size_t size) noexcept -> bool {
+			auto any = std::uint64_t{0};
+			for (auto i = std::size_t{0}; i < size; ++i) {
+				any |= words[i];
+			}
+			return any == 0U;
+		}
+
+		inline auto count_common_bits(std::uint64_t const* a,
+		                              std::uint64_t const* b,
+		                              std::size_t size) noexcept -> std::size_t {
+			auto count = std::size_t{0};
+			for (auto i = std::size_t{0}; i < size; ++i) {
+				count += static_cast<std::size_t>(std::popcount(a[i] & b[i]));
+			}
+			return count;
+		}
+
+		// Calls `f(i)` for every bit i set in `words`, in increasing order.
+		template<typename F>
+		auto for_each_bit(std::uint64_t const* words, std::size_t size, F const& f) -> void {
+			for (auto i = std::size_t{0}; i < size; ++i) {
+				for (auto word = words[i]; word != 0U; word &= word - 1U) {
+					f(i * word_bits + static_cast<std::size_t>(std::countr_zero(word)));
+				}
+			}
+		}
+
+		// Bron and Kerbosch's search with Tomita's pivot, run by Eppstein, Löffler and Strash's
+		// outer loop: each node v in degeneracy order starts a search whose candidates are its
+		// later neighbours and whose excluded set is its earlier ones. Each of these subproblems
+		// has at most d candidates, and its adjacency is packed into rows of 64-bit words, so that
+		// intersections and pivot counts are straight loops over words.
+		//
+		// Candidates take columns [0, kp) and excluded nodes columns [kp, kp + kx). The row of a
+		// candidate covers both ranges, while the row of an excluded node only covers the
+		// candidates, since that is all the pivot choice needs. Candidate sets fit in the first
+		// `pwords_` words of a row and excluded sets in `words_`.
+		template<typename Report>
+		class clique_search {
+		public:
+			clique_search(undirected_adjacency const& g,
+			              std::vector<std::size_t> const& rank,
+			              Report const& report)
+			: g_(&g)
+			, rank_(&rank)
+			, report_(&report)
+			, column_(g.node_count(), none) {}
+
+			// Reports every maximal clique whose earliest node in degeneracy order is `v`. Returns
+			// false if the report asked to stop.
+			auto run(std::size_t v) -> bool {
+				this->build(v);
+				this->clique_.assign(1U, v);
+				if (this->members_.empty()) {
+					return this->g_->degree(v) != 0U or (*this->report_)(this->clique_);
+				}
+				auto* const candidates = this->level(0U);
+				auto* const excluded = candidates + this->pwords_;
+				std::fill(candidates, candidates + this->pwords_ + this->words_, std::uint64_t{0});
+				for (auto i = std::size_t{0}; i < this->kp_ + this->kx_; ++i) {
+					set_bit(i < this->kp_ ? candidates : excluded, i);
+				}
+				return this->expand(0U);
+			}
+
+		private:
+			static constexpr auto none = std::numeric_limits<std::size_t>::max();
+
+			undirected_adjacency const* g_;
+			std::vector<std::size_t> const* rank_;
+			Report const* report_;
+			// Column of each node in the current subproblem, or `none`.
+			std::vector<std::size_t> column_;
+			// The node behind each column.
+			std::vector<std::size_t> members_;
+			std::vector<std::pair<std::size_t, std::size_t>> links_;
+			std::vector<std::uint64_t> candidate_rows_;
+			std::vector<std::uint64_t> excluded_rows_;
+			// Candidate, excluded and branching sets for each depth of the search.
+			std::vector<std::uint64_t> levels_;
+			std::vector<std::size_t> clique_;
+			std::vector<std::size_t> sorted_;
+			std::size_t kp_{0};
+			std::size_t kx_{0};
+			std::size_t pwords_{0};
+			std::size_t words_{0};
+
+			auto build(std::size_t v) -> void {
+				auto const& g = *this->g_;
+				auto const& rank = *this->rank_;
+				auto const row = g.neighbours(v);
+				this->members_.clear();
+				for (auto const w : row) {
+					if (rank[w] > rank[v]) {
+						this->column_[w] = this->members_.size();
+						this->members_.push_back(w);
+					}
+				}
+				this->kp_ = this->members_.size();
+
+				// An earlier neighbour only matters if it is adjacent to some candidate, since
+				// every clique found here holds at least one candidate.
+				this->links_.clear();
+				for (auto i = std::size_t{0}; i < this->kp_; ++i) {
+					for_each_common(row, g.neighbours(this->members_[i]), [&](std::size_t y) {
+						if (this->column_[y] == none) {
+							this->column_[y] = this->members_.size();
+							this->members_.push_back(y);
+						}
+						this->links_.emplace_back(i, this->column_[y]);
+					});
+				}
+				this->kx_ = this->members_.size() - this->kp_;
+				this->pwords_ = word_count(this->kp_);
+				this->words_ = word_count(this->kp_ + this->kx_);
+				this->candidate_rows_.assign(this->kp_ * this->words_, 0U);
+				this->excluded_rows_.assign(this->kx_ * this->pwords_, 0U);
+				for (auto const& [i, j] : this->links_) {
+					set_bit(this->candidate_rows_.data() + i * this->words_, j);
+					if (j >= this->kp_) {
+						set_bit(this->excluded_rows_.data() + (j - this->kp_) * this->pwords_, i);
+					}
+				}
+				for (auto const w : this->members_) {
+					this->column_[w] = none;
+				}
+				auto const depth = this->kp_ + 1U;
+				auto const size = depth * (2U * this->pwords_ + this->words_);
+				if (this->levels_.size() < size) {
+					this->levels_.resize(size);
+				}
+			}
+
+			auto level(std::size_t depth) noexcept -> std::uint64_t* {
+				return this->levels_.data() + depth * (2U * this->pwords_ + this->words_);
+			}
+
+			// The candidates adjacent to the node in column `u`.
+			auto candidate_neighbours(std::size_t u) const noexcept -> std::uint64_t const* {
+				return u < this->kp_ ? this->candidate_rows_.data() + u * this->words_
+				                     : this->excluded_rows_.data() + (u - this->kp_) * this->pwords_;
+			}
+
+			auto expand(std::size_t depth) -> bool {
+				auto* const candidates = this->level(depth);
+				auto* const excluded = candidates + this->pwords_;
+				auto* const branches = excluded + this->words_;
+				if (none_set(candidates, this->pwords_)) {
+					return not none_set(excluded, this->words_) or this->report();
+				}
+
+				// Tomita's pivot: the node of either set with the most candidates as neighbours.
+				// Only candidates outside its neighbourhood need a branch of their own.
+				auto const size = count_common_bits(candidates, candidates, this->pwords_);
+				auto pivot = none;
+				auto best = std::size_t{0};
+				auto const consider = [&](std::size_t u) {
+					if (best == size and pivot != none) {
+						return;
+					}
+					auto const count =
+					   count_common_bits(candidates, this->candidate_neighbours(u), this->pwords_);
+					if (pivot == none or count > best) {
+						pivot = u;
+						best = count;
+					}
+				};
+				for_each_bit(candidates, this->pwords_, consider);
+				for_each_bit(excluded, this->words_, consider);
+				auto const* const pivot_row = this->candidate_neighbours(pivot);
+				for (auto i = std::size_t{0}; i < this->pwords_; ++i) {
+					branches[i] = candidates[i] & ~pivot_row[i];
+				}
+
+				auto* const next_candidates = this->level(depth + 1U);
+				auto* const next_excluded = next_candidates + this->pwords_;
+				auto keep_going = true;
+				for_each_bit(branches, this->pwords_, [&](std::size_t u) {
+					if (not keep_going) {
+						return;
+					}
+					auto const* const row = this->candidate_rows_.data() + u * this->words_;
+					for (auto i = std::size_t{0}; i < this->pwords_; ++i) {
+						next_candidates[i] = candidates[i] & row[i];
+					}
+					for (auto i = std::size_t{0}; i < this->words_; ++i) {
+						next_excluded[i] = excluded[i] & row[i];
+					}
+					this->clique_.push_back(this->members_[u]);
+					keep_going = this->expand(depth + 1U);
+					this->clique_.pop_back();
+					clear_bit(candidates, u);
+					set_bit(excluded, u);
+				});
+				return keep_going;
+			}
+
+			auto report() -> bool {
+				this->sorted_ = this->clique_;
+				std::sort(this->sorted_.begin(), this->sorted_.end());
+				return (*this->report_)(this->sorted_);
+			}
+		};
+	} // namespace detail
+
+	// Finds every maximal clique of the undirected view of `g` and reports each one to
+	// `callback` as a std::vector<N> of its nodes in the same order as g.nodes(). Returns the
+	// number of cliques reported. Directions, multi-edges and self-loops are ignored, and a node
+	// with no neighbours is a clique of its own.
+	//
+	// Each node starts a Bron-Kerbosch search with pivoting over its neighbours that come later
+	// in degeneracy order, so no search has more candidates than the degeneracy of the graph.
+	// The adjacency of each search is packed into 64-bit words. The searches are split between
+	// std::thread workers, in no fixed order. Calls to `callback` are serialised, and if it
+	// returns bool, returning false stops the search.
+	template<typename N, typename E, typename Callback>
+	auto maximal_cliques(graph<N, E> const& g, Callback callback) -> std::size_t {
+		constexpr auto batch = std::size_t{16};
+		auto const snapshot = g.to_csr();
+		auto const undirected = detail::make_undirected(snapshot);
+		auto const n = undirected.node_count();
+		auto const order = detail::degeneracy_order(undirected);
+		auto rank = std::vector<std::size_t>(n);
+		for (auto i = std::size_t{0}; i < n; ++i) {
+			rank[order[i]] = i;
+		}
+
+		auto lock = std::mutex{};
+		auto reported = std::size_t{0};
+		auto stopped = std::atomic<bool>{false};
+		auto clique = std::vector<N>{};
+		auto const report = [&](std::vector<std::size_t> const& members) -> bool {
+			auto const guard = std::lock_guard{lock};
+			if (stopped.load(std::memory_order_relaxed)) {
+				return false;
+			}
+			clique.clear();
+			for (auto const u : members) {
+				clique.push_back(snapshot.nodes[u]);
+			}
+			++reported;
+			using result = std::invoke_result_t<Callback&, std::vector<N> const&>;
+			if constexpr (std::is_same_v<result, bool>) {
+				if (not std::invoke(callback, std::as_const(clique))) {
+					stopped.store(true, std::memory_order_relaxed);
+					return false;
+				}
+			}
+			else {
+				std::invoke(callback, std::as_const(clique));
+			}
+			return true;
+		};
+
+		using search_type = detail::clique_search<decltype(report)>;
+		auto const workers = detail::worker_count(n, batch);
+		auto searches = std::vector<search_type>{};
+		searches.reserve(workers);
+		for (auto worker = std::size_t{0}; worker < workers; ++worker) {
+			searches.emplace_back(undirected, rank, report);
+		}
+		detail::parallel_for_dynamic(
+		   0U,
+		   n,
+		   [&](std::size_t v, std::size_t worker) {
+			   if (not stopped.load(std::memory_order_relaxed) and not searches[worker].run(v)) {
+				   stopped.store(true, std::memory_order_relaxed);
+			   }
+		   },
+		   batch,
+		   workers);
+		return reported;
+	}
+
+	// Every maximal clique of the undirected view of `g`, each in the same order as g.nodes(),
+	// and sorted.
+	template<typename N, typename E>
+	auto maximal_cliques(graph<N, E> const& g) -> std::vector<std::vector<N>> {
+		auto result = std::vector<std::vector<N>>{};
+		maximal_cliques(g, [&result](std::vector<N> const& clique) { result.push_back(clique); });
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_CLIQUES_HPP
@@ -0,0 +1,264 @@
+#ifndef GDWG_COLOURING_HPP
+#define GDWG_COLOURING_HPP
+
+#include "gdwg/detail/undirected.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Selects the colouring implementation. `largest_first` colours nodes one at a time in order
+	// of decreasing degree. `jones_plassmann` colours, in parallel rounds, every node whose
+	// higher-priority neighbours are all coloured. `speculative` colours all nodes in parallel at
+	// once, then recolours one endpoint of each clash until none are left. `automatic` picks
+	// `largest_first` for small graphs or when only one thread is available, and `speculative`
+	// otherwise.
+	enum class colouring_algorithm { automatic, largest_first, jones_plassmann, speculative };
+
+	namespace detail {
+		inline constexpr auto no_colour = std::numeric_limits<std::size_t>::max();
+
+		inline auto max_degree(undirected_adjacency const& g) -> std::size_t {
+			auto result = std::size_t{0};
+			for (auto u = std::size_t{0}; u < g.node_count(); ++u) {
+				result = std::max(result, g.degree(u));
+			}
+			return result;
+		}
+
+		// Nodes in order of decreasing degree, by counting sort. Ties keep node order.
+		inline auto largest_first_order(undirected_adjacency const& g) -> std::vector<std::size_t> {
+			auto const n = g.node_count();
+			auto const top = max_degree(g);
+			auto starts = std::vector<std::size_t>(top + 2U, 0U);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				++starts[top - g.degree(u) + 1U];
+			}
+			for (auto d = std::size_t{1}; d < starts.size(); ++d) {
+				starts[d] += starts[d - 1U];
+			}
+			auto order = std::vector<std::size_t>(n);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				order[starts[top - g.degree(u)]++] = u;
+			}
+			return order;
+		}
+
+		// Finds the smallest colour that no neighbour of a node holds. Colours are marked with a
+		// fresh stamp for each node, so the marks never need clearing. A node of degree d always
+		// gets a colour of at most d.
+		class colour_picker {
+		public:
+			explicit colour_picker(std::size_t max_degree)
+			: marks_(max_degree + 1U, 0U) {}
+
+			template<typename Colour>
+			auto pick(std::span<std::size_t const> neighbours, Colour const& colour_of)
+			   -> std::size_t {
+				++this->stamp_;
+				for (auto const v : neighbours) {
+					auto const c = colour_of(v);
+					if (c < this->marks_.size()) {
+						this->marks_[c] = this->stamp_;
+					}
+				}
+				auto c = std::size_t{0};
+				while (this->marks_[c] == this->stamp_) {
+					++c;
+				}
+				return c;
+			}
+
+		private:
+			std::vector<std::uint64_t> marks_;
+			std::uint64_t stamp_{0};
+		};
+
+		inline auto largest_first_colouring(undirected_adjacency const& g)
+		   -> std::vector<std::size_t> {
+			auto colours = std::vector<std::size_t>(g.node_count(), no_colour);
+			auto picker = colour_picker(max_degree(g));
+			for (auto const u : largest_first_order(g)) {
+				colours[u] = picker.pick(g.neighbours(u), [&](std::size_t v) { return colours[v]; });
+			}
+			return colours;
+		}
+
+		// A fixed pseudo-random shuffle of node ids, to break ties between equal degrees without
+		// favouring any part of the graph.
+		inline auto scramble(std::size_t u) noexcept -> std::uint64_t {
+			auto z = static_cast<std::uint64_t>(u) + 0x9e3779b97f4a7c15U;
+			z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9U;
+			z = (z ^ (z >> 27U)) * 0x94d049bb133111ebU;
+			return z ^ (z >> 31U);
+		}
+
+		// Jones and Plassmann's colouring, with priorities by degree and then by a scrambled id.
+		// Each node counts its uncoloured higher-priority neighbours. Every round colours the
+		// nodes whose count has reached zero, which are pairwise non-adjacent, and counts down
+		// their lower-priority neighbours to find the next round.
+		inline auto jones_plassmann_colouring(undirected_adjacency const& g)
+		   -> std::vector<std::size_t> {
+			constexpr auto grain = std::size_t{256};
+			auto const n = g.node_count();
+			auto keys = std::vector<std::uint64_t>(n);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				keys[u] = scramble(u);
+			}
+			auto const higher = [&g, &keys](std::size_t u, std::size_t v) {
+				return std::pair(g.degree(u), keys[u]) > std::pair(g.degree(v), keys[v]);
+			};
+			auto waiting = std::vector<std::atomic<std::size_t>>(n);
+			auto found = std::vector<std::vector<std::size_t>>(worker_count(n, grain));
+			parallel_chunks(
+			   0U,
+			   n,
+			   [&](std::size_t first, std::size_t last, std::size_t worker) {
+				   for (auto u = first; u < last; ++u) {
+					   auto const neighbours = g.neighbours(u);
+					   auto const count = static_cast<std::size_t>(
+					      std::count_if(neighbours.begin(), neighbours.end(), [&](std::size_t v) {
+						      return higher(v, u);
+					      }));
+					   waiting[u].store(count, std::memory_order_relaxed);
+					   if (count == 0U) {
+						   found[worker].push_back(u);
+					   }
+				   }
+			   },
+			   grain);
+
+			auto colours = std::vector<std::size_t>(n, no_colour);
+			auto const limit = max_degree(g);
+			auto pickers = std::vector<colour_picker>(max_threads(), colour_picker(limit));
+			auto frontier = std::vector<std::size_t>{};
+			while (true) {
+				frontier.clear();
+				for (auto& part : found) {
+					frontier.insert(frontier.end(), part.cbegin(), part.cend());
+					part.clear();
+				}
+				if (frontier.empty()) {
+					return colours;
+				}
+				found.resize(std::max(found.size(), worker_count(frontier.size(), grain)));
+				// Lower-priority neighbours are only coloured in later rounds, so every colour read
+				// here was written before the round began.
+				parallel_chunks(
+				   0U,
+				   frontier.size(),
+				   [&](std::size_t first, std::size_t last, std::size_t worker) {
+					   for (auto i = first; i < last; ++i) {
+						   auto const u = frontier[i];
+						   colours[u] = pickers[worker].pick(g.neighbours(u), [&](std::size_t v) {
+							   return higher(v, u) ? colours[v] : no_colour;
+						   });
+						   for (auto const v : g.neighbours(u)) {
+							   if (higher(u, v)
+							       and waiting[v].fetch_sub(1U, std::memory_order_relaxed) == 1U)
+							   {
+								   found[worker].push_back(v);
+							   }
+						   }
+					   }
+				   },
+				   grain);
+			}
+		}
+
+		// Speculative greedy colouring after Gebremedhin and Manne. All pending nodes pick a
+		// colour at once, in largest-first order, reading whatever their neighbours hold at the
+		// time. Two adjacent nodes that picked the same colour in the same round are then a
+		// clash, and the one with the larger id goes back into the pending list.
+		inline auto speculative_colouring(undirected_adjacency const& g) -> std::vector<std::size_t> {
+			constexpr auto batch = std::size_t{64};
+			auto const n = g.node_count();
+			auto colours = std::vector<std::atomic<std::size_t>>(n);
+			for (auto& colour : colours) {
+				colour.store(no_colour, std::memory_order_relaxed);
+			}
+			auto const limit = max_degree(g);
+			auto pickers = std::vector<colour_picker>(max_threads(), colour_picker(limit));
+			auto const colour_of = [&colours](std::size_t v) {
+				return colours[v].load(std::memory_order_relaxed);
+			};
+			auto pending = largest_first_order(g);
+			auto clashes = std::vector<std::vector<std::size_t>>{};
+			while (not pending.empty()) {
+				parallel_for_dynamic(
+				   0U,
+				   pending.size(),
+				   [&](std::size_t i, std::size_t worker) {
+					   auto const u = pending[i];
+					   auto const c = pickers[worker].pick(g.neighbours(u), colour_of);
+					   colours[u].store(c, std::memory_order_relaxed);
+				   },
+				   batch);
+				clashes.assign(worker_count(pending.size(), batch), {});
+				parallel_chunks(
+				   0U,
+				   pending.size(),
+				   [&](std::size_t first, std::size_t last, std::size_t worker) {
+					   for (auto i = first; i < last; ++i) {
+						   auto const u = pending[i];
+						   auto const c = colour_of(u);
+						   auto const neighbours = g.neighbours(u);
+						   // Rows are sorted, so only the neighbours with smaller ids matter.
+						   auto const end = std::lower_bound(neighbours.begin(), neighbours.end(), u);
+						   if (std::any_of(neighbours.begin(), end, [&](std::size_t v) {
+							       return colour_of(v) == c;
+						       }))
+						   {
+							   clashes[worker].push_back(u);
+						   }
+					   }
+				   },
+				   batch);
+				pending.clear();
+				for (auto const& part : clashes) {
+					pending.insert(pending.end(), part.cbegin(), part.cend());
+				}
+			}
+			auto result = std::vector<std::size_t>(n);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				result[u] = colours[u].load(std::memory_order_relaxed);
+			}
+			return result;
+		}
+	} // namespace detail
+
+	// A colour for every node of the undirected view of `g`, in the same order as g.nodes(), such
+	// that no two neighbours share one. Colours are numbered from 0, and a node with d distinct
+	// neighbours gets a colour of at most d. Directions and multi-edges are ignored, and so are
+	// self-loops, since no colouring could satisfy them. The parallel algorithms spread their
+	// work across std::thread workers.
+	template<typename N, typename E>
+	auto colouring(graph<N, E> const& g,
+	               colouring_algorithm algorithm = colouring_algorithm::automatic)
+	   -> std::vector<std::size_t> {
+		constexpr auto parallel_threshold = std::size_t{1} << 16U;
+		auto const undirected = detail::make_undirected(g.to_csr());
+		if (algorithm == colouring_algorithm::automatic) {
+			algorithm = undirected.targets.size() < parallel_threshold or max_threads() == 1U
+			               ? colouring_algorithm::largest_first
+			               : colouring_algorithm::speculative;
+		}
+		if (algorithm == colouring_algorithm::jones_plassmann) {
+			return detail::jones_plassmann_colouring(undirected);
+		}
+		if (algorithm == colouring_algorithm::speculative) {
+			return detail::speculative_colouring(undirected);
+		}
+		return detail::largest_first_colouring(undirected);
+	}
+} // namespace gdwg
+
+#endif // GDWG_COLOURING_HPP
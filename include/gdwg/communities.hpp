@@ -0,0 +1,479 @@
+#ifndef GDWG_COMMUNITIES_HPP
+#define GDWG_COMMUNITIES_HPP
+
+#include "gdwg/components.hpp"
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Selects how communities are found. `louvain` optimises modularity over several levels and
+	// `label_propagation` is a faster approximation that does not look at modularity at all.
+	enum class community_algorithm { louvain, label_propagation };
+
+	struct community_options {
+		community_algorithm algorithm = community_algorithm::louvain;
+		// Scales the penalty for large communities in modularity; above 1 favours smaller ones.
+		double resolution = 1.0;
+		// Passes over all nodes per Louvain level, or rounds of label propagation.
+		std::size_t max_iterations = 100;
+		// A Louvain level stops once a pass improves modularity by less than this.
+		double tolerance = 1e-7;
+		// Seeds the order in which nodes are visited.
+		std::mt19937::result_type seed = std::mt19937::default_seed;
+	};
+
+	namespace detail {
+		// A symmetric weighted adjacency for modularity, as in the matrix A where A[u][v] is the
+		// total weight between u and v. Rows hold the entries for v != u, sorted by v, and
+		// `loops` holds A[u][u]. `degrees` are the row sums including the loop, and `total` their
+		// sum (twice the total edge weight).
+		struct community_graph {
+			std::vector<std::size_t> offsets;
+			std::vector<std::size_t> targets;
+			std::vector<double> weights;
+			std::vector<double> loops;
+			std::vector<double> degrees;
+			double total = 0.0;
+
+			[[nodiscard]] auto node_count() const noexcept -> std::size_t {
+				return this->loops.size();
+			}
+		};
+
+		// Turns unsorted rows of (target, weight) entries into a community_graph, summing the
+		// entries that share a target. Row u occupies entries [offsets[u], ends[u]).
+		inline auto compact_community_rows(std::vector<std::size_t> const& offsets,
+		                                   std::vector<std::size_t> const& ends,
+		                                   std::vector<std::pair<std::size_t, double>> entries,
+		                                   std::vector<double> loops) -> community_graph {
+			auto const n = loops.size();
+			auto sizes = std::vector<std::size_t>(n + 1U, 0U);
+			parallel_edge_chunks(offsets, [&](std::size_t first, std::size_t last, std::size_t) {
+				for (auto u = first; u < last; ++u) {
+					auto const row = entries.begin() + static_cast<std::ptrdiff_t>(offsets[u]);
+					auto const end = entries.begin() + static_cast<std::ptrdiff_t>(ends[u]);
+					std::sort(row, end);
+					auto out = row;
+					for (auto itr = row; itr != end; ++itr) {
+						if (out != row and std::prev(out)->first == itr->first) {
+							std::prev(out)->second += itr->second;
+						}
+						else {
+							*out++ = *itr;
+						}
+					}
+					sizes[u + 1U] = static_cast<std::size_t>(out - row);
+				}
+			});
+
+			auto result = community_graph{};
+			result.offsets.resize(n + 1U);
+			std::partial_sum(sizes.cbegin(), sizes.cend(), result.offsets.begin());
+			result.targets.resize(result.offsets.back());
+			result.weights.resize(result.offsets.back());
+			result.degrees.assign(n, 0.0);
+			parallel_chunks(0U, n, [&](std::size_t first, std::size_t last, std::size_t) {
+				for (auto u = first; u < last; ++u) {
+					auto degree = loops[u];
+					for (auto i = std::size_t{0}; i < sizes[u + 1U]; ++i) {
+						auto const& [v, w] = entries[offsets[u] + i];
+						result.targets[result.offsets[u] + i] = v;
+						result.weights[result.offsets[u] + i] = w;
+						degree += w;
+					}
+					result.degrees[u] = degree;
+				}
+			});
+			result.total = std::accumulate(result.degrees.cbegin(), result.degrees.cend(), 0.0);
+			result.loops = std::move(loops);
+			return result;
+		}
+
+		// Each edge becomes an undirected entry in both rows, weighing its weight if E is
+		// arithmetic and 1 otherwise. A self-loop adds twice its weight to A[u][u], so that it
+		// counts towards the degree like any other edge.
+		template<typename N, typename E>
+		auto make_community_graph(csr<N, E> const& g) -> community_graph {
+			auto const n = g.node_count();
+			auto const weight = [&g](std::size_t e) {
+				if constexpr (std::is_arithmetic_v<E>) {
+					if (g.weights[e] < E{0}) {
+						throw std::runtime_error("Cannot call gdwg::communities on a graph with a "
+						                         "negative weight");
+					}
+					return static_cast<double>(g.weights[e]);
+				}
+				else {
+					static_cast<void>(e);
+					return 1.0;
+				}
+			};
+
+			auto offsets = std::vector<std::size_t>(n + 1U, 0U);
+			auto loops = std::vector<double>(n, 0.0);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					auto const v = g.targets[e];
+					if (v == u) {
+						loops[u] += 2.0 * weight(e);
+					}
+					else {
+						++offsets[u + 1U];
+						++offsets[v + 1U];
+					}
+				}
+			}
+			std::partial_sum(offsets.cbegin(), offsets.cend(), offsets.begin());
+			auto cursor = std::vector<std::size_t>(offsets.cbegin(), std::prev(offsets.cend()));
+			auto entries = std::vector<std::pair<std::size_t, double>>(offsets.back());
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					auto const v = g.targets[e];
+					if (v != u) {
+						entries[cursor[u]++] = {v, weight(e)};
+						entries[cursor[v]++] = {u, weight(e)};
+					}
+				}
+			}
+			return compact_community_rows(offsets, cursor, std::move(entries), std::move(loops));
+		}
+
+		// Collapses every community of `g` into one node, as merge_replace_node would: edges
+		// inside a community become a self-loop, and the edges between two communities are
+		// redirected onto one edge. Weights that land on the same edge are summed rather than
+		// kept apart, since modularity only needs their total. `communities` must be dense.
+		inline auto coarsen(community_graph const& g,
+		                    std::vector<std::size_t> const& communities,
+		                    std::size_t count) -> community_graph {
+			auto const n = g.node_count();
+			auto member_offsets = std::vector<std::size_t>(count + 1U, 0U);
+			for (auto const c : communities) {
+				++member_offsets[c + 1U];
+			}
+			std::partial_sum(member_offsets.cbegin(), member_offsets.cend(), member_offsets.begin());
+			auto members = std::vector<std::size_t>(n);
+			auto cursor = std::vector<std::size_t>(member_offsets.cbegin(),
+			                                       std::prev(member_offsets.cend()));
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				members[cursor[communities[u]]++] = u;
+			}
+
+			auto offsets = std::vector<std::size_t>(count + 1U, 0U);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				offsets[communities[u] + 1U] += g.offsets[u + 1U] - g.offsets[u];
+			}
+			std::partial_sum(offsets.cbegin(), offsets.cend(), offsets.begin());
+			auto entries = std::vector<std::pair<std::size_t, double>>(offsets.back());
+			auto ends = std::vector<std::size_t>(count);
+			auto loops = std::vector<double>(count, 0.0);
+			parallel_edge_chunks(offsets, [&](std::size_t first, std::size_t last, std::size_t) {
+				for (auto c = first; c < last; ++c) {
+					auto out = offsets[c];
+					auto loop = 0.0;
+					for (auto m = member_offsets[c]; m < member_offsets[c + 1U]; ++m) {
+						auto const u = members[m];
+						loop += g.loops[u];
+						for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+							auto const d = communities[g.targets[e]];
+							if (d == c) {
+								loop += g.weights[e];
+							}
+							else {
+								entries[out++] = {d, g.weights[e]};
+							}
+						}
+					}
+					loops[c] = loop;
+					ends[c] = out;
+				}
+			});
+			return compact_community_rows(offsets, ends, std::move(entries), std::move(loops));
+		}
+
+		// Modularity of a partition of `g`: the fraction of weight inside communities minus what
+		// a random graph with the same degrees would be expected to put there.
+		inline auto partition_modularity(community_graph const& g,
+		                                 std::vector<std::size_t> const& communities,
+		                                 double resolution) -> double {
+			if (g.total <= 0.0) {
+				return 0.0;
+			}
+			auto const n = g.node_count();
+			auto inside = std::vector<double>(n, 0.0);
+			auto totals = std::vector<double>(n, 0.0);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				auto const c = communities[u];
+				totals[c] += g.degrees[u];
+				inside[c] += g.loops[u];
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					if (communities[g.targets[e]] == c) {
+						inside[c] += g.weights[e];
+					}
+				}
+			}
+			auto q = 0.0;
+			for (auto c = std::size_t{0}; c < n; ++c) {
+				auto const share = totals[c] / g.total;
+				q += inside[c] / g.total - resolution * share * share;
+			}
+			return q;
+		}
+
+		// Per-worker scratch for summing the weight from one node to each neighbouring label.
+		class label_weights {
+		public:
+			explicit label_weights(std::size_t labels)
+			: weights_(labels, 0.0) {}
+
+			// Zero weights are dropped, so that a label counts as touched once it has weight.
+			auto add(std::size_t label, double weight) -> void {
+				if (weight <= 0.0) {
+					return;
+				}
+				if (this->weights_[label] == 0.0) {
+					this->touched_.push_back(label);
+				}
+				this->weights_[label] += weight;
+			}
+
+			[[nodiscard]] auto weight(std::size_t label) const noexcept -> double {
+				return this->weights_[label];
+			}
+
+			[[nodiscard]] auto touched() const noexcept -> std::vector<std::size_t> const& {
+				return this->touched_;
+			}
+
+			auto clear() -> void {
+				for (auto const label : this->touched_) {
+					this->weights_[label] = 0.0;
+				}
+				this->touched_.clear();
+			}
+
+		private:
+			std::vector<double> weights_;
+			std::vector<std::size_t> touched_;
+		};
+
+		inline auto shuffled_nodes(std::size_t n, std::mt19937& engine) -> std::vector<std::size_t> {
+			auto order = std::vector<std::size_t>(n);
+			std::iota(order.begin(), order.end(), std::size_t{0});
+			std::shuffle(order.begin(), order.end(), engine);
+			return order;
+		}
+
+		// Louvain's local moving phase: every node in turn joins the neighbouring community that
+		// increases modularity the most. Nodes are handed out to std::thread workers, which read
+		// and update the community of each node and the degree total of each community through
+		// relaxed atomics as they go, so later nodes see earlier moves within the same pass.
+		// Returns a community per node (not dense), or an empty vector if nothing moved.
+		inline auto local_moving(community_graph const& g,
+		                         community_options const& options,
+		                         std::mt19937& engine) -> std::vector<std::size_t> {
+			constexpr auto batch = std::size_t{256};
+			auto const n = g.node_count();
+			auto const order = shuffled_nodes(n, engine);
+			auto community = std::vector<std::atomic<std::size_t>>(n);
+			auto totals = std::vector<std::atomic<double>>(n);
+			auto snapshot = std::vector<std::size_t>(n);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				community[u].store(u, std::memory_order_relaxed);
+				totals[u].store(g.degrees[u], std::memory_order_relaxed);
+				snapshot[u] = u;
+			}
+			auto const workers = worker_count(n, batch);
+			auto scratch = std::vector<label_weights>(workers, label_weights(n));
+
+			auto any_moves = false;
+			auto quality = partition_modularity(g, snapshot, options.resolution);
+			for (auto pass = std::size_t{0}; pass < options.max_iterations; ++pass) {
+				auto moves = std::atomic<std::size_t>{0U};
+				parallel_for_dynamic(
+				   0U,
+				   n,
+				   [&](std::size_t i, std::size_t worker) {
+					   auto const u = order[i];
+					   auto& weights = scratch[worker];
+					   for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+						   weights.add(community[g.targets[e]].load(std::memory_order_relaxed),
+						               g.weights[e]);
+					   }
+					   auto const own = community[u].load(std::memory_order_relaxed);
+					   auto const k = g.degrees[u];
+					   auto const scale = options.resolution * k / g.total;
+					   auto const own_total = totals[own].load(std::memory_order_relaxed) - k;
+					   auto best = own;
+					   auto best_gain = weights.weight(own) - scale * own_total;
+					   for (auto const c : weights.touched()) {
+						   if (c == own) {
+							   continue;
+						   }
+						   auto const gain =
+						      weights.weight(c) - scale * totals[c].load(std::memory_order_relaxed);
+						   if (gain > best_gain) {
+							   best = c;
+							   best_gain = gain;
+						   }
+					   }
+					   weights.clear();
+					   if (best != own) {
+						   totals[own].fetch_sub(k, std::memory_order_relaxed);
+						   totals[best].fetch_add(k, std::memory_order_relaxed);
+						   community[u].store(best, std::memory_order_relaxed);
+						   moves.fetch_add(1U, std::memory_order_relaxed);
+					   }
+				   },
+				   batch,
+				   workers);
+				if (moves.load() == 0U) {
+					break;
+				}
+				any_moves = true;
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					snapshot[u] = community[u].load(std::memory_order_relaxed);
+				}
+				auto const next = partition_modularity(g, snapshot, options.resolution);
+				auto const gain = next - quality;
+				quality = next;
+				if (gain < options.tolerance) {
+					break;
+				}
+			}
+			if (not any_moves) {
+				return {};
+			}
+			return snapshot;
+		}
+
+		inline auto louvain(community_graph g, community_options const& options)
+		   -> std::vector<std::size_t> {
+			auto engine = std::mt19937{options.seed};
+			auto assignment = std::vector<std::size_t>(g.node_count());
+			std::iota(assignment.begin(), assignment.end(), std::size_t{0});
+			while (true) {
+				auto moved = local_moving(g, options, engine);
+				if (moved.empty()) {
+					return assignment;
+				}
+				auto const dense = relabel_by_first_node(std::move(moved));
+				auto const count = 1U + *std::max_element(dense.cbegin(), dense.cend());
+				for (auto& c : assignment) {
+					c = dense[c];
+				}
+				if (count == g.node_count()) {
+					return assignment;
+				}
+				g = coarsen(g, dense, count);
+			}
+		}
+
+		// Asynchronous label propagation: every node in turn takes the label carrying the most
+		// weight among its neighbours, keeping its own label on a tie and otherwise preferring
+		// the smallest. Labels are read and written in place through relaxed atomics.
+		inline auto label_propagation(community_graph const& g, community_options const& options)
+		   -> std::vector<std::size_t> {
+			constexpr auto batch = std::size_t{256};
+			auto const n = g.node_count();
+			auto engine = std::mt19937{options.seed};
+			auto const order = shuffled_nodes(n, engine);
+			auto labels = std::vector<std::atomic<std::size_t>>(n);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				labels[u].store(u, std::memory_order_relaxed);
+			}
+			auto const workers = worker_count(n, batch);
+			auto scratch = std::vector<label_weights>(workers, label_weights(n));
+
+			for (auto round = std::size_t{0}; round < options.max_iterations; ++round) {
+				auto changes = std::atomic<std::size_t>{0U};
+				parallel_for_dynamic(
+				   0U,
+				   n,
+				   [&](std::size_t i, std::size_t worker) {
+					   auto const u = order[i];
+					   auto& weights = scratch[worker];
+					   for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+						   weights.add(labels[g.targets[e]].load(std::memory_order_relaxed),
+						               g.weights[e]);
+					   }
+					   auto const own = labels[u].load(std::memory_order_relaxed);
+					   auto best = own;
+					   auto best_weight = weights.weight(own);
+					   for (auto const label : weights.touched()) {
+						   auto const weight = weights.weight(label);
+						   if (weight > best_weight
+						       or (weight == best_weight and best != own and label < best))
+						   {
+							   best = label;
+							   best_weight = weight;
+						   }
+					   }
+					   weights.clear();
+					   if (best != own) {
+						   labels[u].store(best, std::memory_order_relaxed);
+						   changes.fetch_add(1U, std::memory_order_relaxed);
+					   }
+				   },
+				   batch,
+				   workers);
+				if (changes.load() == 0U) {
+					break;
+				}
+			}
+
+			auto result = std::vector<std::size_t>(n);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				result[u] = labels[u].load(std::memory_order_relaxed);
+			}
+			return result;
+		}
+	} // namespace detail
+
+	// Partitions the nodes of `g` into communities and returns a community id for every node, in
+	// the same order as g.nodes(), numbered densely in order of each community's first node.
+	// Edges are treated as undirected and weigh their weight if E is arithmetic (which must then
+	// be non-negative) or 1 otherwise; multi-edges add up. With more than one thread the result
+	// depends on scheduling, since nodes see each other's moves as they happen.
+	template<typename N, typename E>
+	auto communities(graph<N, E> const& g, community_options const& options = {})
+	   -> std::vector<std::size_t> {
+		auto adjacency = detail::make_community_graph(g.to_csr());
+		if (options.algorithm == community_algorithm::label_propagation) {
+			return detail::relabel_by_first_node(detail::label_propagation(adjacency, options));
+		}
+		return detail::relabel_by_first_node(detail::louvain(std::move(adjacency), options));
+	}
+
+	// Modularity of the partition given by `communities` (one id below g.nodes().size() per node),
+	// weighing edges as communities does.
+	template<typename N, typename E>
+	auto modularity(graph<N, E> const& g,
+	                std::vector<std::size_t> const& communities,
+	                double resolution = 1.0) -> double {
+		auto const adjacency = detail::make_community_graph(g.to_csr());
+		auto const n = adjacency.node_count();
+		if (communities.size() != n
+		    or std::any_of(communities.cbegin(), communities.cend(), [n](std::size_t c) {
+			       return c >= n;
+		       }))
+		{
+			throw std::runtime_error("Cannot call gdwg::modularity without exactly one community "
+			                         "id below the node count per node");
+		}
+		return detail::partition_modularity(adjacency, communities, resolution);
+	}
+} // namespace gdwg
+
+#endif // GDWG_COMMUNITIES_HPP
@@ -0,0 +1,426 @@
+#ifndef GDWG_COMPONENTS_HPP
+#define GDWG_COMPONENTS_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	namespace detail {
+		// Union-find that any number of threads may use at once. Roots are only ever linked below
+		// a root with a smaller index, so the parent relation cannot form a cycle and the root of a
+		// set is always its smallest member. Finds halve the path they walk with a CAS, which may
+		// fail harmlessly when another thread got there first.
+		class concurrent_union_find {
+		public:
+			explicit concurrent_union_find(std::size_t size)
+			: parent_(size) {
+				for (auto i = std::size_t{0}; i < size; ++i) {
+					this->parent_[i].store(i, std::memory_order_relaxed);
+				}
+			}
+
+			auto find(std::size_t x) noexcept -> std::size_t {
+				while (true) {
+					auto p = this->parent_[x].load(std::memory_order_relaxed);
+					if (p == x) {
+						return x;
+					}
+					auto const grandparent = this->parent_[p].load(std::memory_order_relaxed);
+					if (p == grandparent) {
+						return p;
+					}
+					this->parent_[x].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+					x = grandparent;
+				}
+			}
+
+			// Merges the sets of a and b. Returns false if they were already the same set, so of
+			// several threads uniting the same pair exactly one sees true.
+			auto unite(std::size_t a, std::size_t b) noexcept -> bool {
+				while (true) {
+					a = this->find(a);
+					b = this->find(b);
+					if (a == b) {
+						return false;
+					}
+					if (a < b) {
+						std::swap(a, b);
+					}
+					// a is the larger root; it stays a root only if nobody linked it meanwhile.
+					auto expected = a;
+					if (this->parent_[a].compare_exchange_strong(expected,
+					                                             b,
+					                                             std::memory_order_relaxed))
+					{
+						return true;
+					}
+				}
+			}
+
+		private:
+			std::vector<std::atomic<std::size_t>> parent_;
+		};
+
+		inline constexpr auto no_component = std::numeric_limits<std::size_t>::max();
+
+		// Renumbers arbitrary labels in [0, n) densely, in order of each label's first node.
+		inline auto relabel_by_first_node(std::vector<std::size_t> labels)
+		   -> std::vector<std::size_t> {
+			auto ids = std::vector<std::size_t>(labels.size(), no_component);
+			auto count = std::size_t{0};
+			for (auto& label : labels) {
+				if (ids[label] == no_component) {
+					ids[label] = count++;
+				}
+				label = ids[label];
+			}
+			return labels;
+		}
+
+		// Tarjan's algorithm with an explicit stack of (node, next edge) frames in place of
+		// recursion, so arbitrarily long chains cannot overflow the call stack. Labels every node
+		// whose component is still no_component with the id of its component's root node. Nodes
+		// that already have a component count as removed from the graph, which lets the parallel
+		// algorithm hand the rest of its work over.
+		template<typename N, typename E>
+		auto tarjan_components(csr<N, E> const& g, std::vector<std::size_t>& components) -> void {
+			constexpr auto unvisited = std::numeric_limits<std::size_t>::max();
+			auto const n = g.node_count();
+			auto index = std::vector<std::size_t>(n, unvisited);
+			auto low = std::vector<std::size_t>(n);
+			auto open = std::vector<std::size_t>{};
+			auto frames = std::vector<std::pair<std::size_t, std::size_t>>{};
+			auto counter = std::size_t{0};
+
+			auto const visit = [&](std::size_t u) {
+				index[u] = counter;
+				low[u] = counter;
+				++counter;
+				open.push_back(u);
+				frames.emplace_back(u, g.offsets[u]);
+			};
+
+			for (auto root = std::size_t{0}; root < n; ++root) {
+				if (index[root] != unvisited or components[root] != no_component) {
+					continue;
+				}
+				visit(root);
+				while (not frames.empty()) {
+					auto const [u, e] = frames.back();
+					if (e < g.offsets[u + 1U]) {
+						++frames.back().second;
+						auto const v = g.targets[e];
+						if (index[v] == unvisited) {
+							if (components[v] == no_component) {
+								visit(v);
+							}
+						}
+						else if (components[v] == no_component) {
+							// v is still open, so it is on the current path's stack.
+							low[u] = std::min(low[u], index[v]);
+						}
+						continue;
+					}
+
+					frames.pop_back();
+					if (low[u] == index[u]) {
+						auto v = u;
+						do {
+							v = open.back();
+							open.pop_back();
+							components[v] = u;
+						} while (v != u);
+					}
+					if (not frames.empty()) {
+						auto const parent = frames.back().first;
+						low[parent] = std::min(low[parent], low[u]);
+					}
+				}
+			}
+		}
+
+		// Level-synchronous breadth-first search from `start` through the nodes for which
+		// `allowed(v)` holds, marking each node it reaches in `reached`. Each level's frontier is
+		// split across workers, which claim nodes with an atomic exchange.
+		template<typename Allowed>
+		auto parallel_reach(std::vector<std::size_t> const& offsets,
+		                    std::vector<std::size_t> const& targets,
+		                    std::size_t start,
+		                    std::vector<std::atomic<std::uint8_t>>& reached,
+		                    Allowed const& allowed) -> void {
+			constexpr auto grain = std::size_t{256};
+			auto frontier = std::vector<std::size_t>{start};
+			reached[start].store(1U, std::memory_order_relaxed);
+			while (not frontier.empty()) {
+				auto next = std::vector<std::vector<std::size_t>>(worker_count(frontier.size(), grain));
+				auto const expand = [&](std::size_t first, std::size_t last, std::size_t worker) {
+					for (auto i = first; i < last; ++i) {
+						auto const u = frontier[i];
+						for (auto e = offsets[u]; e < offsets[u + 1U]; ++e) {
+							auto const v = targets[e];
+							if (allowed(v) and reached[v].exchange(1U, std::memory_order_relaxed) == 0U) {
+								next[worker].push_back(v);
+							}
+						}
+					}
+				};
+				parallel_chunks(0U, frontier.size(), expand, grain);
+				frontier.clear();
+				for (auto const& part : next) {
+					frontier.insert(frontier.end(), part.cbegin(), part.cend());
+				}
+			}
+		}
+
+		// Multistep parallel SCC detection: trim nodes that trivially form their own component,
+		// peel off the (usually giant) component of a high-degree pivot with a forward-backward
+		// search, then repeatedly colour the rest by propagating the largest node id forwards and
+		// collect each colour's component with a backward search from its root.
+		//
+		// Colouring only pays off while the rest of the graph is large and shallow. A long path
+		// needs a propagation pass per node and then settles one component per round, which would
+		// make the work cubic. So Tarjan's algorithm takes over the remaining nodes once they are
+		// few, once propagation has run `max_passes` passes without settling, or once a round
+		// settles less than 1/`min_progress` of them. Every round therefore costs at most
+		// `max_passes` scans of the graph and shrinks the rest geometrically, which bounds the
+		// total work by a constant number of scans.
+		template<typename N, typename E>
+		auto parallel_components(csr<N, E> const& g) -> std::vector<std::size_t> {
+			constexpr auto sequential_below = std::size_t{1} << 10U;
+			constexpr auto max_passes = 64;
+			constexpr auto min_progress = std::size_t{16};
+			auto const n = g.node_count();
+			auto const reverse = g.transpose();
+			auto components = std::vector<std::size_t>(n, no_component);
+			auto const active = [&components](std::size_t v) { return components[v] == no_component; };
+
+			// Trim: a node without active in- or out-neighbours (ignoring self-loops) is alone.
+			auto const has_active_neighbour = [&](csr<N, E> const& adjacency, std::size_t u) {
+				auto const neighbours = adjacency.neighbours(u);
+				return std::any_of(neighbours.begin(), neighbours.end(), [&](std::size_t v) {
+					return v != u and active(v);
+				});
+			};
+			for (auto round = 0; round < 3; ++round) {
+				auto trimmed = std::vector<std::uint8_t>(n, 0U);
+				parallel_chunks(0U, n, [&](std::size_t first, std::size_t last, std::size_t) {
+					for (auto u = first; u < last; ++u) {
+						trimmed[u] = active(u)
+						                and (not has_active_neighbour(g, u)
+						                     or not has_active_neighbour(reverse, u));
+					}
+				});
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					if (trimmed[u] != 0U) {
+						components[u] = u;
+					}
+				}
+			}
+
+			// Forward-backward search from the active node with the largest in x out degree.
+			auto pivot = no_component;
+			auto best = std::size_t{0};
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				auto const score = (g.degree(u) + 1U) * (reverse.degree(u) + 1U);
+				if (active(u) and (pivot == no_component or score > best)) {
+					pivot = u;
+					best = score;
+				}
+			}
+			if (pivot != no_component) {
+				auto forward = std::vector<std::atomic<std::uint8_t>>(n);
+				auto backward = std::vector<std::atomic<std::uint8_t>>(n);
+				parallel_reach(g.offsets, g.targets, pivot, forward, active);
+				parallel_reach(reverse.offsets, reverse.targets, pivot, backward, active);
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					if (forward[u].load(std::memory_order_relaxed) != 0U
+					    and backward[u].load(std::memory_order_relaxed) != 0U)
+					{
+						components[u] = pivot;
+					}
+				}
+			}
+
+			// Colouring: every node ends up with the largest id that can reach it. A node whose
+			// colour is its own id is a root, and its component is exactly the nodes of its colour
+			// that can reach it.
+			auto colours = std::vector<std::atomic<std::size_t>>(n);
+			for (auto& colour : colours) {
+				colour.store(no_component, std::memory_order_relaxed);
+			}
+			auto remaining = std::vector<std::size_t>{};
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				if (active(u)) {
+					remaining.push_back(u);
+				}
+			}
+			while (not remaining.empty()) {
+				if (remaining.size() < sequential_below) {
+					tarjan_components(g, components);
+					break;
+				}
+				for (auto const u : remaining) {
+					colours[u].store(u, std::memory_order_relaxed);
+				}
+				auto changed = std::atomic<bool>{true};
+				auto const propagate = [&](std::size_t first, std::size_t last, std::size_t) {
+					for (auto i = first; i < last; ++i) {
+						auto const u = remaining[i];
+						auto const colour = colours[u].load(std::memory_order_relaxed);
+						for (auto const v : g.neighbours(u)) {
+							if (not active(v)) {
+								continue;
+							}
+							auto current = colours[v].load(std::memory_order_relaxed);
+							while (current < colour) {
+								if (colours[v].compare_exchange_weak(current, colour)) {
+									changed.store(true, std::memory_order_relaxed);
+									break;
+								}
+							}
+						}
+					}
+				};
+				// Only a pass that changes nothing shows that the colours have settled. The flag is
+				// cleared before each pass, so it is read once more after the pass cap.
+				auto converged = false;
+				for (auto passes = 0; passes < max_passes; ++passes) {
+					if (not changed.exchange(false)) {
+						converged = true;
+						break;
+					}
+					parallel_chunks(0U, remaining.size(), propagate);
+				}
+				if (not converged and changed.load()) {
+					tarjan_components(g, components);
+					break;
+				}
+
+				auto roots = std::vector<std::size_t>{};
+				for (auto const u : remaining) {
+					if (colours[u].load(std::memory_order_relaxed) == u) {
+						roots.push_back(u);
+					}
+				}
+				// Colours partition the remaining nodes, so the backward searches never overlap as long
+				// as each one checks the colour before touching a node's component.
+				parallel_for_dynamic(0U, roots.size(), [&](std::size_t i, std::size_t) {
+					auto const root = roots[i];
+					auto stack = std::vector<std::size_t>{root};
+					components[root] = root;
+					while (not stack.empty()) {
+						auto const u = stack.back();
+						stack.pop_back();
+						for (auto const v : reverse.neighbours(u)) {
+							if (colours[v].load(std::memory_order_relaxed) == root
+							    and components[v] == no_component)
+							{
+								components[v] = root;
+								stack.push_back(v);
+							}
+						}
+					}
+				});
+				auto const before = remaining.size();
+				std::erase_if(remaining, [&](std::size_t u) { return not active(u); });
+				if ((before - remaining.size()) * min_progress < before) {
+					tarjan_components(g, components);
+					break;
+				}
+			}
+			return components;
+		}
+	} // namespace detail
+
+	// Weakly connected components: returns a component id for every node, in the same order as
+	// g.nodes(). Ids are dense, starting at zero, and numbered in order of each component's first
+	// node. Edge ranges are merged into a lock-free union-find by std::thread workers in parallel.
+	template<typename N, typename E>
+	auto connected_components(graph<N, E> const& g) -> std::vector<std::size_t> {
+		auto const adjacency = g.to_csr();
+		auto const n = adjacency.node_count();
+		auto sets = detail::concurrent_union_find(n);
+		auto const merge = [&](std::size_t first, std::size_t last, std::size_t) {
+			for (auto u = first; u < last; ++u) {
+				for (auto const v : adjacency.neighbours(u)) {
+					sets.unite(u, v);
+				}
+			}
+		};
+		detail::parallel_edge_chunks(adjacency.offsets, merge);
+
+		// Every root is the smallest member of its set, so numbering roots in a forward scan gives
+		// each component the id of its first node, and every other node sees its root first.
+		auto components = std::vector<std::size_t>(n);
+		auto count = std::size_t{0};
+		for (auto u = std::size_t{0}; u < n; ++u) {
+			auto const root = sets.find(u);
+			components[u] = root == u ? count++ : components[root];
+		}
+		return components;
+	}
+
+	// Selects the strongly_connected_components implementation. `automatic` picks `tarjan` for
+	// small graphs or when only one thread is available, and `parallel` otherwise.
+	enum class scc_algorithm { automatic, tarjan, parallel };
+
+	// Strongly connected components: returns a component id for every node, in the same order as
+	// g.nodes(), numbered densely in order of each component's first node so that every
+	// algorithm gives the same answer. Neither implementation recurses, so deep chains are safe.
+	template<typename N, typename E>
+	auto strongly_connected_components(graph<N, E> const& g,
+	                                   scc_algorithm algorithm = scc_algorithm::automatic)
+	   -> std::vector<std::size_t> {
+		constexpr auto parallel_threshold = std::size_t{1} << 16U;
+		auto const adjacency = g.to_csr();
+		if (algorithm == scc_algorithm::automatic) {
+			algorithm = adjacency.node_count() < parallel_threshold or max_threads() == 1U
+			               ? scc_algorithm::tarjan
+			               : scc_algorithm::parallel;
+		}
+		if (algorithm == scc_algorithm::tarjan) {
+			auto components = std::vector<std::size_t>(adjacency.node_count(), detail::no_component);
+			detail::tarjan_components(adjacency, components);
+			return detail::relabel_by_first_node(std::move(components));
+		}
+		return detail::relabel_by_first_node(detail::parallel_components(adjacency));
+	}
+
+	// The condensation of `g` under `components` (one id per node, as returned by
+	// strongly_connected_components): a graph with one node per component id and an edge between
+	// two components for every distinct weight of the edges between their members.
+	template<typename N, typename E>
+	auto condensation(graph<N, E> const& g, std::vector<std::size_t> const& components)
+	   -> graph<std::size_t, E> {
+		auto const adjacency = g.to_csr();
+		if (components.size() != adjacency.node_count()) {
+			throw std::runtime_error("Cannot call gdwg::condensation without exactly one component "
+			                         "id per node");
+		}
+		auto dag = graph<std::size_t, E>{};
+		for (auto const c : components) {
+			dag.insert_node(c);
+		}
+		for (auto u = std::size_t{0}; u < adjacency.node_count(); ++u) {
+			for (auto e = adjacency.offsets[u]; e < adjacency.offsets[u + 1U]; ++e) {
+				auto const v = adjacency.targets[e];
+				if (components[u] != components[v]) {
+					dag.insert_edge(components[u], components[v], adjacency.weights[e]);
+				}
+			}
+		}
+		return dag;
+	}
+} // namespace gdwg
+
+#endif // GDWG_COMPONENTS_HPP
@@ -0,0 +1,668 @@
+#ifndef GDWG_CONTRACTION_HIERARCHY_HPP
+#define GDWG_CONTRACTION_HIERARCHY_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	namespace detail {
+		inline constexpr auto no_middle = std::numeric_limits<std::size_t>::max();
+
+		// An edge of the hierarchy. `middle` is the node a shortcut was contracted over, or
+		// no_middle for an edge of the original graph.
+		template<typename E>
+		struct hierarchy_arc {
+			std::size_t node;
+			E weight;
+			std::size_t middle;
+		};
+
+		template<typename E>
+		struct hierarchy_shortcut {
+			std::size_t from;
+			std::size_t to;
+			E weight;
+			std::size_t middle;
+		};
+
+		// The arcs from each node to nodes contracted after it, sorted by node.
+		template<typename E>
+		struct upward_graph {
+			std::vector<std::size_t> offsets;
+			std::vector<hierarchy_arc<E>> arcs;
+
+			[[nodiscard]] auto arcs_of(std::size_t u) const noexcept
+			   -> std::span<hierarchy_arc<E> const> {
+				return {this->arcs.data() + this->offsets[u], this->offsets[u + 1U] - this->offsets[u]};
+			}
+
+			[[nodiscard]] auto find(std::size_t u, std::size_t node) const
+			   -> hierarchy_arc<E> const& {
+				auto const row = this->arcs_of(u);
+				auto const before = [](auto const& arc, std::size_t v) { return arc.node < v; };
+				return *std::lower_bound(row.begin(), row.end(), node, before);
+			}
+		};
+
+		// Dijkstra for witness searches: stops once every target is settled, past `limit`, or
+		// after settling a fixed number of nodes, and never enters a node for which `skip` holds.
+		// Giving up early only costs an unneeded shortcut. Only the nodes a run touched are reset,
+		// as in detail::dijkstra.
+		template<typename E>
+		class witness_search {
+		public:
+			static constexpr auto unreached = std::numeric_limits<E>::max();
+			explicit witness_search(std::size_t nodes)
+			: distances_(nodes, unreached)
+			, targets_(nodes, 0) {}
+
+			template<typename Skip>
+			auto run(std::vector<std::vector<hierarchy_arc<E>>> const& out,
+			         std::size_t source,
+			         E limit,
+			         std::span<hierarchy_arc<E> const> targets,
+			         std::size_t settle_limit,
+			         Skip const& skip) -> void {
+				for (auto const v : this->touched_) {
+					this->distances_[v] = unreached;
+				}
+				this->touched_.clear();
+				this->heap_.clear();
+				auto remaining = std::size_t{0};
+				for (auto const& arc : targets) {
+					if (arc.node != source and this->targets_[arc.node] == 0) {
+						this->targets_[arc.node] = 1;
+						++remaining;
+					}
+				}
+				this->reach(source, E{0});
+				auto settled = std::size_t{0};
+				while (not this->heap_.empty() and remaining > 0U and settled < settle_limit) {
+					std::pop_heap(this->heap_.begin(), this->heap_.end(), std::greater<>{});
+					auto const [d, u] = this->heap_.back();
+					this->heap_.pop_back();
+					if (d > this->distances_[u]) {
+						continue;
+					}
+					if (d > limit) {
+						break;
+					}
+					++settled;
+					if (this->targets_[u] != 0) {
+						this->targets_[u] = 0;
+						--remaining;
+					}
+					for (auto const& arc : out[u]) {
+						auto const candidate = static_cast<E>(d + arc.weight);
+						if (not skip(arc.node) and candidate < this->distances_[arc.node]) {
+							this->reach(arc.node, candidate);
+						}
+					}
+				}
+				for (auto const& arc : targets) {
+					this->targets_[arc.node] = 0;
+				}
+			}
+
+			[[nodiscard]] auto distance(std::size_t v) const noexcept -> E {
+				return this->distances_[v];
+			}
+
+		private:
+			std::vector<E> distances_;
+			std::vector<char> targets_;
+			std::vector<std::size_t> touched_;
+			std::vector<std::pair<E, std::size_t>> heap_;
+
+			auto reach(std::size_t v, E d) -> void {
+				if (this->distances_[v] == unreached) {
+					this->touched_.push_back(v);
+				}
+				this->distances_[v] = d;
+				this->heap_.emplace_back(d, v);
+				std::push_heap(this->heap_.begin(), this->heap_.end(), std::greater<>{});
+			}
+		};
+
+		// Contracts every node of a graph in rounds. Each round picks the nodes whose priority
+		// (edge difference plus contracted neighbours plus level) is lower than that of all their
+		// neighbours, which makes them pairwise non-adjacent. Their shortcuts are found in
+		// parallel by witness searches that avoid every node picked in the round. The remaining
+		// adjacency lists are updated in parallel per node, and priorities are refreshed for the
+		// neighbours of the contracted nodes.
+		template<typename E>
+		class hierarchy_builder {
+		public:
+			template<typename N>
+			explicit hierarchy_builder(csr<N, E> const& g)
+			: out_(g.node_count())
+			, in_(g.node_count())
+			, ranks_(g.node_count(), unranked)
+			, priorities_(g.node_count(), 0)
+			, contracted_neighbours_(g.node_count(), 0U)
+			, levels_(g.node_count(), 0U)
+			, picked_(g.node_count(), 0)
+			, up_out_(g.node_count())
+			, up_in_(g.node_count()) {
+				for (auto u = std::size_t{0}; u < g.node_count(); ++u) {
+					for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+						auto const v = g.targets[e];
+						if (v != u) {
+							this->out_[u].push_back({v, g.weights[e], no_middle});
+							this->in_[v].push_back({u, g.weights[e], no_middle});
+						}
+					}
+				}
+			}
+
+			// Contracts everything and returns the upward graphs: out-arcs, and in-arcs keyed by
+			// their target.
+			auto run() -> std::pair<upward_graph<E>, upward_graph<E>> {
+				auto const n = this->out_.size();
+				auto remaining = std::vector<std::size_t>(n);
+				std::iota(remaining.begin(), remaining.end(), std::size_t{0});
+				// The searches run in batches of 16 nodes out of at most n, so this many workers is
+				// the most any pass asks for.
+				this->searches_.assign(worker_count(n, 16U), witness_search<E>(n));
+				this->update_priorities(remaining);
+
+				auto rank = std::size_t{0};
+				auto picked = std::vector<std::size_t>{};
+				while (not remaining.empty()) {
+					this->pick(remaining, picked);
+					for (auto const v : picked) {
+						this->picked_[v] = 1;
+						this->ranks_[v] = rank++;
+					}
+					auto const shortcuts = this->find_shortcuts(picked);
+					for (auto const v : picked) {
+						this->up_out_[v] = std::move(this->out_[v]);
+						this->up_in_[v] = std::move(this->in_[v]);
+						this->out_[v].clear();
+						this->in_[v].clear();
+					}
+					auto const touched = this->apply(picked, shortcuts);
+					for (auto const v : picked) {
+						this->picked_[v] = 0;
+					}
+					std::erase_if(remaining,
+					              [this](std::size_t v) { return this->ranks_[v] != unranked; });
+					this->update_priorities(touched);
+				}
+				return {flatten(this->up_out_), flatten(this->up_in_)};
+			}
+
+		private:
+			static constexpr auto unranked = std::numeric_limits<std::size_t>::max();
+			// Priorities only need an estimate of the shortcuts, so their searches give up sooner.
+			static constexpr auto simulation_settle_limit = std::size_t{50};
+			static constexpr auto contraction_settle_limit = std::size_t{500};
+
+			std::vector<std::vector<hierarchy_arc<E>>> out_;
+			std::vector<std::vector<hierarchy_arc<E>>> in_;
+			std::vector<std::size_t> ranks_;
+			std::vector<long long> priorities_;
+			std::vector<std::size_t> contracted_neighbours_;
+			std::vector<std::size_t> levels_;
+			std::vector<char> picked_;
+			std::vector<std::vector<hierarchy_arc<E>>> up_out_;
+			std::vector<std::vector<hierarchy_arc<E>>> up_in_;
+			std::vector<witness_search<E>> searches_;
+
+			static auto flatten(std::vector<std::vector<hierarchy_arc<E>>>& rows) -> upward_graph<E> {
+				auto result = upward_graph<E>{};
+				result.offsets.assign(rows.size() + 1U, 0U);
+				for (auto u = std::size_t{0}; u < rows.size(); ++u) {
+					result.offsets[u + 1U] = result.offsets[u] + rows[u].size();
+				}
+				result.arcs.reserve(result.offsets.back());
+				for (auto& row : rows) {
+					std::sort(row.begin(), row.end(), [](auto const& a, auto const& b) {
+						return a.node < b.node;
+					});
+					result.arcs.insert(result.arcs.end(), row.cbegin(), row.cend());
+					row = {};
+				}
+				return result;
+			}
+
+			auto pick(std::vector<std::size_t> const& remaining, std::vector<std::size_t>& picked)
+			   -> void {
+				constexpr auto grain = std::size_t{1024};
+				auto const workers = worker_count(remaining.size(), grain);
+				auto found = std::vector<std::vector<std::size_t>>(workers);
+				parallel_chunks(
+				   0U,
+				   remaining.size(),
+				   [&](std::size_t first, std::size_t last, std::size_t worker) {
+					   for (auto i = first; i < last; ++i) {
+						   if (this->locally_minimal(remaining[i])) {
+							   found[worker].push_back(remaining[i]);
+						   }
+					   }
+				   },
+				   grain);
+				picked.clear();
+				for (auto const& part : found) {
+					picked.insert(picked.end(), part.cbegin(), part.cend());
+				}
+			}
+
+			// Whether v comes before every neighbour in (priority, id) order.
+			[[nodiscard]] auto locally_minimal(std::size_t v) const -> bool {
+				auto const before = [this, v](std::size_t u) {
+					return std::pair(this->priorities_[v], v) < std::pair(this->priorities_[u], u);
+				};
+				auto const arc_before = [&](auto const& arc) { return before(arc.node); };
+				return std::all_of(this->out_[v].cbegin(), this->out_[v].cend(), arc_before)
+				       and std::all_of(this->in_[v].cbegin(), this->in_[v].cend(), arc_before);
+			}
+
+			// Appends the shortcuts that contracting v needs, given that the nodes for which
+			// `skip` holds are gone as well.
+			template<typename Skip>
+			auto shortcuts_for(std::size_t v,
+			                   witness_search<E>& search,
+			                   std::size_t settle_limit,
+			                   Skip const& skip,
+			                   std::vector<hierarchy_shortcut<E>>& shortcuts) -> void {
+				auto const& outgoing = this->out_[v];
+				if (outgoing.empty()) {
+					return;
+				}
+				auto const lighter = [](auto const& a, auto const& b) { return a.weight < b.weight; };
+				auto const heaviest =
+				   std::max_element(outgoing.cbegin(), outgoing.cend(), lighter)->weight;
+				for (auto const& incoming : this->in_[v]) {
+					auto const u = incoming.node;
+					auto const limit = static_cast<E>(incoming.weight + heaviest);
+					search.run(this->out_, u, limit, outgoing, settle_limit, [&](std::size_t x) {
+						return x == v or skip(x);
+					});
+					for (auto const& arc : outgoing) {
+						auto const via = static_cast<E>(incoming.weight + arc.weight);
+						if (arc.node != u and search.distance(arc.node) > via) {
+							shortcuts.push_back({u, arc.node, via, v});
+						}
+					}
+				}
+			}
+
+			// Recomputes the priority of each node in `nodes` by simulating its contraction.
+			auto update_priorities(std::vector<std::size_t> const& nodes) -> void {
+				auto scratch = std::vector<std::vector<hierarchy_shortcut<E>>>(this->searches_.size());
+				parallel_for_dynamic(
+				   0U,
+				   nodes.size(),
+				   [&](std::size_t i, std::size_t worker) {
+					   auto const v = nodes[i];
+					   auto& shortcuts = scratch[worker];
+					   shortcuts.clear();
+					   this->shortcuts_for(v,
+					                       this->searches_[worker],
+					                       simulation_settle_limit,
+					                       [](std::size_t) { return false; },
+					                       shortcuts);
+					   auto const degree = this->out_[v].size() + this->in_[v].size();
+					   this->priorities_[v] = static_cast<long long>(shortcuts.size())
+					                          - static_cast<long long>(degree)
+					                          + static_cast<long long>(this->contracted_neighbours_[v])
+					                          + static_cast<long long>(this->levels_[v]);
+				   },
+				   16U,
+				   worker_count(nodes.size(), 16U));
+			}
+
+			auto find_shortcuts(std::vector<std::size_t> const& picked)
+			   -> std::vector<hierarchy_shortcut<E>> {
+				auto const workers = worker_count(picked.size(), 16U);
+				auto found = std::vector<std::vector<hierarchy_shortcut<E>>>(workers);
+				parallel_for_dynamic(
+				   0U,
+				   picked.size(),
+				   [&](std::size_t i, std::size_t worker) {
+					   auto const skip = [this](std::size_t x) { return this->picked_[x] != 0; };
+					   this->shortcuts_for(picked[i],
+					                       this->searches_[worker],
+					                       contraction_settle_limit,
+					                       skip,
+					                       found[worker]);
+				   },
+				   16U,
+				   workers);
+				auto shortcuts = std::move(found.front());
+				for (auto worker = std::size_t{1}; worker < workers; ++worker) {
+					shortcuts.insert(shortcuts.end(), found[worker].cbegin(), found[worker].cend());
+				}
+				return shortcuts;
+			}
+
+			// Drops the arcs to contracted nodes from their neighbours and merges in the shortcuts,
+			// keeping the lighter arc where one already exists. Returns the nodes that changed.
+			auto apply(std::vector<std::size_t> const& picked,
+			           std::vector<hierarchy_shortcut<E>> shortcuts) -> std::vector<std::size_t> {
+				auto touched = std::vector<std::size_t>{};
+				for (auto const v : picked) {
+					for (auto const& arc : this->up_out_[v]) {
+						touched.push_back(arc.node);
+					}
+					for (auto const& arc : this->up_in_[v]) {
+						touched.push_back(arc.node);
+					}
+				}
+				std::sort(touched.begin(), touched.end());
+				touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+				auto by_target = shortcuts;
+				std::sort(shortcuts.begin(), shortcuts.end(), [](auto const& a, auto const& b) {
+					return a.from < b.from;
+				});
+				std::sort(by_target.begin(), by_target.end(), [](auto const& a, auto const& b) {
+					return a.to < b.to;
+				});
+				auto const merge = [](std::vector<hierarchy_arc<E>>& arcs, hierarchy_arc<E> arc) {
+					auto const itr = std::find_if(arcs.begin(), arcs.end(), [&](auto const& existing) {
+						return existing.node == arc.node;
+					});
+					if (itr == arcs.end()) {
+						arcs.push_back(arc);
+					}
+					else if (arc.weight < itr->weight) {
+						*itr = arc;
+					}
+				};
+				parallel_for_dynamic(
+				   0U,
+				   touched.size(),
+				   [&](std::size_t i, std::size_t) {
+					   auto const u = touched[i];
+					   auto level = this->levels_[u];
+					   auto removed = std::size_t{0};
+					   auto const gone = [&](auto const& arc) {
+						   if (this->ranks_[arc.node] == unranked) {
+							   return false;
+						   }
+						   level = std::max(level, this->levels_[arc.node] + 1U);
+						   ++removed;
+						   return true;
+					   };
+					   std::erase_if(this->out_[u], gone);
+					   std::erase_if(this->in_[u], gone);
+					   this->levels_[u] = level;
+					   this->contracted_neighbours_[u] += removed;
+
+					   auto const from = std::equal_range(
+					      shortcuts.cbegin(),
+					      shortcuts.cend(),
+					      hierarchy_shortcut<E>{u, u, E{}, no_middle},
+					      [](auto const& a, auto const& b) { return a.from < b.from; });
+					   for (auto itr = from.first; itr != from.second; ++itr) {
+						   merge(this->out_[u], {itr->to, itr->weight, itr->middle});
+					   }
+					   auto const to = std::equal_range(
+					      by_target.cbegin(),
+					      by_target.cend(),
+					      hierarchy_shortcut<E>{u, u, E{}, no_middle},
+					      [](auto const& a, auto const& b) { return a.to < b.to; });
+					   for (auto itr = to.first; itr != to.second; ++itr) {
+						   merge(this->in_[u], {itr->from, itr->weight, itr->middle});
+					   }
+				   },
+				   16U);
+				return touched;
+			}
+		};
+	} // namespace detail
+
+	// A contraction hierarchy over `g` for fast repeated shortest-path queries on a graph that
+	// rarely changes. Preprocessing contracts nodes in order of edge difference, adding a
+	// shortcut wherever a witness search finds no other path as short, and runs each round of
+	// mutually non-adjacent nodes in parallel. A query is a bidirectional Dijkstra that only
+	// climbs the hierarchy, which settles a few hundred nodes on road-like graphs. Each
+	// multi-edge contributes its minimum weight and self-loops are ignored. Weights must be
+	// arithmetic and non-negative.
+	template<typename N, typename E>
+	class contraction_hierarchy {
+	public:
+		using size_type = std::size_t;
+
+		explicit contraction_hierarchy(graph<N, E> const& g) {
+			static_assert(std::is_arithmetic_v<E>,
+			              "gdwg::contraction_hierarchy requires arithmetic weights");
+			auto adjacency = g.to_csr().lightest_edges();
+			if (std::any_of(adjacency.weights.cbegin(), adjacency.weights.cend(), [](E w) {
+				    return w < E{0};
+			    }))
+			{
+				throw std::runtime_error("Cannot call gdwg::contraction_hierarchy on a graph with a "
+				                         "negative weight");
+			}
+			auto [up, down] = detail::hierarchy_builder<E>(adjacency).run();
+			this->nodes_ = std::move(adjacency.nodes);
+			this->up_ = std::move(up);
+			this->down_ = std::move(down);
+		}
+
+		[[nodiscard]] auto nodes() const noexcept -> std::vector<N> const& {
+			return this->nodes_;
+		}
+
+		// Number of shortcuts the hierarchy added.
+		[[nodiscard]] auto shortcut_count() const noexcept -> size_type {
+			auto const is_shortcut = [](auto const& arc) { return arc.middle != detail::no_middle; };
+			return static_cast<size_type>(
+			   std::count_if(this->up_.arcs.cbegin(), this->up_.arcs.cend(), is_shortcut)
+			   + std::count_if(this->down_.arcs.cbegin(), this->down_.arcs.cend(), is_shortcut));
+		}
+
+		// Reusable search state for queries against one hierarchy. Constructing it allocates
+		// O(V), after which each query only touches the nodes it settles. A query object is not
+		// thread-safe, but any number of them can share a hierarchy.
+		class query {
+		public:
+			explicit query(contraction_hierarchy const& hierarchy)
+			: hierarchy_{hierarchy}
+			, forward_(hierarchy.nodes_.size())
+			, backward_(hierarchy.nodes_.size()) {}
+
+			// Shortest distance from `src` to `dst`, or std::nullopt if dst is unreachable.
+			[[nodiscard]] auto distance(N const& src, N const& dst) -> std::optional<E> {
+				auto const [s, t] = this->hierarchy_.endpoints(src, dst, "distance");
+				auto const meeting = this->search(s, t);
+				if (meeting == unreached_node) {
+					return std::nullopt;
+				}
+				return static_cast<E>(this->forward_.distances[meeting]
+				                       + this->backward_.distances[meeting]);
+			}
+
+			// The nodes of a shortest path from `src` to `dst`, both included, with every shortcut
+			// expanded. Empty if dst is unreachable.
+			[[nodiscard]] auto path(N const& src, N const& dst) -> std::vector<N> {
+				auto const [s, t] = this->hierarchy_.endpoints(src, dst, "path");
+				auto const meeting = this->search(s, t);
+				if (meeting == unreached_node) {
+					return {};
+				}
+				auto const& hierarchy = this->hierarchy_;
+				auto climb = std::vector<size_type>{meeting};
+				while (climb.back() != s) {
+					climb.push_back(this->forward_.parents[climb.back()]);
+				}
+				auto result = std::vector<N>{hierarchy.nodes_[s]};
+				for (auto i = climb.size() - 1U; i > 0U; --i) {
+					auto const& arc = hierarchy.up_.find(climb[i], climb[i - 1U]);
+					hierarchy.unpack(climb[i], arc, result);
+				}
+				for (auto u = meeting; u != t; u = this->backward_.parents[u]) {
+					auto const next = this->backward_.parents[u];
+					auto const& arc = hierarchy.down_.find(next, u);
+					hierarchy.unpack(u, {next, arc.weight, arc.middle}, result);
+				}
+				return result;
+			}
+
+		private:
+			static constexpr auto unreached = std::numeric_limits<E>::max();
+			static constexpr auto unreached_node = std::numeric_limits<size_type>::max();
+
+			struct side {
+				explicit side(size_type nodes)
+				: distances(nodes, unreached)
+				, parents(nodes, unreached_node) {}
+
+				std::vector<E> distances;
+				std::vector<size_type> parents;
+				std::vector<size_type> touched;
+				std::vector<std::pair<E, size_type>> heap;
+
+				auto reset() -> void {
+					for (auto const v : this->touched) {
+						this->distances[v] = unreached;
+						this->parents[v] = unreached_node;
+					}
+					this->touched.clear();
+					this->heap.clear();
+				}
+
+				auto reach(size_type v, E d, size_type parent) -> void {
+					if (this->distances[v] == unreached) {
+						this->touched.push_back(v);
+					}
+					this->distances[v] = d;
+					this->parents[v] = parent;
+					this->heap.emplace_back(d, v);
+					std::push_heap(this->heap.begin(), this->heap.end(), std::greater<>{});
+				}
+
+				[[nodiscard]] auto next_distance() const -> E {
+					return this->heap.empty() ? unreached : this->heap.front().first;
+				}
+			};
+
+			contraction_hierarchy const& hierarchy_;
+			side forward_;
+			side backward_;
+
+			// Alternates upward Dijkstra steps from both ends until neither can beat the best
+			// meeting point found so far, and returns that meeting point.
+			auto search(size_type s, size_type t) -> size_type {
+				this->forward_.reset();
+				this->backward_.reset();
+				this->forward_.reach(s, E{0}, s);
+				this->backward_.reach(t, E{0}, t);
+				auto best = unreached;
+				auto meeting = unreached_node;
+				auto const settle = [&](side& self,
+				                        side const& other,
+				                        detail::upward_graph<E> const& arcs) {
+					std::pop_heap(self.heap.begin(), self.heap.end(), std::greater<>{});
+					auto const [d, u] = self.heap.back();
+					self.heap.pop_back();
+					if (d > self.distances[u]) {
+						return;
+					}
+					if (other.distances[u] != unreached
+					    and static_cast<E>(d + other.distances[u]) < best)
+					{
+						best = static_cast<E>(d + other.distances[u]);
+						meeting = u;
+					}
+					for (auto const& arc : arcs.arcs_of(u)) {
+						auto const candidate = static_cast<E>(d + arc.weight);
+						if (candidate < self.distances[arc.node]) {
+							self.reach(arc.node, candidate, u);
+						}
+					}
+				};
+				auto forward_turn = true;
+				while (true) {
+					auto const forward_open = this->forward_.next_distance() < best;
+					auto const backward_open = this->backward_.next_distance() < best;
+					if (not forward_open and not backward_open) {
+						return meeting;
+					}
+					if (forward_open and (forward_turn or not backward_open)) {
+						settle(this->forward_, this->backward_, this->hierarchy_.up_);
+					}
+					else {
+						settle(this->backward_, this->forward_, this->hierarchy_.down_);
+					}
+					forward_turn = not forward_turn;
+				}
+			}
+		};
+
+		// Shortest distance from `src` to `dst`, or std::nullopt if dst is unreachable. Allocates
+		// a fresh query each time; hold a query object for repeated calls.
+		[[nodiscard]] auto distance(N const& src, N const& dst) const -> std::optional<E> {
+			return query(*this).distance(src, dst);
+		}
+
+		// The nodes of a shortest path from `src` to `dst`, as query::path.
+		[[nodiscard]] auto path(N const& src, N const& dst) const -> std::vector<N> {
+			return query(*this).path(src, dst);
+		}
+
+	private:
+		std::vector<N> nodes_;
+		// Arcs from each node up to later contracted nodes, and arcs into each node from later
+		// contracted nodes, keyed by the lower node.
+		detail::upward_graph<E> up_;
+		detail::upward_graph<E> down_;
+
+		[[nodiscard]] auto index_of(N const& value) const -> size_type {
+			auto const itr = std::lower_bound(this->nodes_.cbegin(), this->nodes_.cend(), value);
+			if (itr == this->nodes_.cend() or value < *itr) {
+				return this->nodes_.size();
+			}
+			return static_cast<size_type>(itr - this->nodes_.cbegin());
+		}
+
+		[[nodiscard]] auto endpoints(N const& src, N const& dst, char const* caller) const
+		   -> std::pair<size_type, size_type> {
+			auto const s = this->index_of(src);
+			auto const t = this->index_of(dst);
+			if (s == this->nodes_.size() or t == this->nodes_.size()) {
+				throw std::runtime_error(std::string("Cannot call gdwg::contraction_hierarchy<N, E>::")
+				                         + caller + " if src or dst node don't exist in the graph");
+			}
+			return {s, t};
+		}
+
+		// Appends the original nodes after `from` along `arc`, expanding shortcuts.
+		auto unpack(size_type from, detail::hierarchy_arc<E> const& arc, std::vector<N>& result) const
+		   -> void {
+			auto pending = std::vector<std::pair<size_type, detail::hierarchy_arc<E>>>{{from, arc}};
+			while (not pending.empty()) {
+				auto const [u, next] = pending.back();
+				pending.pop_back();
+				if (next.middle == detail::no_middle) {
+					result.push_back(this->nodes_[next.node]);
+					continue;
+				}
+				// The middle node was contracted first, so both halves hang off it.
+				auto const m = next.middle;
+				pending.emplace_back(m, this->up_.find(m, next.node));
+				auto const& first = this->down_.find(m, u);
+				pending.emplace_back(u, detail::hierarchy_arc<E>{m, first.weight, first.middle});
+			}
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_CONTRACTION_HIERARCHY_HPP
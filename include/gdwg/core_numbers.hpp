@@ -0,0 +1,208 @@
+#ifndef GDWG_CORE_NUMBERS_HPP
+#define GDWG_CORE_NUMBERS_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Which degree core_numbers peels by. A node's `in` degree counts its distinct in-neighbours,
+	// its `out` degree its distinct out-neighbours, and its `total` degree the sum of both.
+	enum class core_degree { total, in, out };
+
+	// Selects the core_numbers implementation. `automatic` picks `bucket` for small graphs or when
+	// only one thread is available, and `parallel` otherwise.
+	enum class core_algorithm { automatic, bucket, parallel };
+
+	namespace detail {
+		// What peeling needs: each node's starting degree, and for each node the neighbours whose
+		// degree drops when it is removed, listed once per edge that counts towards them.
+		struct peeling_structure {
+			std::vector<std::size_t> degrees;
+			std::vector<std::size_t> offsets;
+			std::vector<std::size_t> affected;
+		};
+
+		template<typename N, typename E>
+		auto make_peeling_structure(csr<N, E> const& g, core_degree degree) -> peeling_structure {
+			auto const n = g.node_count();
+			auto const simple = [&g](std::size_t u, std::size_t e) {
+				auto const first = e == g.offsets[u] or g.targets[e] != g.targets[e - 1U];
+				return first and g.targets[e] != u;
+			};
+			auto const removing_lowers_target = degree != core_degree::out;
+			auto const removing_lowers_source = degree != core_degree::in;
+
+			auto result = peeling_structure{};
+			result.degrees.assign(n, 0U);
+			result.offsets.assign(n + 1U, 0U);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					if (not simple(u, e)) {
+						continue;
+					}
+					// Removing u lowers the in-degree of v, and removing v the out-degree of u.
+					if (removing_lowers_target) {
+						++result.degrees[g.targets[e]];
+						++result.offsets[u + 1U];
+					}
+					if (removing_lowers_source) {
+						++result.degrees[u];
+						++result.offsets[g.targets[e] + 1U];
+					}
+				}
+			}
+			std::partial_sum(result.offsets.cbegin(), result.offsets.cend(), result.offsets.begin());
+			auto cursor =
+			   std::vector<std::size_t>(result.offsets.cbegin(), std::prev(result.offsets.cend()));
+			result.affected.resize(result.offsets.back());
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					if (not simple(u, e)) {
+						continue;
+					}
+					if (removing_lowers_target) {
+						result.affected[cursor[u]++] = g.targets[e];
+					}
+					if (removing_lowers_source) {
+						result.affected[cursor[g.targets[e]]++] = u;
+					}
+				}
+			}
+			return result;
+		}
+
+		// Batagelj and Zaversnik's linear-time peeling: nodes sit in an array bucketed by current
+		// degree and are removed in that order; a neighbour whose degree drops is swapped to the
+		// front of its bucket and the bucket boundary moved past it, which is O(1) per edge.
+		inline auto bucket_cores(peeling_structure structure) -> std::vector<std::size_t> {
+			auto& degrees = structure.degrees;
+			auto const n = degrees.size();
+			auto const max_degree =
+			   n == 0U ? std::size_t{0} : *std::max_element(degrees.cbegin(), degrees.cend());
+			auto bucket_start = std::vector<std::size_t>(max_degree + 2U, 0U);
+			for (auto const d : degrees) {
+				++bucket_start[d + 1U];
+			}
+			std::partial_sum(bucket_start.cbegin(), bucket_start.cend(), bucket_start.begin());
+
+			auto order = std::vector<std::size_t>(n);
+			auto position = std::vector<std::size_t>(n);
+			auto cursor = bucket_start;
+			for (auto v = std::size_t{0}; v < n; ++v) {
+				position[v] = cursor[degrees[v]]++;
+				order[position[v]] = v;
+			}
+
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				auto const v = order[i];
+				for (auto a = structure.offsets[v]; a < structure.offsets[v + 1U]; ++a) {
+					auto const u = structure.affected[a];
+					if (degrees[u] <= degrees[v]) {
+						continue;
+					}
+					auto const front = bucket_start[degrees[u]];
+					auto const w = order[front];
+					std::swap(order[front], order[position[u]]);
+					std::swap(position[u], position[w]);
+					++bucket_start[degrees[u]];
+					--degrees[u];
+				}
+			}
+			return std::move(degrees);
+		}
+
+		// Level-synchronous peeling: at level k every remaining node of degree at most k is
+		// removed in parallel, which can push neighbours to degree k and into the next round of
+		// the same level. Degrees are decremented atomically, and exactly one decrement takes a
+		// node from k + 1 to k, so each node joins a frontier once. When a level runs dry, k jumps
+		// to the smallest remaining degree.
+		inline auto parallel_cores(peeling_structure const& structure) -> std::vector<std::size_t> {
+			constexpr auto grain = std::size_t{1024};
+			auto const n = structure.degrees.size();
+			auto degrees = std::vector<std::atomic<std::size_t>>(n);
+			for (auto v = std::size_t{0}; v < n; ++v) {
+				degrees[v].store(structure.degrees[v], std::memory_order_relaxed);
+			}
+			auto cores = std::vector<std::size_t>(n, 0U);
+			auto removed = std::vector<char>(n, 0);
+			auto remaining = std::vector<std::size_t>(n);
+			std::iota(remaining.begin(), remaining.end(), std::size_t{0});
+			auto frontier = std::vector<std::size_t>{};
+			auto found = std::vector<std::vector<std::size_t>>{};
+
+			while (not remaining.empty()) {
+				auto k = std::numeric_limits<std::size_t>::max();
+				for (auto const v : remaining) {
+					k = std::min(k, degrees[v].load(std::memory_order_relaxed));
+				}
+				frontier.clear();
+				for (auto const v : remaining) {
+					if (degrees[v].load(std::memory_order_relaxed) <= k) {
+						frontier.push_back(v);
+					}
+				}
+
+				while (not frontier.empty()) {
+					found.assign(worker_count(frontier.size(), grain), {});
+					parallel_chunks(
+					   0U,
+					   frontier.size(),
+					   [&](std::size_t first, std::size_t last, std::size_t worker) {
+						   for (auto i = first; i < last; ++i) {
+							   auto const v = frontier[i];
+							   cores[v] = k;
+							   removed[v] = 1;
+							   for (auto a = structure.offsets[v]; a < structure.offsets[v + 1U]; ++a)
+							   {
+								   auto const u = structure.affected[a];
+								   if (degrees[u].fetch_sub(1U, std::memory_order_relaxed) == k + 1U) {
+									   found[worker].push_back(u);
+								   }
+							   }
+						   }
+					   },
+					   grain);
+					frontier.clear();
+					for (auto const& part : found) {
+						frontier.insert(frontier.end(), part.cbegin(), part.cend());
+					}
+				}
+				std::erase_if(remaining, [&removed](std::size_t v) { return removed[v] != 0; });
+			}
+			return cores;
+		}
+	} // namespace detail
+
+	// Core number of every node of `g`, in the same order as g.nodes(): the largest k such that
+	// the node belongs to a subgraph in which every node has degree at least k, with degree
+	// measured as `degree` selects. Multi-edges count once and self-loops are ignored.
+	template<typename N, typename E>
+	auto core_numbers(graph<N, E> const& g,
+	                  core_degree degree = core_degree::total,
+	                  core_algorithm algorithm = core_algorithm::automatic)
+	   -> std::vector<std::size_t> {
+		constexpr auto parallel_threshold = std::size_t{1} << 16U;
+		auto structure = detail::make_peeling_structure(g.to_csr(), degree);
+		if (algorithm == core_algorithm::automatic) {
+			algorithm = structure.degrees.size() < parallel_threshold or max_threads() == 1U
+			               ? core_algorithm::bucket
+			               : core_algorithm::parallel;
+		}
+		if (algorithm == core_algorithm::bucket) {
+			return detail::bucket_cores(std::move(structure));
+		}
+		return detail::parallel_cores(structure);
+	}
+} // namespace gdwg
+
+#endif // GDWG_CORE_NUMBERS_HPP
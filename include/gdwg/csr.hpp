@@ -0,0 +1,113 @@
+#ifndef GDWG_CSR_HPP
+#define GDWG_CSR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace gdwg {
+	// A compressed sparse row snapshot of a graph, for algorithms that need contiguous adjacency.
+	// Node ids are positions in `nodes`, which is in the same order as graph<N, E>::nodes(). The
+	// out-edges of node u occupy [offsets[u], offsets[u + 1]) of `targets` and `weights`. Every
+	// weight of a multi-edge gets its own slot, and slots within a row are sorted by
+	// (target, weight).
+	template<typename N, typename E>
+	struct csr {
+		using size_type = std::size_t;
+
+		std::vector<N> nodes;
+		std::vector<size_type> offsets;
+		std::vector<size_type> targets;
+		std::vector<E> weights;
+
+		[[nodiscard]] auto node_count() const noexcept -> size_type {
+			return this->nodes.size();
+		}
+
+		[[nodiscard]] auto edge_count() const noexcept -> size_type {
+			return this->targets.size();
+		}
+
+		[[nodiscard]] auto degree(size_type u) const noexcept -> size_type {
+			return this->offsets[u + 1U] - this->offsets[u];
+		}
+
+		[[nodiscard]] auto neighbours(size_type u) const noexcept -> std::span<size_type const> {
+			return {this->targets.data() + this->offsets[u], this->degree(u)};
+		}
+
+		[[nodiscard]] auto edge_weights(size_type u) const noexcept -> std::span<E const> {
+			return {this->weights.data() + this->offsets[u], this->degree(u)};
+		}
+
+		[[nodiscard]] auto contains(N const& value) const -> bool {
+			auto itr = std::lower_bound(this->nodes.cbegin(), this->nodes.cend(), value);
+			return itr != this->nodes.cend() and not(value < *itr);
+		}
+
+		[[nodiscard]] auto index_of(N const& value) const -> size_type {
+			auto itr = std::lower_bound(this->nodes.cbegin(), this->nodes.cend(), value);
+			if (itr == this->nodes.cend() or value < *itr) {
+				throw std::out_of_range{"Node does not exist"};
+			}
+			return static_cast<size_type>(itr - this->nodes.cbegin());
+		}
+
+		// Returns the snapshot with each multi-edge reduced to a single slot holding its smallest
+		// weight, which is all that shortest-path style algorithms look at.
+		[[nodiscard]] auto lightest_edges() const -> csr {
+			auto result = csr{};
+			result.nodes = this->nodes;
+			result.offsets.reserve(this->offsets.size());
+			result.targets.reserve(this->edge_count());
+			result.weights.reserve(this->edge_count());
+			result.offsets.push_back(0U);
+			for (auto u = size_type{0}; u < this->node_count(); ++u) {
+				for (auto e = this->offsets[u]; e < this->offsets[u + 1U]; ++e) {
+					// Slots are sorted by weight within a target, so the first one is the lightest.
+					if (e == this->offsets[u] or this->targets[e] != this->targets[e - 1U]) {
+						result.targets.push_back(this->targets[e]);
+						result.weights.push_back(this->weights[e]);
+					}
+				}
+				result.offsets.push_back(result.targets.size());
+			}
+			return result;
+		}
+
+		// Returns the snapshot with every edge reversed, i.e. the in-edges of each node. Rows stay
+		// sorted by source.
+		[[nodiscard]] auto transpose() const -> csr {
+			auto result = csr{};
+			result.nodes = this->nodes;
+			result.offsets.assign(this->node_count() + 1U, 0U);
+			for (auto const v : this->targets) {
+				++result.offsets[v + 1U];
+			}
+			std::partial_sum(result.offsets.cbegin(), result.offsets.cend(), result.offsets.begin());
+
+			auto cursor =
+			   std::vector<size_type>(result.offsets.cbegin(), std::prev(result.offsets.cend()));
+			auto order = std::vector<size_type>(this->edge_count());
+			result.targets.resize(this->edge_count());
+			for (auto u = size_type{0}; u < this->node_count(); ++u) {
+				for (auto e = this->offsets[u]; e < this->offsets[u + 1U]; ++e) {
+					auto const slot = cursor[this->targets[e]]++;
+					result.targets[slot] = u;
+					order[slot] = e;
+				}
+			}
+			result.weights.reserve(this->edge_count());
+			for (auto const e : order) {
+				result.weights.push_back(this->weights[e]);
+			}
+			return result;
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_CSR_HPP
@@ -0,0 +1,70 @@
+#ifndef GDWG_DETAIL_DIJKSTRA_HPP
+#define GDWG_DETAIL_DIJKSTRA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace gdwg::detail {
+	// Single-source Dijkstra over any CSR-shaped adjacency (something with `offsets`, `targets`
+	// and non-negative `weights`). The distance array is kept between runs and only the entries a
+	// run touched are reset, so one search object can serve many sources cheaply. Unreachable
+	// nodes hold std::numeric_limits<E>::max().
+	template<typename E>
+	class dijkstra {
+	public:
+		static constexpr auto unreachable = std::numeric_limits<E>::max();
+
+		explicit dijkstra(std::size_t nodes)
+		: distances_(nodes, unreachable) {}
+
+		template<typename Adjacency>
+		auto run(Adjacency const& g, std::size_t source) -> std::span<E const> {
+			this->reset();
+			this->settle(source, E{0});
+			while (not this->heap_.empty()) {
+				std::pop_heap(this->heap_.begin(), this->heap_.end(), std::greater<>{});
+				auto const [d, u] = this->heap_.back();
+				this->heap_.pop_back();
+				if (d > this->distances_[u]) {
+					continue;
+				}
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					auto const candidate = static_cast<E>(d + g.weights[e]);
+					if (candidate < this->distances_[g.targets[e]]) {
+						this->settle(g.targets[e], candidate);
+					}
+				}
+			}
+			return this->distances_;
+		}
+
+	private:
+		std::vector<E> distances_;
+		std::vector<std::size_t> touched_;
+		std::vector<std::pair<E, std::size_t>> heap_;
+
+		auto settle(std::size_t v, E d) -> void {
+			if (this->distances_[v] == unreachable) {
+				this->touched_.push_back(v);
+			}
+			this->distances_[v] = d;
+			this->heap_.emplace_back(d, v);
+			std::push_heap(this->heap_.begin(), this->heap_.end(), std::greater<>{});
+		}
+
+		auto reset() -> void {
+			for (auto const v : this->touched_) {
+				this->distances_[v] = unreachable;
+			}
+			this->touched_.clear();
+			this->heap_.clear();
+		}
+	};
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_DIJKSTRA_HPP
@@ -0,0 +1,72 @@
+#ifndef GDWG_DETAIL_FLOW_NETWORK_HPP
+#define GDWG_DETAIL_FLOW_NETWORK_HPP
+
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+namespace gdwg::detail {
+	// An arc to be added to a flow_network.
+	template<typename C>
+	struct flow_arc {
+		std::size_t from;
+		std::size_t to;
+		C capacity;
+	};
+
+	// A residual graph in CSR form. Every input arc gets a forward slot holding its remaining
+	// capacity and a reverse slot in the row of its head holding the flow that can be cancelled,
+	// and `reverses` links each slot to its partner.
+	template<typename C>
+	struct flow_network {
+		std::vector<std::size_t> offsets;
+		std::vector<std::size_t> heads;
+		std::vector<std::size_t> reverses;
+		std::vector<C> residuals;
+		// The forward slot of every input arc, in input order.
+		std::vector<std::size_t> forward;
+
+		flow_network(std::size_t nodes, std::vector<flow_arc<C>> const& arcs)
+		: offsets(nodes + 1U, 0U)
+		, heads(2U * arcs.size())
+		, reverses(2U * arcs.size())
+		, residuals(2U * arcs.size())
+		, forward(arcs.size()) {
+			for (auto const& arc : arcs) {
+				++this->offsets[arc.from + 1U];
+				++this->offsets[arc.to + 1U];
+			}
+			std::partial_sum(this->offsets.cbegin(), this->offsets.cend(), this->offsets.begin());
+
+			auto cursor = std::vector<std::size_t>(this->offsets.cbegin(), this->offsets.cend() - 1);
+			for (auto i = std::size_t{0}; i < arcs.size(); ++i) {
+				auto const a = cursor[arcs[i].from]++;
+				auto const b = cursor[arcs[i].to]++;
+				this->heads[a] = arcs[i].to;
+				this->heads[b] = arcs[i].from;
+				this->reverses[a] = b;
+				this->reverses[b] = a;
+				this->residuals[a] = arcs[i].capacity;
+				this->residuals[b] = C{0};
+				this->forward[i] = a;
+			}
+		}
+
+		[[nodiscard]] auto node_count() const noexcept -> std::size_t {
+			return this->offsets.size() - 1U;
+		}
+
+		// Pushes `amount` along slot a.
+		auto push(std::size_t a, C amount) noexcept -> void {
+			this->residuals[a] -= amount;
+			this->residuals[this->reverses[a]] += amount;
+		}
+
+		// The flow carried by input arc i.
+		[[nodiscard]] auto flow(std::size_t i) const noexcept -> C {
+			return this->residuals[this->reverses[this->forward[i]]];
+		}
+	};
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_FLOW_NETWORK_HPP
@@ -0,0 +1,88 @@
+#ifndef GDWG_DETAIL_UNDIRECTED_HPP
+#define GDWG_DETAIL_UNDIRECTED_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace gdwg::detail {
+	// The simple undirected view of a graph: u and v are neighbours if there is an edge either
+	// way between them. Multi-edges, directions and self-loops are gone, and every row is sorted
+	// by node id.
+	struct undirected_adjacency {
+		std::vector<std::size_t> offsets;
+		std::vector<std::size_t> targets;
+
+		[[nodiscard]] auto node_count() const noexcept -> std::size_t {
+			return this->offsets.size() - 1U;
+		}
+
+		[[nodiscard]] auto degree(std::size_t u) const noexcept -> std::size_t {
+			return this->offsets[u + 1U] - this->offsets[u];
+		}
+
+		[[nodiscard]] auto neighbours(std::size_t u) const noexcept
+		   -> std::span<std::size_t const> {
+			return {this->targets.data() + this->offsets[u], this->degree(u)};
+		}
+	};
+
+	template<typename N, typename E>
+	auto make_undirected(csr<N, E> const& g) -> undirected_adjacency {
+		auto const n = g.node_count();
+		auto both = undirected_adjacency{};
+		both.offsets.assign(n + 1U, 0U);
+		for (auto u = std::size_t{0}; u < n; ++u) {
+			for (auto const v : g.neighbours(u)) {
+				if (v != u) {
+					++both.offsets[u + 1U];
+					++both.offsets[v + 1U];
+				}
+			}
+		}
+		std::partial_sum(both.offsets.cbegin(), both.offsets.cend(), both.offsets.begin());
+		auto cursor = std::vector<std::size_t>(both.offsets.cbegin(), std::prev(both.offsets.cend()));
+		both.targets.resize(both.offsets.back());
+		for (auto u = std::size_t{0}; u < n; ++u) {
+			for (auto const v : g.neighbours(u)) {
+				if (v != u) {
+					both.targets[cursor[u]++] = v;
+					both.targets[cursor[v]++] = u;
+				}
+			}
+		}
+
+		// Sort each row and squeeze out repeats in place, then compact the rows.
+		auto sizes = std::vector<std::size_t>(n + 1U, 0U);
+		parallel_edge_chunks(both.offsets, [&](std::size_t first, std::size_t last, std::size_t) {
+			for (auto u = first; u < last; ++u) {
+				auto const row = both.targets.begin() + static_cast<std::ptrdiff_t>(both.offsets[u]);
+				auto const end =
+				   both.targets.begin() + static_cast<std::ptrdiff_t>(both.offsets[u + 1U]);
+				std::sort(row, end);
+				sizes[u + 1U] = static_cast<std::size_t>(std::unique(row, end) - row);
+			}
+		});
+		auto result = undirected_adjacency{};
+		result.offsets.resize(n + 1U);
+		std::partial_sum(sizes.cbegin(), sizes.cend(), result.offsets.begin());
+		result.targets.resize(result.offsets.back());
+		parallel_chunks(0U, n, [&](std::size_t first, std::size_t last, std::size_t) {
+			for (auto u = first; u < last; ++u) {
+				auto const row = both.targets.cbegin() + static_cast<std::ptrdiff_t>(both.offsets[u]);
+				std::copy(row,
+				          row + static_cast<std::ptrdiff_t>(result.degree(u)),
+				          result.targets.begin() + static_cast<std::ptrdiff_t>(result.offsets[u]));
+			}
+		});
+		return result;
+	}
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_UNDIRECTED_HPP
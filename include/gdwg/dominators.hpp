@@ -0,0 +1,187 @@
+#ifndef GDWG_DOMINATORS_HPP
+#define GDWG_DOMINATORS_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	struct dominator_tree {
+		static constexpr auto unreached = std::numeric_limits<std::size_t>::max();
+
+		// Index (in node order) of each node's immediate dominator, or `unreached` for nodes the
+		// root cannot reach. The root is its own immediate dominator.
+		std::vector<std::size_t> idoms;
+		// Each node's interval in a preorder walk of the tree: a node's descendants are numbered
+		// in [enter, exit). Both are `unreached` for nodes outside the tree.
+		std::vector<std::size_t> enter;
+		std::vector<std::size_t> exit;
+
+		// Whether node `a` dominates node `b`, by index, in O(1). Every reached node dominates
+		// itself, and an unreached node dominates nothing and is dominated by nothing.
+		[[nodiscard]] auto dominates(std::size_t a, std::size_t b) const noexcept -> bool {
+			return this->enter[a] != unreached and this->enter[b] != unreached
+			       and this->enter[a] <= this->enter[b] and this->enter[b] < this->exit[a];
+		}
+	};
+
+	namespace detail {
+		// Semi-NCA after Georgiadis, Tarjan and Werneck. A depth-first search numbers the
+		// reachable nodes. Semidominators then come from Lengauer and Tarjan's link-eval forest
+		// with path compression, and each immediate dominator is the nearest common ancestor of
+		// the node's DFS parent and its semidominator, found by climbing the partial tree. The
+		// search and the compression both keep explicit stacks, so deep graphs cannot overflow
+		// the call stack.
+		template<typename N, typename E>
+		auto make_dominator_tree(csr<N, E> const& out, csr<N, E> const& in, std::size_t root)
+		   -> dominator_tree {
+			constexpr auto none = dominator_tree::unreached;
+			auto const n = out.node_count();
+
+			// Preorder numbering by an iterative depth-first search. `vertex` maps numbers back to
+			// nodes and `parent` holds the number of each node's DFS parent.
+			auto number = std::vector<std::size_t>(n, none);
+			auto vertex = std::vector<std::size_t>{};
+			auto parent = std::vector<std::size_t>{};
+			auto stack = std::vector<std::pair<std::size_t, std::size_t>>{};
+			number[root] = 0U;
+			vertex.push_back(root);
+			parent.push_back(0U);
+			stack.emplace_back(root, out.offsets[root]);
+			while (not stack.empty()) {
+				auto& [u, e] = stack.back();
+				if (e == out.offsets[u + 1U]) {
+					stack.pop_back();
+					continue;
+				}
+				auto const v = out.targets[e++];
+				if (number[v] == none) {
+					number[v] = vertex.size();
+					parent.push_back(number[u]);
+					vertex.push_back(v);
+					stack.emplace_back(v, out.offsets[v]);
+				}
+			}
+
+			// Semidominators, by number, in reverse preorder. eval(v) gives the node of least
+			// semidominator on the forest path up from v, compressing the path as it goes.
+			auto const reached = vertex.size();
+			auto semi = std::vector<std::size_t>(reached);
+			auto label = std::vector<std::size_t>(reached);
+			auto ancestor = std::vector<std::size_t>(reached, none);
+			std::iota(semi.begin(), semi.end(), std::size_t{0});
+			std::iota(label.begin(), label.end(), std::size_t{0});
+			auto path = std::vector<std::size_t>{};
+			auto const eval = [&](std::size_t v) {
+				if (ancestor[v] == none) {
+					return v;
+				}
+				for (auto x = v; ancestor[ancestor[x]] != none; x = ancestor[x]) {
+					path.push_back(x);
+				}
+				while (not path.empty()) {
+					auto const x = path.back();
+					path.pop_back();
+					auto const a = ancestor[x];
+					if (semi[label[a]] < semi[label[x]]) {
+						label[x] = label[a];
+					}
+					ancestor[x] = ancestor[a];
+				}
+				return label[v];
+			};
+			for (auto w = reached; w-- > 1U;) {
+				for (auto const p : in.neighbours(vertex[w])) {
+					if (number[p] != none) {
+						semi[w] = std::min(semi[w], semi[eval(number[p])]);
+					}
+				}
+				ancestor[w] = parent[w];
+			}
+
+			// Immediate dominators, by number, in preorder: climb from the DFS parent until the
+			// number is no larger than the semidominator.
+			auto idom = std::vector<std::size_t>(reached, 0U);
+			for (auto w = std::size_t{1}; w < reached; ++w) {
+				auto j = parent[w];
+				while (j > semi[w]) {
+					j = idom[j];
+				}
+				idom[w] = j;
+			}
+
+			auto tree = dominator_tree{};
+			tree.idoms.assign(n, none);
+			for (auto w = std::size_t{0}; w < reached; ++w) {
+				tree.idoms[vertex[w]] = vertex[idom[w]];
+			}
+
+			// Preorder intervals over the tree. Children are grouped by dominator with a counting
+			// sort, then walked with an explicit stack.
+			auto offsets = std::vector<std::size_t>(reached + 1U, 0U);
+			for (auto w = std::size_t{1}; w < reached; ++w) {
+				++offsets[idom[w] + 1U];
+			}
+			std::partial_sum(offsets.cbegin(), offsets.cend(), offsets.begin());
+			auto children = std::vector<std::size_t>(offsets.back());
+			auto cursor = offsets;
+			for (auto w = std::size_t{1}; w < reached; ++w) {
+				children[cursor[idom[w]]++] = w;
+			}
+			tree.enter.assign(n, none);
+			tree.exit.assign(n, none);
+			auto counter = std::size_t{0};
+			stack.clear();
+			stack.emplace_back(0U, offsets[0]);
+			tree.enter[root] = counter++;
+			while (not stack.empty()) {
+				auto& [w, c] = stack.back();
+				if (c == offsets[w + 1U]) {
+					tree.exit[vertex[w]] = counter;
+					stack.pop_back();
+					continue;
+				}
+				auto const child = children[c++];
+				tree.enter[vertex[child]] = counter++;
+				stack.emplace_back(child, offsets[child]);
+			}
+			return tree;
+		}
+	} // namespace detail
+
+	// The dominator tree of `g` from `root`: a node a dominates b if every path from root to b
+	// passes through a. Computed by semi-NCA in O(m log n) without recursion. Multi-edges and
+	// self-loops make no difference.
+	template<typename N, typename E>
+	auto dominators(graph<N, E> const& g, N const& root) -> dominator_tree {
+		if (not g.is_node(root)) {
+			throw std::runtime_error("Cannot call gdwg::dominators if root node doesn't exist in the "
+			                         "graph");
+		}
+		auto const out = g.to_csr();
+		return detail::make_dominator_tree(out, out.transpose(), out.index_of(root));
+	}
+
+	// The post-dominator tree of `g` towards `exit`: a node a post-dominates b if every path from
+	// b to exit passes through a. This is the dominator tree of the reversed graph, so nodes that
+	// cannot reach exit are left `unreached`.
+	template<typename N, typename E>
+	auto post_dominators(graph<N, E> const& g, N const& exit) -> dominator_tree {
+		if (not g.is_node(exit)) {
+			throw std::runtime_error("Cannot call gdwg::post_dominators if exit node doesn't exist "
+			                         "in the graph");
+		}
+		auto const out = g.to_csr();
+		auto const in = out.transpose();
+		return detail::make_dominator_tree(in, out, in.index_of(exit));
+	}
+} // namespace gdwg
+
+#endif // GDWG_DOMINATORS_HPP
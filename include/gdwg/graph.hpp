@@ -1,13 +1,19 @@
 #ifndef GDWG_GRAPH_HPP
 #define GDWG_GRAPH_HPP
 
+#include "gdwg/csr.hpp"
+
 #include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
+#include <stdexcept>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 namespace gdwg {
@@ -271,6 +277,36 @@ namespace gdwg {
 			});
 			return vec;
 		}
+		[[nodiscard]] auto to_csr() const -> csr<N, E> {
+			auto result = csr<N, E>{};
+			result.nodes = this->nodes();
+
+			auto ids = std::unordered_map<N const*, std::size_t>{};
+			ids.reserve(this->nodes_.size());
+			auto edges = std::size_t{0};
+			for (auto const& [src, destinations] : this->nodes_) {
+				ids.emplace(src.get(), ids.size());
+				for (auto const& [dst, weights] : destinations) {
+					edges += weights.size();
+				}
+			}
+
+			result.offsets.reserve(this->nodes_.size() + 1U);
+			result.targets.reserve(edges);
+			result.weights.reserve(edges);
+			result.offsets.push_back(0U);
+			for (auto const& [src, destinations] : this->nodes_) {
+				for (auto const& [dst, weights] : destinations) {
+					auto const id = ids.find(dst)->second;
+					for (auto const& w : weights) {
+						result.targets.push_back(id);
+						result.weights.push_back(*w);
+					}
+				}
+				result.offsets.push_back(result.targets.size());
+			}
+			return result;
+		}
 		auto begin() const noexcept -> iterator {
 			if (this->nodes_.size() == 0U) {
 				return iterator{this->nodes_.cend(),
@@ -0,0 +1,482 @@
+#ifndef GDWG_K_SHORTEST_PATHS_HPP
+#define GDWG_K_SHORTEST_PATHS_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <map>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// A path through the graph. `weights[i]` is the weight of the edge taken from `nodes[i]` to
+	// `nodes[i + 1]`, so two paths through the same nodes differ when they use different weights
+	// of a multi-edge.
+	template<typename N, typename E>
+	struct weighted_path {
+		E length;
+		std::vector<N> nodes;
+		std::vector<E> weights;
+
+		friend auto operator==(weighted_path const&, weighted_path const&) -> bool = default;
+	};
+
+	namespace detail {
+		// Shortest path searches from a spur node to a fixed target, guided by the exact distance
+		// from every node to the target in the unrestricted graph. That distance is a consistent
+		// A* potential, so once the search reaches a node whose shortest-path tree route to the
+		// target avoids everything blocked, following that route is optimal and the search stops.
+		// Off the blocked prefix of a path that is usually the first or second node settled.
+		// Only the entries a run touched are reset, as in detail::dijkstra.
+		template<typename N, typename E>
+		class spur_search {
+		public:
+			static constexpr auto unreached = std::numeric_limits<E>::max();
+			static constexpr auto no_edge = std::numeric_limits<std::size_t>::max();
+
+			spur_search(csr<N, E> const& g,
+			            std::vector<E> const& remaining,
+			            std::vector<std::size_t> const& tree)
+			: g_(g)
+			, remaining_(remaining)
+			, tree_(tree)
+			, distances_(g.node_count(), unreached)
+			, parents_(g.node_count(), no_edge)
+			, blocked_(g.node_count(), 0)
+			, states_(g.node_count(), unknown)
+			, positions_(g.node_count(), no_edge) {}
+
+			// Appends to `edges` the edge ids of a shortest loopless path from `source` to
+			// `target` that avoids `blocked_nodes` and leaves source by none of `blocked_edges`.
+			// Returns false, leaving `edges` alone, if there is no such path.
+			auto run(std::size_t source,
+			         std::size_t target,
+			         std::span<std::size_t const> blocked_nodes,
+			         std::span<std::size_t const> blocked_edges,
+			         std::vector<std::size_t>& edges) -> bool {
+				if (source == target) {
+					return true;
+				}
+				// Tree routes back through the source are treated as blocked too, so the route
+				// a search finishes along never returns to the spur node.
+				this->mark(source, dirty);
+				for (auto const v : blocked_nodes) {
+					this->blocked_[v] = 1;
+					this->mark(v, dirty);
+				}
+				this->mark(target, clean);
+				auto const start = edges.size();
+				auto const found = this->search(source, blocked_edges, edges);
+				for (auto const v : blocked_nodes) {
+					this->blocked_[v] = 0;
+				}
+				for (auto const v : this->checked_) {
+					this->states_[v] = unknown;
+				}
+				this->checked_.clear();
+				if (found) {
+					this->remove_loops(source, start, edges);
+				}
+				return found;
+			}
+
+		private:
+			static constexpr auto unknown = char{0};
+			static constexpr auto clean = char{1};
+			static constexpr auto dirty = char{2};
+
+			csr<N, E> const& g_;
+			// Distance from each node to the target, and the edge it takes first on the way.
+			std::vector<E> const& remaining_;
+			std::vector<std::size_t> const& tree_;
+			std::vector<E> distances_;
+			std::vector<std::size_t> parents_;
+			std::vector<std::size_t> touched_;
+			std::vector<std::pair<E, std::size_t>> heap_;
+			std::vector<char> blocked_;
+			// Whether each node's tree route avoids the blocked nodes, filled in lazily.
+			std::vector<char> states_;
+			std::vector<std::size_t> checked_;
+			std::vector<std::size_t> route_;
+			std::vector<std::size_t> positions_;
+
+			static auto is_blocked(std::span<std::size_t const> edges, std::size_t e) -> bool {
+				return std::find(edges.begin(), edges.end(), e) != edges.end();
+			}
+
+			auto mark(std::size_t v, char state) -> void {
+				this->states_[v] = state;
+				this->checked_.push_back(v);
+			}
+
+			[[nodiscard]] auto is_clean(std::size_t u) -> bool {
+				this->route_.clear();
+				auto v = u;
+				while (this->states_[v] == unknown) {
+					this->route_.push_back(v);
+					v = this->g_.targets[this->tree_[v]];
+				}
+				for (auto const w : this->route_) {
+					this->mark(w, this->states_[v]);
+				}
+				return this->states_[v] == clean;
+			}
+
+			// Whether a path can finish along `u`'s tree route.
+			[[nodiscard]] auto finishes(std::size_t u,
+			                            std::size_t source,
+			                            std::span<std::size_t const> blocked_edges) -> bool {
+				if (u != source) {
+					return this->is_clean(u);
+				}
+				auto const e = this->tree_[u];
+				return not is_blocked(blocked_edges, e) and this->is_clean(this->g_.targets[e]);
+			}
+
+			auto search(std::size_t source,
+			            std::span<std::size_t const> blocked_edges,
+			            std::vector<std::size_t>& edges) -> bool {
+				for (auto const v : this->touched_) {
+					this->distances_[v] = unreached;
+					this->parents_[v] = no_edge;
+				}
+				this->touched_.clear();
+				this->heap_.clear();
+				if (this->remaining_[source] == unreached) {
+					return false;
+				}
+				this->reach(source, E{0}, no_edge);
+				while (not this->heap_.empty()) {
+					std::pop_heap(this->heap_.begin(), this->heap_.end(), std::greater<>{});
+					auto const [estimate, u] = this->heap_.back();
+					this->heap_.pop_back();
+					auto const d = this->distances_[u];
+					if (estimate > static_cast<E>(d + this->remaining_[u])) {
+						continue;
+					}
+					if (this->finishes(u, source, blocked_edges)) {
+						auto const start = edges.size();
+						for (auto v = u; v != source; v = this->source_of(edges.back())) {
+							edges.push_back(this->parents_[v]);
+						}
+						std::reverse(edges.begin() + static_cast<std::ptrdiff_t>(start), edges.end());
+						for (auto v = u; this->tree_[v] != no_edge; v = this->g_.targets[edges.back()]) {
+							edges.push_back(this->tree_[v]);
+						}
+						return true;
+					}
+					for (auto e = this->g_.offsets[u]; e < this->g_.offsets[u + 1U]; ++e) {
+						auto const v = this->g_.targets[e];
+						if (this->remaining_[v] == unreached or v == source or this->blocked_[v] != 0
+						    or (u == source and is_blocked(blocked_edges, e)))
+						{
+							continue;
+						}
+						auto const candidate = static_cast<E>(d + this->g_.weights[e]);
+						if (candidate < this->distances_[v]) {
+							this->reach(v, candidate, e);
+						}
+					}
+				}
+				return false;
+			}
+
+			// Only paths through zero-weight cycles can meet their own tree route, and cutting
+			// such a cycle out leaves the length unchanged.
+			auto remove_loops(std::size_t source, std::size_t start, std::vector<std::size_t>& edges)
+			   -> void {
+				this->positions_[source] = start;
+				auto kept = start;
+				for (auto i = start; i < edges.size(); ++i) {
+					auto const v = this->g_.targets[edges[i]];
+					if (this->positions_[v] != no_edge) {
+						for (auto j = this->positions_[v]; j < kept; ++j) {
+							this->positions_[this->g_.targets[edges[j]]] = no_edge;
+						}
+						kept = this->positions_[v];
+					}
+					else {
+						edges[kept++] = edges[i];
+					}
+					this->positions_[v] = kept;
+				}
+				this->positions_[source] = no_edge;
+				for (auto i = start; i < kept; ++i) {
+					this->positions_[this->g_.targets[edges[i]]] = no_edge;
+				}
+				edges.resize(kept);
+			}
+
+			[[nodiscard]] auto source_of(std::size_t e) const -> std::size_t {
+				auto const itr =
+				   std::upper_bound(this->g_.offsets.cbegin(), this->g_.offsets.cend(), e);
+				return static_cast<std::size_t>(itr - this->g_.offsets.cbegin()) - 1U;
+			}
+
+			auto reach(std::size_t v, E d, std::size_t parent) -> void {
+				if (this->distances_[v] == unreached) {
+					this->touched_.push_back(v);
+				}
+				this->distances_[v] = d;
+				this->parents_[v] = parent;
+				this->heap_.emplace_back(static_cast<E>(d + this->remaining_[v]), v);
+				std::push_heap(this->heap_.begin(), this->heap_.end(), std::greater<>{});
+			}
+		};
+	} // namespace detail
+
+	// Enumerates the loopless paths from `src` to `dst` in order of increasing length, one per
+	// call to next(), using Yen's algorithm with Lawler's refinement. Every weight of a multi-edge
+	// counts as a separate parallel edge. Each path only generates its deviations when the
+	// following one is asked for, so a caller can stop at any point. The spur searches of one
+	// path run in parallel across std::thread workers. Paths of equal length come out in a fixed
+	// order. Weights must be arithmetic and non-negative.
+	//
+	// The enumerator holds a snapshot of the graph and does not watch it for changes.
+	template<typename N, typename E>
+	class loopless_paths {
+	public:
+		loopless_paths(graph<N, E> const& g, N const& src, N const& dst)
+		: g_(g.to_csr()) {
+			static_assert(std::is_arithmetic_v<E>, "gdwg::loopless_paths requires arithmetic weights");
+			if (not this->g_.contains(src) or not this->g_.contains(dst)) {
+				throw std::runtime_error("Cannot call gdwg::loopless_paths if src or dst node don't "
+				                         "exist in the graph");
+			}
+			if (std::any_of(this->g_.weights.cbegin(), this->g_.weights.cend(), [](E w) {
+				    return w < E{0};
+			    }))
+			{
+				throw std::runtime_error("Cannot call gdwg::loopless_paths on a graph with a negative "
+				                         "weight");
+			}
+			this->source_ = this->g_.index_of(src);
+			this->target_ = this->g_.index_of(dst);
+			this->build_tree();
+		}
+
+		// The next shortest loopless path, or std::nullopt once there are no more.
+		auto next() -> std::optional<weighted_path<N, E>> {
+			if (this->accepted_.empty()) {
+				this->seed();
+			}
+			else if (not this->expanded_) {
+				this->expand();
+			}
+			if (this->candidates_.empty()) {
+				return std::nullopt;
+			}
+			auto node = this->candidates_.extract(this->candidates_.begin());
+			this->accepted_.push_back({std::move(node.key().second), node.mapped()});
+			this->expanded_ = false;
+			return this->to_path(node.key().first, this->accepted_.back().edges);
+		}
+
+	private:
+		using search_type = detail::spur_search<N, E>;
+
+		struct accepted_path {
+			std::vector<std::size_t> edges;
+			// The first edge at which this path left the one it was found from.
+			std::size_t deviation;
+		};
+
+		// Spur searches refer to the snapshot of the enumerator that made them, so a copied or
+		// moved enumerator starts with none and builds its own on demand.
+		struct search_cache {
+			std::vector<search_type> searches;
+
+			search_cache() = default;
+			search_cache(search_cache const&) noexcept {}
+			search_cache(search_cache&&) noexcept {}
+			~search_cache() = default;
+
+			auto operator=(search_cache const&) noexcept -> search_cache& {
+				this->searches.clear();
+				return *this;
+			}
+
+			auto operator=(search_cache&&) noexcept -> search_cache& {
+				this->searches.clear();
+				return *this;
+			}
+		};
+
+		csr<N, E> g_;
+		std::size_t source_{0};
+		std::size_t target_{0};
+		std::vector<E> remaining_;
+		std::vector<std::size_t> tree_;
+		std::vector<accepted_path> accepted_;
+		// Candidates by (length, edges), each with its deviation index. Equal edge lists mean
+		// equal paths, so the map also drops duplicates.
+		std::map<std::pair<E, std::vector<std::size_t>>, std::size_t> candidates_;
+		bool expanded_{false};
+		search_cache searches_;
+
+		// Dijkstra from the target along reversed edges, giving every node its distance to the
+		// target and the first edge of a shortest path there. Taking any tight edge instead
+		// could cycle through zero-weight edges, so the search tree is kept.
+		auto build_tree() -> void {
+			auto const n = this->g_.node_count();
+			auto const reverse = this->g_.transpose();
+			auto next = std::vector<std::size_t>(n, search_type::no_edge);
+			this->remaining_.assign(n, search_type::unreached);
+			this->remaining_[this->target_] = E{0};
+			auto heap = std::vector<std::pair<E, std::size_t>>{{E{0}, this->target_}};
+			while (not heap.empty()) {
+				std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+				auto const [d, v] = heap.back();
+				heap.pop_back();
+				if (d > this->remaining_[v]) {
+					continue;
+				}
+				for (auto r = reverse.offsets[v]; r < reverse.offsets[v + 1U]; ++r) {
+					auto const u = reverse.targets[r];
+					auto const candidate = static_cast<E>(d + reverse.weights[r]);
+					if (candidate < this->remaining_[u]) {
+						this->remaining_[u] = candidate;
+						next[u] = v;
+						heap.emplace_back(candidate, u);
+						std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+					}
+				}
+			}
+			// Rows are sorted by (target, weight), so the first edge to `next` is the lightest.
+			this->tree_.assign(n, search_type::no_edge);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				if (next[u] != search_type::no_edge) {
+					auto const row = this->g_.neighbours(u);
+					auto const itr = std::lower_bound(row.begin(), row.end(), next[u]);
+					this->tree_[u] = this->g_.offsets[u] + static_cast<std::size_t>(itr - row.begin());
+				}
+			}
+		}
+
+		auto searches(std::size_t workers) -> std::vector<search_type>& {
+			auto& searches = this->searches_.searches;
+			while (searches.size() < workers) {
+				searches.emplace_back(this->g_, this->remaining_, this->tree_);
+			}
+			return searches;
+		}
+
+		auto seed() -> void {
+			auto edges = std::vector<std::size_t>{};
+			if (this->searches(1U).front().run(this->source_, this->target_, {}, {}, edges)) {
+				this->candidates_.emplace(std::pair{this->length(edges), std::move(edges)}, 0U);
+			}
+			this->expanded_ = true;
+		}
+
+		// Adds the deviations of the newest accepted path. Spurring at an edge before its own
+		// deviation would only repeat candidates its ancestors already produced.
+		auto expand() -> void {
+			auto const& last = this->accepted_.back();
+			auto const first = last.deviation;
+			auto const count = last.edges.size();
+			if (first >= count) {
+				this->expanded_ = true;
+				return;
+			}
+			auto const workers = detail::worker_count(count - first, 1U);
+			auto& searches = this->searches(workers);
+			auto found = std::vector<std::optional<std::vector<std::size_t>>>(count - first);
+			detail::parallel_for_dynamic(
+			   first,
+			   count,
+			   [&](std::size_t i, std::size_t worker) {
+				   found[i - first] = this->deviation(last.edges, i, searches[worker]);
+			   },
+			   1U,
+			   workers);
+			for (auto i = first; i < count; ++i) {
+				if (auto& edges = found[i - first]; edges.has_value()) {
+					auto const length = this->length(*edges);
+					auto const itr =
+					   this->candidates_.emplace(std::pair{length, std::move(*edges)}, i).first;
+					itr->second = std::min(itr->second, i);
+				}
+			}
+			this->expanded_ = true;
+		}
+
+		// The shortest path that shares the first `i` edges of `path` and then leaves every
+		// accepted path with that same prefix.
+		auto deviation(std::vector<std::size_t> const& path, std::size_t i, search_type& search) const
+		   -> std::optional<std::vector<std::size_t>> {
+			auto root_nodes = std::vector<std::size_t>{};
+			auto spur = this->source_;
+			for (auto j = std::size_t{0}; j < i; ++j) {
+				root_nodes.push_back(spur);
+				spur = this->g_.targets[path[j]];
+			}
+			auto blocked_edges = std::vector<std::size_t>{};
+			for (auto const& other : this->accepted_) {
+				if (other.edges.size() > i
+				    and std::equal(path.cbegin(),
+				                   path.cbegin() + static_cast<std::ptrdiff_t>(i),
+				                   other.edges.cbegin()))
+				{
+					blocked_edges.push_back(other.edges[i]);
+				}
+			}
+			auto edges = std::vector<std::size_t>(path.cbegin(),
+			                                      path.cbegin() + static_cast<std::ptrdiff_t>(i));
+			if (not search.run(spur, this->target_, root_nodes, blocked_edges, edges)) {
+				return std::nullopt;
+			}
+			return edges;
+		}
+
+		[[nodiscard]] auto length(std::vector<std::size_t> const& edges) const -> E {
+			auto total = E{0};
+			for (auto const e : edges) {
+				total = static_cast<E>(total + this->g_.weights[e]);
+			}
+			return total;
+		}
+
+		[[nodiscard]] auto to_path(E length, std::vector<std::size_t> const& edges) const
+		   -> weighted_path<N, E> {
+			auto result = weighted_path<N, E>{length, {this->g_.nodes[this->source_]}, {}};
+			for (auto const e : edges) {
+				result.nodes.push_back(this->g_.nodes[this->g_.targets[e]]);
+				result.weights.push_back(this->g_.weights[e]);
+			}
+			return result;
+		}
+	};
+
+	// Up to `k` shortest loopless paths from `src` to `dst`, shortest first, as given by
+	// loopless_paths.
+	template<typename N, typename E>
+	auto k_shortest_paths(graph<N, E> const& g, N const& src, N const& dst, std::size_t k)
+	   -> std::vector<weighted_path<N, E>> {
+		if (not g.is_node(src) or not g.is_node(dst)) {
+			throw std::runtime_error("Cannot call gdwg::k_shortest_paths if src or dst node don't "
+			                         "exist in the graph");
+		}
+		auto paths = loopless_paths<N, E>(g, src, dst);
+		auto result = std::vector<weighted_path<N, E>>{};
+		while (result.size() < k) {
+			auto path = paths.next();
+			if (not path.has_value()) {
+				break;
+			}
+			result.push_back(std::move(*path));
+		}
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_K_SHORTEST_PATHS_HPP
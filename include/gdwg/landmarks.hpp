@@ -0,0 +1,471 @@
+#ifndef GDWG_LANDMARKS_HPP
+#define GDWG_LANDMARKS_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/detail/dijkstra.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// How landmark_oracle picks its landmarks. `farthest` repeatedly takes the node farthest
+	// from the landmarks chosen so far. `avoid` follows Goldberg and Werneck: it grows a
+	// shortest-path tree from a random root and walks down to the subtree whose distances the
+	// current landmarks bound worst. `avoid` usually gives tighter bounds for the same count.
+	enum class landmark_selection { farthest, avoid };
+
+	struct landmark_options {
+		// Landmarks to choose, capped at the number of nodes. Each one costs two distances per
+		// node of memory and O(1) per bound.
+		std::size_t count = 16;
+		landmark_selection selection = landmark_selection::avoid;
+		std::mt19937::result_type seed = std::mt19937::default_seed;
+	};
+
+	namespace detail {
+		// A full shortest-path tree: distances, the parent each node was last reached from, and
+		// the order nodes were settled in. Unreachable nodes hold std::numeric_limits<E>::max()
+		// and are not in `order`.
+		template<typename E>
+		struct shortest_path_tree {
+			std::vector<E> distances;
+			std::vector<std::size_t> parents;
+			std::vector<std::size_t> order;
+		};
+
+		template<typename N, typename E>
+		auto make_shortest_path_tree(csr<N, E> const& g, std::size_t root)
+		   -> shortest_path_tree<E> {
+			constexpr auto unreachable = std::numeric_limits<E>::max();
+			auto const n = g.node_count();
+			auto tree = shortest_path_tree<E>{std::vector<E>(n, unreachable),
+			                                  std::vector<std::size_t>(n, root),
+			                                  {}};
+			auto settled = std::vector<char>(n, 0);
+			auto heap = std::vector<std::pair<E, std::size_t>>{{E{0}, root}};
+			tree.distances[root] = E{0};
+			while (not heap.empty()) {
+				std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+				auto const [d, u] = heap.back();
+				heap.pop_back();
+				if (settled[u] != 0) {
+					continue;
+				}
+				settled[u] = 1;
+				tree.order.push_back(u);
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					auto const v = g.targets[e];
+					auto const candidate = static_cast<E>(d + g.weights[e]);
+					if (settled[v] == 0 and candidate < tree.distances[v]) {
+						tree.distances[v] = candidate;
+						tree.parents[v] = u;
+						heap.emplace_back(candidate, v);
+						std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+					}
+				}
+			}
+			return tree;
+		}
+
+		// Chooses landmarks one at a time and returns them with the distance from each to every
+		// node, landmark by landmark. Every choice depends on the tables of the earlier ones, so
+		// this part runs serially.
+		template<typename N, typename E>
+		class landmark_chooser {
+		public:
+			static constexpr auto unreachable = std::numeric_limits<E>::max();
+
+			landmark_chooser(csr<N, E> const& g, landmark_options const& options)
+			: g_(&g)
+			, options_(options)
+			, engine_(options.seed)
+			, closest_(g.node_count(), unreachable)
+			, chosen_(g.node_count(), 0) {}
+
+			auto run() -> std::pair<std::vector<std::size_t>, std::vector<std::vector<E>>> {
+				auto const n = this->g_->node_count();
+				auto const count = std::min(this->options_.count, n);
+				auto pick = std::uniform_int_distribution<std::size_t>{0U, n == 0U ? 0U : n - 1U};
+				while (this->landmarks_.size() < count) {
+					// Only the avoid heuristic and the first farthest landmark need a tree, which
+					// costs a search over the whole graph.
+					if (this->options_.selection == landmark_selection::farthest
+					    and not this->landmarks_.empty())
+					{
+						this->add(this->farthest());
+						continue;
+					}
+					auto const root = pick(this->engine_);
+					auto const tree = make_shortest_path_tree(*this->g_, root);
+					// The first landmark is the node farthest from the root.
+					auto const next = this->options_.selection == landmark_selection::avoid
+					                     ? this->avoid(tree)
+					                     : tree.order.back();
+					this->add(this->chosen_[next] != 0 ? this->farthest() : next);
+				}
+				return {std::move(this->landmarks_), std::move(this->distances_)};
+			}
+
+		private:
+			csr<N, E> const* g_;
+			landmark_options options_;
+			std::mt19937 engine_;
+			// The smallest distance from any landmark to each node.
+			std::vector<E> closest_;
+			std::vector<char> chosen_;
+			std::vector<std::size_t> landmarks_;
+			std::vector<std::vector<E>> distances_;
+
+			auto add(std::size_t landmark) -> void {
+				auto search = dijkstra<E>(this->g_->node_count());
+				auto const distances = search.run(*this->g_, landmark);
+				for (auto v = std::size_t{0}; v < distances.size(); ++v) {
+					this->closest_[v] = std::min(this->closest_[v], distances[v]);
+				}
+				this->chosen_[landmark] = 1;
+				this->landmarks_.push_back(landmark);
+				this->distances_.emplace_back(distances.begin(), distances.end());
+			}
+
+			// The node farthest from every landmark so far, where a node no landmark reaches
+			// counts as farthest of all.
+			auto farthest() const -> std::size_t {
+				auto best = std::size_t{0};
+				for (auto v = std::size_t{0}; v < this->closest_.size(); ++v) {
+					if (this->chosen_[v] == 0
+					    and (this->chosen_[best] != 0 or this->closest_[v] > this->closest_[best]))
+					{
+						best = v;
+					}
+				}
+				return best;
+			}
+
+			// Goldberg and Werneck's avoid heuristic. Each node of the tree weighs the gap between
+			// its distance from the root and the best lower bound the landmarks give for it, and a
+			// subtree weighs the sum of its nodes, or nothing if it holds a landmark. Starting at
+			// the root, the walk keeps stepping into the heaviest subtree, and the leaf it ends at
+			// is the new landmark.
+			auto avoid(shortest_path_tree<E> const& tree) const -> std::size_t {
+				auto const n = this->g_->node_count();
+				auto const root = tree.order.front();
+				auto sizes = std::vector<double>(n, 0.0);
+				auto covered = std::vector<char>(n, 0);
+				for (auto const v : tree.order) {
+					auto bound = E{0};
+					for (auto const& row : this->distances_) {
+						if (row[root] != unreachable and row[v] != unreachable and row[v] > row[root]) {
+							bound = std::max(bound, static_cast<E>(row[v] - row[root]));
+						}
+					}
+					sizes[v] = std::max(0.0, static_cast<double>(tree.distances[v] - bound));
+					covered[v] = this->chosen_[v];
+				}
+				for (auto i = tree.order.size(); i-- > 1U;) {
+					auto const v = tree.order[i];
+					auto const parent = tree.parents[v];
+					sizes[parent] += sizes[v];
+					covered[parent] = covered[parent] != 0 ? covered[parent] : covered[v];
+				}
+				auto best_child = std::vector<std::size_t>(n, n);
+				for (auto i = std::size_t{1}; i < tree.order.size(); ++i) {
+					auto const v = tree.order[i];
+					auto const parent = tree.parents[v];
+					if (covered[v] == 0 and sizes[v] > 0.0
+					    and (best_child[parent] == n or sizes[v] > sizes[best_child[parent]]))
+					{
+						best_child[parent] = v;
+					}
+				}
+				auto u = root;
+				while (best_child[u] != n) {
+					u = best_child[u];
+				}
+				return u;
+			}
+		};
+	} // namespace detail
+
+	// Precomputed distances between every node of `g` and a few landmarks, which give lower and
+	// upper bounds on any distance in O(k) for k landmarks, by the triangle inequality. The lower
+	// bound is admissible, so it also serves as an A* heuristic, and query runs A* with it (the
+	// ALT algorithm). Each multi-edge contributes its minimum weight. Weights must be arithmetic
+	// and non-negative.
+	//
+	// Landmarks are chosen serially as `options.selection` describes. The distances from each
+	// landmark come out of that choice, and the distances to each landmark are then found in
+	// parallel over the reversed graph. Both tables are stored node by node, so a bound reads two
+	// contiguous rows of k entries.
+	template<typename N, typename E>
+	class landmark_oracle {
+	public:
+		using size_type = std::size_t;
+
+		explicit landmark_oracle(graph<N, E> const& g, landmark_options const& options = {}) {
+			static_assert(std::is_arithmetic_v<E>,
+			              "gdwg::landmark_oracle requires arithmetic weights");
+			this->adjacency_ = g.to_csr().lightest_edges();
+			auto const& weights = this->adjacency_.weights;
+			if (std::any_of(weights.cbegin(), weights.cend(), [](E w) { return w < E{0}; })) {
+				throw std::runtime_error("Cannot call gdwg::landmark_oracle on a graph with a "
+				                         "negative weight");
+			}
+			auto [landmarks, from] =
+			   detail::landmark_chooser<N, E>(this->adjacency_, options).run();
+			this->landmarks_ = std::move(landmarks);
+			auto const n = this->adjacency_.node_count();
+			auto const k = this->landmarks_.size();
+			this->from_.resize(n * k);
+			this->to_.resize(n * k);
+			for (auto i = size_type{0}; i < k; ++i) {
+				for (auto v = size_type{0}; v < n; ++v) {
+					this->from_[v * k + i] = from[i][v];
+				}
+			}
+
+			auto const reversed = this->adjacency_.transpose();
+			auto const workers = detail::worker_count(k, 1U);
+			auto searches = std::vector<detail::dijkstra<E>>(workers, detail::dijkstra<E>(n));
+			detail::parallel_for_dynamic(
+			   0U,
+			   k,
+			   [&](size_type i, size_type worker) {
+				   auto const distances = searches[worker].run(reversed, this->landmarks_[i]);
+				   for (auto v = size_type{0}; v < n; ++v) {
+					   this->to_[v * k + i] = distances[v];
+				   }
+			   },
+			   1U,
+			   workers);
+		}
+
+		[[nodiscard]] auto nodes() const noexcept -> std::vector<N> const& {
+			return this->adjacency_.nodes;
+		}
+
+		// The chosen landmarks, in the order they were picked.
+		[[nodiscard]] auto landmarks() const -> std::vector<N> {
+			auto result = std::vector<N>{};
+			result.reserve(this->landmarks_.size());
+			for (auto const v : this->landmarks_) {
+				result.push_back(this->adjacency_.nodes[v]);
+			}
+			return result;
+		}
+
+		// A lower bound on the distance from `src` to `dst`. It is
+		// std::numeric_limits<E>::max() if the tables prove that dst is unreachable from src.
+		[[nodiscard]] auto lower_bound(N const& src, N const& dst) const -> E {
+			auto const [s, t] = this->endpoints(src, dst, "lower_bound");
+			return this->bound_below(s, t);
+		}
+
+		// An upper bound on the distance from `src` to `dst`: the shortest route through a
+		// single landmark. std::nullopt if no landmark lies on a route from src to dst.
+		[[nodiscard]] auto upper_bound(N const& src, N const& dst) const -> std::optional<E> {
+			auto const [s, t] = this->endpoints(src, dst, "upper_bound");
+			if (s == t) {
+				return E{0};
+			}
+			auto const k = this->landmarks_.size();
+			auto const* const to = this->to_.data() + s * k;
+			auto const* const from = this->from_.data() + t * k;
+			auto best = std::optional<E>{};
+			for (auto i = size_type{0}; i < k; ++i) {
+				if (to[i] != unreachable and from[i] != unreachable) {
+					auto const through = static_cast<E>(to[i] + from[i]);
+					best = best.has_value() ? std::min(*best, through) : through;
+				}
+			}
+			return best;
+		}
+
+		// Reusable search state for A* queries against one oracle. Constructing it allocates
+		// O(V), after which each query only touches the nodes it reaches. A query object is not
+		// thread-safe, but any number of them can share an oracle.
+		class query {
+		public:
+			explicit query(landmark_oracle const& oracle)
+			: oracle_{oracle}
+			, distances_(oracle.adjacency_.node_count(), unreachable)
+			, estimates_(oracle.adjacency_.node_count(), unreachable)
+			, parents_(oracle.adjacency_.node_count(), 0U) {}
+
+			// Shortest distance from `src` to `dst`, or std::nullopt if dst is unreachable.
+			[[nodiscard]] auto distance(N const& src, N const& dst) -> std::optional<E> {
+				auto const [s, t] = this->oracle_.endpoints(src, dst, "query::distance");
+				if (not this->search(s, t)) {
+					return std::nullopt;
+				}
+				return this->distances_[t];
+			}
+
+			// The nodes of a shortest path from `src` to `dst`, both included. Empty if dst is
+			// unreachable.
+			[[nodiscard]] auto path(N const& src, N const& dst) -> std::vector<N> {
+				auto const [s, t] = this->oracle_.endpoints(src, dst, "query::path");
+				if (not this->search(s, t)) {
+					return {};
+				}
+				auto result = std::vector<N>{};
+				for (auto v = t; v != s; v = this->parents_[v]) {
+					result.push_back(this->oracle_.adjacency_.nodes[v]);
+				}
+				result.push_back(this->oracle_.adjacency_.nodes[s]);
+				std::reverse(result.begin(), result.end());
+				return result;
+			}
+
+			// Number of nodes the last query settled.
+			[[nodiscard]] auto settled() const noexcept -> size_type {
+				return this->settled_;
+			}
+
+		private:
+			landmark_oracle const& oracle_;
+			std::vector<E> distances_;
+			// The lower bound from each node to the current target, once it is reached.
+			std::vector<E> estimates_;
+			std::vector<size_type> parents_;
+			std::vector<size_type> touched_;
+			std::vector<std::pair<E, size_type>> heap_;
+			size_type settled_{0};
+
+			auto reset() -> void {
+				for (auto const v : this->touched_) {
+					this->distances_[v] = unreachable;
+					this->estimates_[v] = unreachable;
+				}
+				this->touched_.clear();
+				this->heap_.clear();
+				this->settled_ = 0U;
+			}
+
+			// Reaches v at distance d unless the tables prove t unreachable from it.
+			auto reach(size_type v, E d, size_type parent, size_type t) -> void {
+				if (this->distances_[v] == unreachable) {
+					this->estimates_[v] = this->oracle_.bound_below(v, t);
+					this->touched_.push_back(v);
+				}
+				if (this->estimates_[v] == unreachable) {
+					return;
+				}
+				this->distances_[v] = d;
+				this->parents_[v] = parent;
+				this->heap_.emplace_back(static_cast<E>(d + this->estimates_[v]), v);
+				std::push_heap(this->heap_.begin(), this->heap_.end(), std::greater<>{});
+			}
+
+			// A* from s, ordered by distance plus lower bound. Stops when t is settled, and
+			// returns whether it was.
+			auto search(size_type s, size_type t) -> bool {
+				this->reset();
+				auto const& g = this->oracle_.adjacency_;
+				this->reach(s, E{0}, s, t);
+				while (not this->heap_.empty()) {
+					std::pop_heap(this->heap_.begin(), this->heap_.end(), std::greater<>{});
+					auto const [key, u] = this->heap_.back();
+					this->heap_.pop_back();
+					auto const d = this->distances_[u];
+					if (key > static_cast<E>(d + this->estimates_[u])) {
+						continue;
+					}
+					++this->settled_;
+					if (u == t) {
+						return true;
+					}
+					for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+						auto const v = g.targets[e];
+						auto const candidate = static_cast<E>(d + g.weights[e]);
+						if (candidate < this->distances_[v]) {
+							this->reach(v, candidate, u, t);
+						}
+					}
+				}
+				return false;
+			}
+		};
+
+		// Shortest distance from `src` to `dst`, or std::nullopt if dst is unreachable. Allocates
+		// a fresh query each time; hold a query object for repeated calls.
+		[[nodiscard]] auto distance(N const& src, N const& dst) const -> std::optional<E> {
+			return query(*this).distance(src, dst);
+		}
+
+		// The nodes of a shortest path from `src` to `dst`, as query::path.
+		[[nodiscard]] auto path(N const& src, N const& dst) const -> std::vector<N> {
+			return query(*this).path(src, dst);
+		}
+
+	private:
+		static constexpr auto unreachable = std::numeric_limits<E>::max();
+
+		csr<N, E> adjacency_;
+		std::vector<size_type> landmarks_;
+		// Distance from each landmark to each node, and from each node to each landmark, with
+		// the k landmarks of one node stored together.
+		std::vector<E> from_;
+		std::vector<E> to_;
+
+		// The best of d(L, t) - d(L, s) and d(s, L) - d(t, L) over every landmark L. When d(L, s)
+		// is finite but d(L, t) is not, or d(t, L) is finite but d(s, L) is not, t cannot be
+		// reachable from s.
+		[[nodiscard]] auto bound_below(size_type s, size_type t) const noexcept -> E {
+			auto const k = this->landmarks_.size();
+			auto const* const from_s = this->from_.data() + s * k;
+			auto const* const from_t = this->from_.data() + t * k;
+			auto const* const to_s = this->to_.data() + s * k;
+			auto const* const to_t = this->to_.data() + t * k;
+			auto best = E{0};
+			for (auto i = size_type{0}; i < k; ++i) {
+				if (from_s[i] != unreachable) {
+					if (from_t[i] == unreachable) {
+						return unreachable;
+					}
+					best = from_t[i] > from_s[i] ? std::max(best, static_cast<E>(from_t[i] - from_s[i]))
+					                             : best;
+				}
+				if (to_t[i] != unreachable) {
+					if (to_s[i] == unreachable) {
+						return unreachable;
+					}
+					best = to_s[i] > to_t[i] ? std::max(best, static_cast<E>(to_s[i] - to_t[i])) : best;
+				}
+			}
+			return best;
+		}
+
+		[[nodiscard]] auto index_of(N const& value) const -> size_type {
+			auto const& nodes = this->adjacency_.nodes;
+			auto const itr = std::lower_bound(nodes.cbegin(), nodes.cend(), value);
+			if (itr == nodes.cend() or value < *itr) {
+				return nodes.size();
+			}
+			return static_cast<size_type>(itr - nodes.cbegin());
+		}
+
+		[[nodiscard]] auto endpoints(N const& src, N const& dst, char const* caller) const
+		   -> std::pair<size_type, size_type> {
+			auto const s = this->index_of(src);
+			auto const t = this->index_of(dst);
+			if (s == this->adjacency_.node_count() or t == this->adjacency_.node_count()) {
+				throw std::runtime_error(std::string("Cannot call gdwg::landmark_oracle<N, E>::")
+				                         + caller + " if src or dst node don't exist in the graph");
+			}
+			return {s, t};
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_LANDMARKS_HPP
@@ -0,0 +1,323 @@
+#ifndef GDWG_MAX_FLOW_HPP
+#define GDWG_MAX_FLOW_HPP
+
+#include "gdwg/detail/flow_network.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace gdwg {
+	template<typename N, typename E>
+	struct max_flow_result {
+		// Total flow from the source to the sink.
+		E value;
+		// The flow on every edge between distinct nodes, in graph order. The capacities of a
+		// multi-edge are summed, so each connected (src, dst) pair appears once.
+		std::vector<typename graph<N, E>::value_type> flows;
+		// Nodes on the source side of a minimum cut, in node order. Every edge leaving this set is
+		// saturated, and their capacities add up to `value`.
+		std::vector<N> source_side;
+	};
+
+	namespace detail {
+		// Highest-label push-relabel over a flow_network, turning it into a maximum flow from
+		// `source` to `sink`. Heights below n estimate the distance to the sink and heights from n
+		// upwards the distance back to the source, so a single phase both saturates a minimum cut
+		// and returns the excess that cannot cross it. Two heuristics keep relabelling cheap: a
+		// gap (an empty height below n) lifts every node above it out of the sink's reach at once,
+		// and a global relabel recomputes exact heights by BFS after a linear amount of work.
+		template<typename C>
+		class push_relabel {
+		public:
+			push_relabel(flow_network<C>& network, std::size_t source, std::size_t sink)
+			: network_{network}
+			, n_{network.node_count()}
+			, source_{source}
+			, sink_{sink}
+			, heights_(n_, 0U)
+			, excess_(n_, C{0})
+			, current_(network.offsets.cbegin(), network.offsets.cend() - 1)
+			, active_(2U * n_ + 1U)
+			, members_(n_)
+			, member_slot_(n_, 0U) {}
+
+			// Runs to completion and returns the value of the flow.
+			auto run() -> C {
+				for (auto a = this->network_.offsets[this->source_];
+				     a < this->network_.offsets[this->source_ + 1U];
+				     ++a)
+				{
+					auto const amount = this->network_.residuals[a];
+					if (amount > C{0}) {
+						this->network_.push(a, amount);
+						this->excess_[this->network_.heads[a]] += amount;
+						this->excess_[this->source_] -= amount;
+					}
+				}
+				this->global_relabel();
+
+				auto const budget = 6U * this->n_ + this->network_.heads.size();
+				while (true) {
+					while (this->highest_ > 0U and this->active_[this->highest_].empty()) {
+						--this->highest_;
+					}
+					if (this->active_[this->highest_].empty()) {
+						break;
+					}
+					auto const v = this->active_[this->highest_].back();
+					this->active_[this->highest_].pop_back();
+					// Entries are left behind when a node is lifted or drained, so skip stale ones.
+					if (this->heights_[v] != this->highest_ or not(this->excess_[v] > C{0})) {
+						continue;
+					}
+					this->discharge(v);
+					if (this->work_ > budget) {
+						this->global_relabel();
+					}
+				}
+				return this->excess_[this->sink_];
+			}
+
+		private:
+			flow_network<C>& network_;
+			std::size_t n_;
+			std::size_t source_;
+			std::size_t sink_;
+			std::vector<std::size_t> heights_;
+			std::vector<C> excess_;
+			// The next slot to try in each row.
+			std::vector<std::size_t> current_;
+			// Nodes with excess, bucketed by height.
+			std::vector<std::vector<std::size_t>> active_;
+			std::size_t highest_{0U};
+			// All nodes below height n other than the sink, bucketed by height, for the gap
+			// heuristic.
+			std::vector<std::vector<std::size_t>> members_;
+			std::vector<std::size_t> member_slot_;
+			std::size_t top_member_{0U};
+			std::size_t work_{0U};
+
+			[[nodiscard]] auto unreachable() const noexcept -> std::size_t {
+				return 2U * this->n_;
+			}
+
+			auto activate(std::size_t v) -> void {
+				this->active_[this->heights_[v]].push_back(v);
+				this->highest_ = std::max(this->highest_, this->heights_[v]);
+			}
+
+			auto add_member(std::size_t v) -> void {
+				auto const h = this->heights_[v];
+				this->member_slot_[v] = this->members_[h].size();
+				this->members_[h].push_back(v);
+				this->top_member_ = std::max(this->top_member_, h);
+			}
+
+			auto remove_member(std::size_t v) -> void {
+				auto& bucket = this->members_[this->heights_[v]];
+				auto const moved = bucket.back();
+				bucket[this->member_slot_[v]] = moved;
+				this->member_slot_[moved] = this->member_slot_[v];
+				bucket.pop_back();
+			}
+
+			auto discharge(std::size_t v) -> void {
+				auto const last = this->network_.offsets[v + 1U];
+				for (auto& a = this->current_[v]; a < last; ++a) {
+					auto const w = this->network_.heads[a];
+					if (not(this->network_.residuals[a] > C{0})
+					    or this->heights_[v] != this->heights_[w] + 1U)
+					{
+						continue;
+					}
+					auto const amount = std::min(this->excess_[v], this->network_.residuals[a]);
+					if (not(this->excess_[w] > C{0}) and w != this->source_ and w != this->sink_) {
+						this->excess_[w] += amount;
+						this->activate(w);
+					}
+					else {
+						this->excess_[w] += amount;
+					}
+					this->network_.push(a, amount);
+					this->excess_[v] -= amount;
+					if (not(this->excess_[v] > C{0})) {
+						return;
+					}
+				}
+				this->relabel(v);
+			}
+
+			auto relabel(std::size_t v) -> void {
+				auto lowest = this->unreachable();
+				auto const first = this->network_.offsets[v];
+				auto const last = this->network_.offsets[v + 1U];
+				for (auto a = first; a < last; ++a) {
+					if (this->network_.residuals[a] > C{0}) {
+						lowest = std::min(lowest, this->heights_[this->network_.heads[a]]);
+					}
+				}
+				this->work_ += last - first + 12U;
+
+				auto const old = this->heights_[v];
+				auto height = std::min(lowest + 1U, this->unreachable());
+				if (old < this->n_) {
+					this->remove_member(v);
+					if (this->members_[old].empty()) {
+						this->gap(old);
+						height = std::max(height, this->n_ + 1U);
+					}
+				}
+				this->heights_[v] = height;
+				this->current_[v] = first;
+				if (height < this->n_) {
+					this->add_member(v);
+				}
+				if (height < this->unreachable()) {
+					this->activate(v);
+				}
+			}
+
+			// No node is left at height `empty`, so nothing above it can reach the sink any more.
+			auto gap(std::size_t empty) -> void {
+				for (auto h = empty + 1U; h <= this->top_member_; ++h) {
+					for (auto const u : this->members_[h]) {
+						this->heights_[u] = this->n_ + 1U;
+						this->current_[u] = this->network_.offsets[u];
+						if (this->excess_[u] > C{0}) {
+							this->activate(u);
+						}
+					}
+					this->members_[h].clear();
+				}
+				this->top_member_ = empty;
+			}
+
+			// Sets every height to the exact residual distance to the sink, or to n plus the
+			// distance to the source for nodes that cannot reach the sink.
+			auto global_relabel() -> void {
+				std::fill(this->heights_.begin(), this->heights_.end(), this->unreachable());
+				auto const search = [this](std::size_t root, std::size_t height) {
+					this->heights_[root] = height;
+					auto queue = std::deque<std::size_t>{root};
+					while (not queue.empty()) {
+						auto const v = queue.front();
+						queue.pop_front();
+						for (auto a = this->network_.offsets[v]; a < this->network_.offsets[v + 1U];
+						     ++a)
+						{
+							auto const w = this->network_.heads[a];
+							if (this->heights_[w] == this->unreachable()
+							    and this->network_.residuals[this->network_.reverses[a]] > C{0})
+							{
+								this->heights_[w] = this->heights_[v] + 1U;
+								queue.push_back(w);
+							}
+						}
+					}
+				};
+				this->heights_[this->source_] = this->n_;
+				search(this->sink_, 0U);
+				search(this->source_, this->n_);
+
+				for (auto& bucket : this->active_) {
+					bucket.clear();
+				}
+				for (auto& bucket : this->members_) {
+					bucket.clear();
+				}
+				this->highest_ = 0U;
+				this->top_member_ = 0U;
+				this->work_ = 0U;
+				for (auto u = std::size_t{0}; u < this->n_; ++u) {
+					this->current_[u] = this->network_.offsets[u];
+					if (u == this->source_ or u == this->sink_) {
+						continue;
+					}
+					if (this->heights_[u] < this->n_) {
+						this->add_member(u);
+					}
+					if (this->heights_[u] < this->unreachable() and this->excess_[u] > C{0}) {
+						this->activate(u);
+					}
+				}
+			}
+		};
+	} // namespace detail
+
+	// A maximum flow from `source` to `sink` that treats edge weights as capacities, together with
+	// a minimum cut. The capacities of a multi-edge are summed and self-loops are ignored. Uses
+	// highest-label push-relabel with the gap and global relabelling heuristics on a compact
+	// residual graph built once from a CSR snapshot.
+	template<typename N, typename E>
+	auto max_flow(graph<N, E> const& g, N const& source, N const& sink) -> max_flow_result<N, E> {
+		static_assert(std::is_arithmetic_v<E>, "gdwg::max_flow requires arithmetic capacities");
+		if (not(g.is_node(source) and g.is_node(sink))) {
+			throw std::runtime_error("Cannot call gdwg::max_flow if source or sink node don't exist "
+			                         "in the graph");
+		}
+		auto const adjacency = g.to_csr();
+		auto const s = adjacency.index_of(source);
+		auto const t = adjacency.index_of(sink);
+		if (s == t) {
+			throw std::runtime_error("Cannot call gdwg::max_flow when source and sink are the same "
+			                         "node");
+		}
+
+		auto arcs = std::vector<detail::flow_arc<E>>{};
+		for (auto u = std::size_t{0}; u < adjacency.node_count(); ++u) {
+			for (auto e = adjacency.offsets[u]; e < adjacency.offsets[u + 1U]; ++e) {
+				auto const v = adjacency.targets[e];
+				if (adjacency.weights[e] < E{0}) {
+					throw std::runtime_error("Cannot call gdwg::max_flow on a graph with a negative "
+					                         "capacity");
+				}
+				if (v == u) {
+					continue;
+				}
+				if (arcs.empty() or arcs.back().from != u or arcs.back().to != v) {
+					arcs.push_back({u, v, adjacency.weights[e]});
+				}
+				else {
+					arcs.back().capacity += adjacency.weights[e];
+				}
+			}
+		}
+
+		auto network = detail::flow_network<E>(adjacency.node_count(), arcs);
+		auto result = max_flow_result<N, E>{};
+		result.value = detail::push_relabel<E>(network, s, t).run();
+		result.flows.reserve(arcs.size());
+		for (auto i = std::size_t{0}; i < arcs.size(); ++i) {
+			result.flows.push_back(
+			   {adjacency.nodes[arcs[i].from], adjacency.nodes[arcs[i].to], network.flow(i)});
+		}
+
+		auto on_source_side = std::vector<char>(adjacency.node_count(), 0);
+		auto queue = std::deque<std::size_t>{s};
+		on_source_side[s] = 1;
+		while (not queue.empty()) {
+			auto const v = queue.front();
+			queue.pop_front();
+			for (auto a = network.offsets[v]; a < network.offsets[v + 1U]; ++a) {
+				auto const w = network.heads[a];
+				if (on_source_side[w] == 0 and network.residuals[a] > E{0}) {
+					on_source_side[w] = 1;
+					queue.push_back(w);
+				}
+			}
+		}
+		for (auto u = std::size_t{0}; u < adjacency.node_count(); ++u) {
+			if (on_source_side[u] != 0) {
+				result.source_side.push_back(adjacency.nodes[u]);
+			}
+		}
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_MAX_FLOW_HPP
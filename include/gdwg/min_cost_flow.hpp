@@ -0,0 +1,380 @@
+#ifndef GDWG_MIN_COST_FLOW_HPP
+#define GDWG_MIN_COST_FLOW_HPP
+
+#include "gdwg/detail/flow_network.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/max_flow.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Selects the min_cost_flow implementation. `automatic` picks `cost_scaling` for larger graphs
+	// with integral costs and `successive_shortest_paths` otherwise.
+	enum class min_cost_flow_algorithm { automatic, successive_shortest_paths, cost_scaling };
+
+	template<typename Capacity, typename Cost>
+	struct min_cost_flow_result {
+		// Total flow from the source to the sink, which is always a maximum flow.
+		Capacity flow;
+		// Sum of flow times cost over all edges.
+		std::common_type_t<Capacity, Cost> cost;
+		// The flow on every edge, in the order the graph iterates over its edges. Each weight of a
+		// multi-edge is a separate edge. Self-loops carry no flow.
+		std::vector<Capacity> edge_flows;
+	};
+
+	namespace detail {
+		// The signed type of the same width as an integral T, and T itself otherwise. Reverse slot
+		// costs and node balances can go negative even when the caller's types cannot.
+		template<typename T>
+		using signed_counterpart_t = typename std::conditional_t<std::is_integral_v<T>,
+		                                                         std::make_signed<T>,
+		                                                         std::type_identity<T>>::type;
+
+		// A flow_network whose slots also carry a cost per unit of flow. A reverse slot costs the
+		// negation of its forward slot, since pushing along it cancels flow.
+		template<typename C, typename K>
+		struct cost_flow_network : flow_network<C> {
+			std::vector<K> costs;
+
+			cost_flow_network(std::size_t nodes,
+			                  std::vector<flow_arc<C>> const& arcs,
+			                  std::vector<K> const& arc_costs)
+			: flow_network<C>(nodes, arcs)
+			, costs(2U * arcs.size()) {
+				for (auto i = std::size_t{0}; i < arcs.size(); ++i) {
+					this->costs[this->forward[i]] = arc_costs[i];
+					this->costs[this->reverses[this->forward[i]]] = static_cast<K>(-arc_costs[i]);
+				}
+			}
+		};
+
+		// Potentials that make the cost of every slot with residual capacity non-negative, found by
+		// Bellman-Ford from a virtual root. Throws if those slots contain a negative cost cycle,
+		// which would make the cheapest flow unbounded below for successive shortest paths.
+		template<typename C, typename K>
+		auto residual_potentials(cost_flow_network<C, K> const& network) -> std::vector<K> {
+			auto const n = network.node_count();
+			auto potentials = std::vector<K>(n, K{0});
+			auto const negative = [&network](std::size_t a) {
+				return network.residuals[a] > C{0} and network.costs[a] < K{0};
+			};
+			auto const slots = network.heads.size();
+			auto found = false;
+			for (auto a = std::size_t{0}; a < slots and not found; ++a) {
+				found = negative(a);
+			}
+			if (not found) {
+				return potentials;
+			}
+
+			auto hops = std::vector<std::size_t>(n, 0U);
+			auto queued = std::vector<char>(n, 1);
+			auto queue = std::deque<std::size_t>(n);
+			std::iota(queue.begin(), queue.end(), std::size_t{0});
+			while (not queue.empty()) {
+				auto const u = queue.front();
+				queue.pop_front();
+				queued[u] = 0;
+				for (auto a = network.offsets[u]; a < network.offsets[u + 1U]; ++a) {
+					if (not(network.residuals[a] > C{0})) {
+						continue;
+					}
+					auto const v = network.heads[a];
+					auto const candidate = static_cast<K>(potentials[u] + network.costs[a]);
+					if (candidate < potentials[v]) {
+						potentials[v] = candidate;
+						hops[v] = hops[u] + 1U;
+						if (hops[v] >= n) {
+							throw std::runtime_error("Cannot call gdwg::min_cost_flow on a graph "
+							                         "with a negative cost cycle");
+						}
+						if (queued[v] == 0) {
+							queued[v] = 1;
+							queue.push_back(v);
+						}
+					}
+				}
+			}
+			return potentials;
+		}
+
+		// Successive shortest paths: repeatedly augments along a cheapest residual path, found by
+		// Dijkstra on costs reduced by the potentials, until the sink is out of reach. Returns the
+		// value of the flow.
+		template<typename C, typename K>
+		auto successive_shortest_paths(cost_flow_network<C, K>& network,
+		                               std::size_t source,
+		                               std::size_t sink) -> C {
+			constexpr auto unreachable = std::numeric_limits<K>::max();
+			constexpr auto none = std::numeric_limits<std::size_t>::max();
+			auto const n = network.node_count();
+			auto potentials = residual_potentials(network);
+			auto distances = std::vector<K>(n);
+			auto parent = std::vector<std::size_t>(n);
+			auto settled = std::vector<std::size_t>{};
+			auto heap = std::vector<std::pair<K, std::size_t>>{};
+			auto value = C{0};
+			while (true) {
+				std::fill(distances.begin(), distances.end(), unreachable);
+				std::fill(parent.begin(), parent.end(), none);
+				settled.clear();
+				distances[source] = K{0};
+				heap.emplace_back(K{0}, source);
+				while (not heap.empty()) {
+					std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+					auto const [d, u] = heap.back();
+					heap.pop_back();
+					if (d > distances[u]) {
+						continue;
+					}
+					settled.push_back(u);
+					for (auto a = network.offsets[u]; a < network.offsets[u + 1U]; ++a) {
+						if (not(network.residuals[a] > C{0})) {
+							continue;
+						}
+						auto const v = network.heads[a];
+						// Rounding can leave a floating point reduced cost a hair below zero.
+						auto const reduced = std::max(
+						   K{0},
+						   static_cast<K>(network.costs[a] + potentials[u] - potentials[v]));
+						auto const candidate = static_cast<K>(d + reduced);
+						if (candidate < distances[v]) {
+							distances[v] = candidate;
+							parent[v] = a;
+							heap.emplace_back(candidate, v);
+							std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+						}
+					}
+				}
+				if (distances[sink] == unreachable) {
+					return value;
+				}
+				for (auto const u : settled) {
+					potentials[u] = static_cast<K>(potentials[u] + distances[u]);
+				}
+
+				auto amount = network.residuals[parent[sink]];
+				for (auto v = sink; v != source; v = network.heads[network.reverses[parent[v]]]) {
+					amount = std::min(amount, network.residuals[parent[v]]);
+				}
+				for (auto v = sink; v != source; v = network.heads[network.reverses[parent[v]]]) {
+					network.push(parent[v], amount);
+				}
+				value += amount;
+			}
+		}
+
+		// Cost scaling (Goldberg-Tarjan) over a network that already carries a maximum flow. Costs
+		// are multiplied by n + 1, and each refinement turns an epsilon-optimal flow into an
+		// epsilon/alpha-optimal one: it saturates every slot with negative reduced cost and then
+		// pushes the resulting excess along admissible slots, lowering prices where there are
+		// none. Once epsilon reaches 1, the flow is optimal for the original integral costs. The
+		// flow value never changes, since every refinement ends with the original balances.
+		// Saturation leaves some balances negative, so they are kept in a signed type even when
+		// capacities are unsigned.
+		template<typename C, typename K>
+		auto cost_scaling(cost_flow_network<C, K>& network) -> void {
+			using balance_type = signed_counterpart_t<C>;
+			constexpr auto alpha = std::int64_t{8};
+			auto const n = network.node_count();
+			auto const slots = network.heads.size();
+			auto const scale = static_cast<std::int64_t>(n) + 1;
+			auto costs = std::vector<std::int64_t>(slots);
+			auto epsilon = std::int64_t{0};
+			for (auto a = std::size_t{0}; a < slots; ++a) {
+				costs[a] = static_cast<std::int64_t>(network.costs[a]) * scale;
+				epsilon = std::max(epsilon, costs[a] < 0 ? -costs[a] : costs[a]);
+			}
+			if (epsilon == 0) {
+				return;
+			}
+
+			auto prices = std::vector<std::int64_t>(n, 0);
+			auto excess = std::vector<balance_type>(n);
+			auto current = std::vector<std::size_t>(n);
+			auto active = std::deque<std::size_t>{};
+			auto const reduced = [&](std::size_t u, std::size_t a) {
+				return costs[a] + prices[u] - prices[network.heads[a]];
+			};
+			auto const push = [&](std::size_t u, std::size_t a, C amount) {
+				auto const v = network.heads[a];
+				auto const was_active = excess[v] > balance_type{0};
+				network.push(a, amount);
+				excess[u] -= static_cast<balance_type>(amount);
+				excess[v] += static_cast<balance_type>(amount);
+				if (not was_active and excess[v] > balance_type{0}) {
+					active.push_back(v);
+				}
+			};
+			auto const relabel = [&](std::size_t u) {
+				auto highest = std::numeric_limits<std::int64_t>::min();
+				for (auto a = network.offsets[u]; a < network.offsets[u + 1U]; ++a) {
+					if (network.residuals[a] > C{0}) {
+						highest = std::max(highest, prices[network.heads[a]] - costs[a]);
+					}
+				}
+				prices[u] = highest - epsilon;
+				current[u] = network.offsets[u];
+			};
+
+			do {
+				epsilon = std::max(std::int64_t{1}, epsilon / alpha);
+				std::fill(excess.begin(), excess.end(), balance_type{0});
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					current[u] = network.offsets[u];
+					for (auto a = network.offsets[u]; a < network.offsets[u + 1U]; ++a) {
+						if (network.residuals[a] > C{0} and reduced(u, a) < 0) {
+							push(u, a, network.residuals[a]);
+						}
+					}
+				}
+				// Excess can only have been created by the saturation above, and it stays queued
+				// until it is gone.
+				active.clear();
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					if (excess[u] > balance_type{0}) {
+						active.push_back(u);
+					}
+				}
+				while (not active.empty()) {
+					auto const u = active.front();
+					active.pop_front();
+					while (excess[u] > balance_type{0}) {
+						if (current[u] == network.offsets[u + 1U]) {
+							relabel(u);
+						}
+						auto const a = current[u];
+						if (network.residuals[a] > C{0} and reduced(u, a) < 0) {
+							push(u, a, std::min(static_cast<C>(excess[u]), network.residuals[a]));
+						}
+						if (excess[u] > balance_type{0}) {
+							++current[u];
+						}
+					}
+				}
+			} while (epsilon > 1);
+		}
+	} // namespace detail
+
+	// A minimum cost maximum flow from `source` to `sink`. `capacity_of` and `cost_of` read the
+	// capacity and the cost per unit of flow of an edge from its weight, and every weight of a
+	// multi-edge is a separate edge. Capacities must be non-negative, while costs may be negative
+	// as long as no cycle of edges with capacity has a negative total cost. Both algorithms run
+	// on a compact residual graph built once from a CSR snapshot. Cost scaling starts from a
+	// push-relabel maximum flow and needs integral costs.
+	template<typename N, typename E, typename CapacityOf, typename CostOf>
+	auto min_cost_flow(graph<N, E> const& g,
+	                   N const& source,
+	                   N const& sink,
+	                   CapacityOf capacity_of,
+	                   CostOf cost_of,
+	                   min_cost_flow_algorithm algorithm = min_cost_flow_algorithm::automatic)
+	   -> min_cost_flow_result<std::remove_cvref_t<std::invoke_result_t<CapacityOf&, E const&>>,
+	                           std::remove_cvref_t<std::invoke_result_t<CostOf&, E const&>>> {
+		using capacity_type = std::remove_cvref_t<std::invoke_result_t<CapacityOf&, E const&>>;
+		using cost_type = std::remove_cvref_t<std::invoke_result_t<CostOf&, E const&>>;
+		using total_type = std::common_type_t<capacity_type, cost_type>;
+		static_assert(std::is_arithmetic_v<capacity_type> and std::is_arithmetic_v<cost_type>,
+		              "gdwg::min_cost_flow requires arithmetic capacities and costs");
+		constexpr auto cost_scaling_threshold = std::size_t{1} << 12U;
+		constexpr auto none = std::numeric_limits<std::size_t>::max();
+
+		if (not(g.is_node(source) and g.is_node(sink))) {
+			throw std::runtime_error("Cannot call gdwg::min_cost_flow if source or sink node don't "
+			                         "exist in the graph");
+		}
+		auto const adjacency = g.to_csr();
+		auto const s = adjacency.index_of(source);
+		auto const t = adjacency.index_of(sink);
+		if (s == t) {
+			throw std::runtime_error("Cannot call gdwg::min_cost_flow when source and sink are the "
+			                         "same node");
+		}
+
+		auto arcs = std::vector<detail::flow_arc<capacity_type>>{};
+		auto arc_costs = std::vector<cost_type>{};
+		auto arc_of_edge = std::vector<std::size_t>(adjacency.edge_count(), none);
+		for (auto u = std::size_t{0}; u < adjacency.node_count(); ++u) {
+			for (auto e = adjacency.offsets[u]; e < adjacency.offsets[u + 1U]; ++e) {
+				auto const capacity = capacity_of(adjacency.weights[e]);
+				if (capacity < capacity_type{0}) {
+					throw std::runtime_error("Cannot call gdwg::min_cost_flow on a graph with a "
+					                         "negative capacity");
+				}
+				if (adjacency.targets[e] != u) {
+					arc_of_edge[e] = arcs.size();
+					arcs.push_back({u, adjacency.targets[e], capacity});
+					arc_costs.push_back(cost_of(adjacency.weights[e]));
+				}
+			}
+		}
+
+		// Slots are costed in a signed type, since every reverse slot costs the negation of its
+		// forward slot.
+		using slot_cost_type = detail::signed_counterpart_t<cost_type>;
+		auto slot_costs = std::vector<slot_cost_type>(arc_costs.cbegin(), arc_costs.cend());
+		auto network =
+		   detail::cost_flow_network<capacity_type, slot_cost_type>(adjacency.node_count(),
+		                                                            arcs,
+		                                                            slot_costs);
+		if (algorithm == min_cost_flow_algorithm::automatic) {
+			algorithm = std::is_integral_v<cost_type> and arcs.size() >= cost_scaling_threshold
+			               ? min_cost_flow_algorithm::cost_scaling
+			               : min_cost_flow_algorithm::successive_shortest_paths;
+		}
+		auto result = min_cost_flow_result<capacity_type, cost_type>{};
+		if (algorithm == min_cost_flow_algorithm::successive_shortest_paths) {
+			result.flow = detail::successive_shortest_paths(network, s, t);
+		}
+		else if constexpr (std::is_integral_v<cost_type>) {
+			static_cast<void>(detail::residual_potentials(network));
+			result.flow = detail::push_relabel<capacity_type>(network, s, t).run();
+			detail::cost_scaling(network);
+		}
+		else {
+			throw std::runtime_error("Cannot call gdwg::min_cost_flow with cost_scaling on "
+			                         "non-integral costs");
+		}
+
+		result.cost = total_type{0};
+		result.edge_flows.assign(adjacency.edge_count(), capacity_type{0});
+		for (auto e = std::size_t{0}; e < adjacency.edge_count(); ++e) {
+			if (arc_of_edge[e] != none) {
+				auto const flow = network.flow(arc_of_edge[e]);
+				auto const cost = arc_costs[arc_of_edge[e]];
+				result.edge_flows[e] = flow;
+				result.cost += static_cast<total_type>(flow) * static_cast<total_type>(cost);
+			}
+		}
+		return result;
+	}
+
+	// As above, for graphs whose weights are (capacity, cost) pairs.
+	template<typename N, typename Capacity, typename Cost>
+	auto min_cost_flow(graph<N, std::pair<Capacity, Cost>> const& g,
+	                   N const& source,
+	                   N const& sink,
+	                   min_cost_flow_algorithm algorithm = min_cost_flow_algorithm::automatic)
+	   -> min_cost_flow_result<Capacity, Cost> {
+		return min_cost_flow(
+		   g,
+		   source,
+		   sink,
+		   [](std::pair<Capacity, Cost> const& weight) { return weight.first; },
+		   [](std::pair<Capacity, Cost> const& weight) { return weight.second; },
+		   algorithm);
+	}
+} // namespace gdwg
+
+#endif // GDWG_MIN_COST_FLOW_HPP
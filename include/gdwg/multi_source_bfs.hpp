@@ -0,0 +1,206 @@
+#ifndef GDWG_MULTI_SOURCE_BFS_HPP
+#define GDWG_MULTI_SOURCE_BFS_HPP
+
+#include "gdwg/breadth_first_search.hpp"
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// How many sources one pass of multi_source_bfs carries, as bits per node. Wider passes share
+	// more of each edge scan between sources, but need more memory per node and leave fewer
+	// passes to spread across threads. `automatic` picks the widest that still gives every
+	// thread a pass of its own, and `bits_64` when there are too few sources for that.
+	enum class msbfs_width { automatic, bits_64, bits_256, bits_512 };
+
+	namespace detail {
+		// Then et al.'s multi-source BFS over up to 64 * Words sources at once. Each node holds
+		// one bit per source in three bitsets: the sources that have seen it, the sources whose
+		// frontier it is on, and the sources that reach it next. A level ORs each frontier
+		// node's bits into its out-neighbours and masks off the sources that have already seen
+		// them, so one scan of an edge serves every source at once. All bitset operations are
+		// fixed-size loops over words, which compilers turn into vector instructions.
+		template<typename N, typename E, std::size_t Words>
+		class multi_source_search {
+		public:
+			using lanes = std::array<std::uint64_t, Words>;
+			static constexpr auto width = Words * std::size_t{64};
+
+			explicit multi_source_search(csr<N, E> const& g)
+			: g_(&g)
+			, seen_(g.node_count())
+			, visit_(g.node_count())
+			, next_(g.node_count()) {}
+
+			// Searches from up to `width` sources, and calls `visit(first + i, v, depth)` when
+			// sources[i] first reaches v.
+			template<typename Visit>
+			auto run(std::span<std::size_t const> sources, std::size_t first, Visit const& visit)
+			   -> void {
+				auto const& g = *this->g_;
+				std::fill(this->seen_.begin(), this->seen_.end(), lanes{});
+				this->frontier_.clear();
+				for (auto i = std::size_t{0}; i < sources.size(); ++i) {
+					auto const s = sources[i];
+					if (none(this->visit_[s])) {
+						this->frontier_.push_back(s);
+					}
+					this->visit_[s][i / 64U] |= std::uint64_t{1} << (i % 64U);
+					this->seen_[s][i / 64U] |= std::uint64_t{1} << (i % 64U);
+					visit(first + i, s, std::size_t{0});
+				}
+
+				for (auto depth = std::size_t{1}; not this->frontier_.empty(); ++depth) {
+					this->reached_.clear();
+					for (auto const v : this->frontier_) {
+						auto const& from = this->visit_[v];
+						for (auto const u : g.neighbours(v)) {
+							auto& to = this->next_[u];
+							if (none(to)) {
+								this->reached_.push_back(u);
+							}
+							for (auto w = std::size_t{0}; w < Words; ++w) {
+								to[w] |= from[w];
+							}
+						}
+					}
+					for (auto const v : this->frontier_) {
+						this->visit_[v] = lanes{};
+					}
+
+					this->frontier_.clear();
+					for (auto const u : this->reached_) {
+						auto& fresh = this->next_[u];
+						auto& seen = this->seen_[u];
+						for (auto w = std::size_t{0}; w < Words; ++w) {
+							fresh[w] &= ~seen[w];
+							seen[w] |= fresh[w];
+						}
+						if (none(fresh)) {
+							continue;
+						}
+						for (auto w = std::size_t{0}; w < Words; ++w) {
+							for (auto bits = fresh[w]; bits != 0U; bits &= bits - 1U) {
+								auto const bit = static_cast<std::size_t>(std::countr_zero(bits));
+								visit(first + w * 64U + bit, u, depth);
+							}
+						}
+						this->visit_[u] = fresh;
+						this->frontier_.push_back(u);
+						fresh = lanes{};
+					}
+					for (auto const u : this->reached_) {
+						this->next_[u] = lanes{};
+					}
+				}
+			}
+
+		private:
+			csr<N, E> const* g_;
+			std::vector<lanes> seen_;
+			std::vector<lanes> visit_;
+			std::vector<lanes> next_;
+			std::vector<std::size_t> frontier_;
+			std::vector<std::size_t> reached_;
+
+			static auto none(lanes const& bits) noexcept -> bool {
+				auto any = std::uint64_t{0};
+				for (auto w = std::size_t{0}; w < Words; ++w) {
+					any |= bits[w];
+				}
+				return any == 0U;
+			}
+		};
+
+		// Splits the sources into passes of the search's width and spreads the passes across
+		// workers, each with its own bitsets.
+		template<std::size_t Words, typename N, typename E, typename Visit>
+		auto multi_source_passes(csr<N, E> const& g,
+		                         std::vector<std::size_t> const& sources,
+		                         Visit const& visit) -> void {
+			using search_type = multi_source_search<N, E, Words>;
+			auto const passes = (sources.size() + search_type::width - 1U) / search_type::width;
+			auto const workers = worker_count(passes, 1U);
+			auto searches = std::vector<search_type>(workers, search_type(g));
+			parallel_for_dynamic(
+			   0U,
+			   passes,
+			   [&](std::size_t pass, std::size_t worker) {
+				   auto const first = pass * search_type::width;
+				   auto const count = std::min(search_type::width, sources.size() - first);
+				   auto const part = std::span<std::size_t const>(sources.data() + first, count);
+				   searches[worker].run(part, first, visit);
+			   },
+			   1U,
+			   workers);
+		}
+	} // namespace detail
+
+	// Breadth-first searches from every node of `sources` at once, sharing each edge scan between
+	// up to 512 sources. Calls `visit(i, v, depth)` once for each node v that sources[i] reaches,
+	// where v is an index in the same order as g.nodes() and depth is its hop distance. Passes of
+	// sources run on separate std::thread workers, so `visit` may be called concurrently, but the
+	// calls for any one source all come from the same thread. Each worker holds three bitsets of
+	// the pass width per node.
+	template<typename N, typename E, typename Visit>
+	auto multi_source_bfs(graph<N, E> const& g,
+	                      std::vector<N> const& sources,
+	                      Visit const& visit,
+	                      msbfs_width width = msbfs_width::automatic) -> void {
+		auto const adjacency = g.to_csr();
+		auto indices = std::vector<std::size_t>{};
+		indices.reserve(sources.size());
+		for (auto const& source : sources) {
+			if (not adjacency.contains(source)) {
+				throw std::runtime_error("Cannot call gdwg::multi_source_bfs if a source node doesn't "
+				                         "exist in the graph");
+			}
+			indices.push_back(adjacency.index_of(source));
+		}
+		if (width == msbfs_width::automatic) {
+			auto const threads = max_threads();
+			width = sources.size() >= 512U * threads   ? msbfs_width::bits_512
+			        : sources.size() >= 256U * threads ? msbfs_width::bits_256
+			                                           : msbfs_width::bits_64;
+		}
+		if (width == msbfs_width::bits_512) {
+			detail::multi_source_passes<8U>(adjacency, indices, visit);
+		}
+		else if (width == msbfs_width::bits_256) {
+			detail::multi_source_passes<4U>(adjacency, indices, visit);
+		}
+		else {
+			detail::multi_source_passes<1U>(adjacency, indices, visit);
+		}
+	}
+
+	// Hop distance from each node of `sources` to every node, in the same order as g.nodes(), or
+	// breadth_first_tree::unreached. The searches share their work as in multi_source_bfs.
+	template<typename N, typename E>
+	auto multi_source_distances(graph<N, E> const& g,
+	                            std::vector<N> const& sources,
+	                            msbfs_width width = msbfs_width::automatic)
+	   -> std::vector<std::vector<std::size_t>> {
+		auto result = std::vector<std::vector<std::size_t>>(
+		   sources.size(),
+		   std::vector<std::size_t>(g.nodes().size(), breadth_first_tree::unreached));
+		multi_source_bfs(
+		   g,
+		   sources,
+		   [&result](std::size_t i, std::size_t v, std::size_t depth) { result[i][v] = depth; },
+		   width);
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_MULTI_SOURCE_BFS_HPP
@@ -0,0 +1,232 @@
+#ifndef GDWG_PAGERANK_HPP
+#define GDWG_PAGERANK_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace gdwg {
+	struct pagerank_options {
+		// Probability of following an out-edge rather than teleporting.
+		double damping = 0.85;
+		// pagerank stops once the L1 change between iterations drops below this. For
+		// personalised_pagerank it bounds the residual left at each node per unit of out-degree.
+		double tolerance = 1e-6;
+		// Caps the power iterations of pagerank. personalised_pagerank ignores it, since its push
+		// work is already bounded by the damping and the tolerance.
+		std::size_t max_iterations = 100;
+	};
+
+	namespace detail {
+		// Structure of the graph with multi-edges collapsed, as both the out-degree of every node
+		// and the in-adjacency used by pull-based iteration.
+		struct pagerank_structure {
+			std::vector<std::size_t> out_degree;
+			std::vector<std::size_t> in_offsets;
+			std::vector<std::size_t> in_sources;
+		};
+
+		// Whether slot e is the first of its multi-edge in row u.
+		template<typename N, typename E>
+		auto is_first_parallel_edge(csr<N, E> const& g, std::size_t u, std::size_t e) noexcept
+		   -> bool {
+			return e == g.offsets[u] or g.targets[e] != g.targets[e - 1U];
+		}
+
+		template<typename N, typename E>
+		auto distinct_out_degrees(csr<N, E> const& g) -> std::vector<std::size_t> {
+			auto degrees = std::vector<std::size_t>(g.node_count(), 0U);
+			for (auto u = std::size_t{0}; u < g.node_count(); ++u) {
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					degrees[u] += is_first_parallel_edge(g, u, e) ? 1U : 0U;
+				}
+			}
+			return degrees;
+		}
+
+		template<typename N, typename E>
+		auto make_pagerank_structure(csr<N, E> const& g) -> pagerank_structure {
+			auto const n = g.node_count();
+			auto result = pagerank_structure{};
+			result.out_degree = distinct_out_degrees(g);
+			result.in_offsets.assign(n + 1U, 0U);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					if (is_first_parallel_edge(g, u, e)) {
+						++result.in_offsets[g.targets[e] + 1U];
+					}
+				}
+			}
+			std::partial_sum(result.in_offsets.cbegin(),
+			                 result.in_offsets.cend(),
+			                 result.in_offsets.begin());
+
+			auto cursor = std::vector<std::size_t>(result.in_offsets.cbegin(),
+			                                       std::prev(result.in_offsets.cend()));
+			result.in_sources.resize(result.in_offsets.back());
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					if (is_first_parallel_edge(g, u, e)) {
+						result.in_sources[cursor[g.targets[e]]++] = u;
+					}
+				}
+			}
+			return result;
+		}
+	} // namespace detail
+
+	// PageRank of every node by power iteration, returned in the same order as g.nodes(). Parallel
+	// edges count once. Each iteration is a pull-based sparse matrix-vector product over the
+	// in-edges, split across std::thread workers by edge count; the mass of nodes without
+	// out-edges is spread uniformly.
+	template<typename N, typename E>
+	auto pagerank(graph<N, E> const& g, pagerank_options const& options = {})
+	   -> std::vector<double> {
+		auto const structure = detail::make_pagerank_structure(g.to_csr());
+		auto const n = structure.out_degree.size();
+		if (n == 0U) {
+			return {};
+		}
+
+		auto const nodes = static_cast<double>(n);
+		auto inverse_degree = std::vector<double>(n, 0.0);
+		for (auto u = std::size_t{0}; u < n; ++u) {
+			if (structure.out_degree[u] != 0U) {
+				inverse_degree[u] = 1.0 / static_cast<double>(structure.out_degree[u]);
+			}
+		}
+
+		constexpr auto grain = std::size_t{4096};
+		auto rank = std::vector<double>(n, 1.0 / nodes);
+		auto next = std::vector<double>(n);
+		auto contribution = std::vector<double>(n);
+		auto partial = std::vector<double>(detail::worker_count(n, grain));
+		auto change =
+		   std::vector<double>(detail::worker_count(n + structure.in_sources.size(), grain));
+		for (auto iteration = std::size_t{0}; iteration < options.max_iterations; ++iteration) {
+			// What each node hands to every out-neighbour. A node without out-edges has an inverse
+			// degree of zero, so the loop stays branch-free and vectorises; its rank is collected
+			// separately as dangling mass.
+			std::fill(partial.begin(), partial.end(), 0.0);
+			detail::parallel_chunks(
+			   0U,
+			   n,
+			   [&](std::size_t first, std::size_t last, std::size_t worker) {
+				   auto dangling = 0.0;
+				   for (auto u = first; u < last; ++u) {
+					   contribution[u] = rank[u] * inverse_degree[u];
+					   dangling += structure.out_degree[u] == 0U ? rank[u] : 0.0;
+				   }
+				   partial[worker] = dangling;
+			   },
+			   grain);
+			auto const dangling = std::accumulate(partial.cbegin(), partial.cend(), 0.0);
+			auto const base = (1.0 - options.damping) / nodes + options.damping * dangling / nodes;
+
+			std::fill(change.begin(), change.end(), 0.0);
+			detail::parallel_edge_chunks(
+			   structure.in_offsets,
+			   [&](std::size_t first, std::size_t last, std::size_t worker) {
+				   auto delta = 0.0;
+				   for (auto v = first; v < last; ++v) {
+					   auto sum = 0.0;
+					   auto const last_edge = structure.in_offsets[v + 1U];
+					   for (auto e = structure.in_offsets[v]; e < last_edge; ++e) {
+						   sum += contribution[structure.in_sources[e]];
+					   }
+					   next[v] = base + options.damping * sum;
+					   delta += std::abs(next[v] - rank[v]);
+				   }
+				   change[worker] = delta;
+			   },
+			   grain);
+			rank.swap(next);
+			if (std::accumulate(change.cbegin(), change.cend(), 0.0) < options.tolerance) {
+				break;
+			}
+		}
+		return rank;
+	}
+
+	// Personalised PageRank with respect to `source` by forward push: residual probability mass
+	// is pushed from a node to its out-neighbours until no node holds more than
+	// `options.tolerance` times its out-degree. Beyond taking the CSR snapshot, only the
+	// neighbourhood that actually receives mass is touched, so the push work depends on the
+	// tolerance rather than on the size of the graph. Mass reaching a node without out-edges
+	// teleports back to `source`. Returns an estimate for every node in the same order as
+	// g.nodes(). The damping must lie in [0, 1) and the tolerance must be positive, or the push
+	// may never end.
+	template<typename N, typename E>
+	auto personalised_pagerank(graph<N, E> const& g,
+	                           N const& source,
+	                           pagerank_options const& options = {}) -> std::vector<double> {
+		if (not g.is_node(source)) {
+			throw std::runtime_error("Cannot call gdwg::personalised_pagerank if source doesn't "
+			                         "exist in the graph");
+		}
+		if (not(options.damping >= 0.0 and options.damping < 1.0)) {
+			throw std::runtime_error("Cannot call gdwg::personalised_pagerank with a damping "
+			                         "outside [0, 1)");
+		}
+		if (not(options.tolerance > 0.0)) {
+			throw std::runtime_error("Cannot call gdwg::personalised_pagerank with a tolerance that "
+			                         "is not positive");
+		}
+		auto const adjacency = g.to_csr();
+		auto const s = adjacency.index_of(source);
+		auto const out_degree = detail::distinct_out_degrees(adjacency);
+		auto const n = adjacency.node_count();
+		auto const alpha = 1.0 - options.damping;
+
+		auto estimate = std::vector<double>(n, 0.0);
+		auto residual = std::vector<double>(n, 0.0);
+		auto queued = std::vector<char>(n, 0);
+		auto const needs_push = [&](std::size_t u) {
+			auto const degree = static_cast<double>(std::max(out_degree[u], std::size_t{1}));
+			return residual[u] > options.tolerance * degree;
+		};
+
+		auto queue = std::deque<std::size_t>{s};
+		residual[s] = 1.0;
+		queued[s] = 1;
+		while (not queue.empty()) {
+			auto const u = queue.front();
+			queue.pop_front();
+			queued[u] = 0;
+			auto const mass = residual[u];
+			residual[u] = 0.0;
+			estimate[u] += alpha * mass;
+
+			auto const spread = (1.0 - alpha) * mass;
+			auto const receive = [&](std::size_t v, double amount) {
+				residual[v] += amount;
+				if (queued[v] == 0 and needs_push(v)) {
+					queued[v] = 1;
+					queue.push_back(v);
+				}
+			};
+			if (out_degree[u] == 0U) {
+				receive(s, spread);
+				continue;
+			}
+			auto const share = spread / static_cast<double>(out_degree[u]);
+			for (auto e = adjacency.offsets[u]; e < adjacency.offsets[u + 1U]; ++e) {
+				if (detail::is_first_parallel_edge(adjacency, u, e)) {
+					receive(adjacency.targets[e], share);
+				}
+			}
+		}
+		return estimate;
+	}
+} // namespace gdwg
+
+#endif // GDWG_PAGERANK_HPP
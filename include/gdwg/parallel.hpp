@@ -0,0 +1,178 @@
+#ifndef GDWG_PARALLEL_HPP
+#define GDWG_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+namespace gdwg {
+	namespace detail {
+		inline auto max_threads_setting() noexcept -> std::atomic<std::size_t>& {
+			static auto setting = std::atomic<std::size_t>{0U};
+			return setting;
+		}
+	} // namespace detail
+
+	// Caps the number of threads that the parallel algorithms use. Zero, the default, means
+	// std::thread::hardware_concurrency().
+	inline auto set_max_threads(std::size_t threads) noexcept -> void {
+		detail::max_threads_setting().store(threads);
+	}
+
+	[[nodiscard]] inline auto max_threads() noexcept -> std::size_t {
+		auto const threads = detail::max_threads_setting().load();
+		if (threads != 0U) {
+			return threads;
+		}
+		return std::max(std::size_t{1}, std::size_t{std::thread::hardware_concurrency()});
+	}
+} // namespace gdwg
+
+namespace gdwg::detail {
+	// Number of workers to use for `work` items when each worker should get at least `grain` of
+	// them. Never less than one, never more than max_threads().
+	inline auto worker_count(std::size_t work, std::size_t grain) noexcept -> std::size_t {
+		return std::clamp(work / std::max(grain, std::size_t{1}), std::size_t{1}, max_threads());
+	}
+
+	// Runs `f(worker)` on `workers` threads (the calling thread acts as worker 0) and rethrows the
+	// first exception raised by any of them once all have finished.
+	template<typename F>
+	auto run_workers(std::size_t workers, F const& f) -> void {
+		if (workers <= 1U) {
+			f(std::size_t{0});
+			return;
+		}
+
+		auto error = std::exception_ptr{};
+		auto error_mutex = std::mutex{};
+		auto guarded = [&](std::size_t worker) {
+			try {
+				f(worker);
+			} catch (...) {
+				auto lock = std::lock_guard{error_mutex};
+				if (not error) {
+					error = std::current_exception();
+				}
+			}
+		};
+
+		auto threads = std::vector<std::thread>{};
+		threads.reserve(workers - 1U);
+		for (auto worker = std::size_t{1}; worker < workers; ++worker) {
+			threads.emplace_back(guarded, worker);
+		}
+		guarded(std::size_t{0});
+		for (auto& t : threads) {
+			t.join();
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	// Splits [first, last) into one contiguous chunk per worker and calls
+	// `f(chunk_first, chunk_last, worker)` for each.
+	template<typename F>
+	auto parallel_chunks(std::size_t first, std::size_t last, F const& f, std::size_t grain = 1024U)
+	   -> void {
+		if (first >= last) {
+			return;
+		}
+		auto const work = last - first;
+		auto const workers = worker_count(work, grain);
+		run_workers(workers, [&](std::size_t worker) {
+			auto const begin = first + work * worker / workers;
+			auto const end = first + work * (worker + 1U) / workers;
+			f(begin, end, worker);
+		});
+	}
+
+	// Like parallel_chunks over the nodes of a CSR row index, but places the chunk boundaries so
+	// that every worker gets a similar share of nodes plus edges. Splitting by node count alone
+	// leaves most workers idle on graphs with skewed degrees.
+	template<typename F>
+	auto parallel_edge_chunks(std::vector<std::size_t> const& offsets,
+	                          F const& f,
+	                          std::size_t grain = 4096U) -> void {
+		if (offsets.size() <= 1U) {
+			return;
+		}
+		auto const nodes = offsets.size() - 1U;
+		auto const work = nodes + offsets.back();
+		auto const workers = worker_count(work, grain);
+		auto const boundary = [&](std::size_t worker) -> std::size_t {
+			if (worker == workers) {
+				return nodes;
+			}
+			auto const target = work * worker / workers;
+			auto const ids = std::views::iota(std::size_t{0}, nodes);
+			return *std::ranges::partition_point(ids, [&](std::size_t u) {
+				return u + offsets[u] < target;
+			});
+		};
+		run_workers(workers, [&](std::size_t worker) {
+			f(boundary(worker), boundary(worker + 1U), worker);
+		});
+	}
+
+	// Calls `f(i, worker)` for every i in [first, last), handing out `batch` indices at a time so
+	// that uneven per-index costs are balanced across workers.
+	template<typename F>
+	auto parallel_for_dynamic(std::size_t first,
+	                          std::size_t last,
+	                          F const& f,
+	                          std::size_t batch = 1U,
+	                          std::size_t workers = 0U) -> void {
+		if (first >= last) {
+			return;
+		}
+		batch = std::max(batch, std::size_t{1});
+		if (workers == 0U) {
+			workers = worker_count(last - first, batch);
+		}
+		auto next = std::atomic<std::size_t>{first};
+		run_workers(workers, [&](std::size_t worker) {
+			for (auto begin = next.fetch_add(batch); begin < last; begin = next.fetch_add(batch)) {
+				auto const end = std::min(begin + batch, last);
+				for (auto i = begin; i < end; ++i) {
+					f(i, worker);
+				}
+			}
+		});
+	}
+
+	// Sorts [first, last) by sorting one chunk per worker and then merging neighbouring chunks
+	// pairwise, with the merges of each round also running in parallel.
+	template<typename RandomIt, typename Compare>
+	auto parallel_sort(RandomIt first, RandomIt last, Compare comp) -> void {
+		auto const size = static_cast<std::size_t>(last - first);
+		auto const workers = worker_count(size, std::size_t{1} << 14U);
+		if (workers == 1U) {
+			std::sort(first, last, comp);
+			return;
+		}
+		auto const bound = [&](std::size_t chunk) {
+			auto const offset = size * std::min(chunk, workers) / workers;
+			return first + static_cast<std::ptrdiff_t>(offset);
+		};
+		run_workers(workers, [&](std::size_t worker) {
+			std::sort(bound(worker), bound(worker + 1U), comp);
+		});
+		for (auto width = std::size_t{1}; width < workers; width *= 2U) {
+			auto const merges = (workers + 2U * width - 1U) / (2U * width);
+			auto const merge = [&](std::size_t i, std::size_t) {
+				auto const left = i * 2U * width;
+				std::inplace_merge(bound(left), bound(left + width), bound(left + 2U * width), comp);
+			};
+			parallel_for_dynamic(0U, merges, merge, 1U, merges);
+		}
+	}
+} // namespace gdwg::detail
+
+#endif // GDWG_PARALLEL_HPP
@@ -0,0 +1,501 @@
+#ifndef GDWG_PARTITION_HPP
+#define GDWG_PARTITION_HPP
+
+#include "gdwg/communities.hpp"
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	struct partition_options {
+		// How far a part may exceed an even share of the nodes: each part holds at most
+		// floor((1 + imbalance) * nodes / parts) of them, or ceil(nodes / parts) if that is more.
+		double imbalance = 0.03;
+		// Coarsening stops once the graph has at most this many nodes per part.
+		std::size_t coarsest_nodes_per_part = 20;
+		// Independent initial partitions of the coarsest graph, of which the best is kept.
+		std::size_t initial_tries = 8;
+		// Fiduccia-Mattheyses passes per level. Refinement stops early once a pass gains
+		// nothing.
+		std::size_t refinement_passes = 10;
+		// Seeds the matching order and the initial partitions.
+		std::mt19937::result_type seed = std::mt19937::default_seed;
+	};
+
+	namespace detail {
+		inline constexpr auto no_part = std::numeric_limits<std::size_t>::max();
+
+		// Heavy-edge matching: nodes are visited in random order, and each unmatched node is
+		// paired with the unmatched neighbour it shares the heaviest edge with, as long as the
+		// pair stays within `max_weight`. Returns a dense coarse id per node and the coarse node
+		// count. Pairs share an id, and unmatched nodes keep one of their own.
+		inline auto heavy_edge_matching(community_graph const& g,
+		                                std::vector<std::size_t> const& weights,
+		                                std::size_t max_weight,
+		                                std::mt19937& engine)
+		   -> std::pair<std::vector<std::size_t>, std::size_t> {
+			auto const n = g.node_count();
+			auto match = std::vector<std::size_t>(n, no_part);
+			for (auto const u : shuffled_nodes(n, engine)) {
+				if (match[u] != no_part) {
+					continue;
+				}
+				auto best = u;
+				auto best_weight = 0.0;
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					auto const v = g.targets[e];
+					if (match[v] == no_part and weights[u] + weights[v] <= max_weight
+					    and (best == u or g.weights[e] > best_weight))
+					{
+						best = v;
+						best_weight = g.weights[e];
+					}
+				}
+				match[u] = best;
+				match[best] = u;
+			}
+			auto coarse = std::vector<std::size_t>(n, no_part);
+			auto count = std::size_t{0};
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				if (coarse[u] == no_part) {
+					coarse[u] = count;
+					coarse[match[u]] = count;
+					++count;
+				}
+			}
+			return {std::move(coarse), count};
+		}
+
+		// A k-way partition of a weighted graph with its part weights, the part weight limit and
+		// the total weight by which parts exceed it.
+		class partition_state {
+		public:
+			partition_state(community_graph const& g,
+			                std::vector<std::size_t> const& weights,
+			                std::size_t parts,
+			                std::size_t max_part)
+			: g_(&g)
+			, weights_(&weights)
+			, max_part_(max_part)
+			, part_weights_(parts, 0U)
+			, connections_(parts)
+			, locked_(g.node_count(), 0) {}
+
+			// Takes on `assignment`, which must give every node a part.
+			auto assign(std::vector<std::size_t> assignment) -> void {
+				this->parts_ = std::move(assignment);
+				std::fill(this->part_weights_.begin(), this->part_weights_.end(), std::size_t{0});
+				for (auto u = std::size_t{0}; u < this->parts_.size(); ++u) {
+					this->part_weights_[this->parts_[u]] += (*this->weights_)[u];
+				}
+				this->excess_ = 0U;
+				for (auto const w : this->part_weights_) {
+					this->excess_ += w > this->max_part_ ? w - this->max_part_ : 0U;
+				}
+			}
+
+			[[nodiscard]] auto parts() const noexcept -> std::vector<std::size_t> const& {
+				return this->parts_;
+			}
+
+			[[nodiscard]] auto excess() const noexcept -> std::size_t {
+				return this->excess_;
+			}
+
+			[[nodiscard]] auto cut() const -> double {
+				auto const& g = *this->g_;
+				auto total = 0.0;
+				for (auto u = std::size_t{0}; u < g.node_count(); ++u) {
+					for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+						total += this->parts_[g.targets[e]] != this->parts_[u] ? g.weights[e] : 0.0;
+					}
+				}
+				return total / 2.0;
+			}
+
+			// Moves nodes out of every overweight part, most profitable first, into the part
+			// that gains most from them among those with room. A node with no neighbour in such a
+			// part goes to the lightest part. This only runs when FM's moves along the boundary
+			// cannot restore balance, such as for a part with no boundary at all.
+			auto rebalance() -> void {
+				auto const k = this->part_weights_.size();
+				for (auto p = std::size_t{0}; p < k and this->excess_ > 0U; ++p) {
+					if (this->part_weights_[p] <= this->max_part_) {
+						continue;
+					}
+					auto candidates = std::vector<std::pair<double, std::size_t>>{};
+					for (auto u = std::size_t{0}; u < this->parts_.size(); ++u) {
+						if (this->parts_[u] == p) {
+							candidates.emplace_back(-this->best_move(u, true).first, u);
+						}
+					}
+					std::sort(candidates.begin(), candidates.end());
+					for (auto const& candidate : candidates) {
+						if (this->part_weights_[p] <= this->max_part_) {
+							break;
+						}
+						auto const target = this->best_move(candidate.second, true).second;
+						if (target != no_part) {
+							this->move(candidate.second, target);
+						}
+					}
+				}
+			}
+
+			// One Fiduccia-Mattheyses pass. Boundary nodes sit in a max-heap by the gain of their
+			// best allowed move, and the best is moved and locked, even when that makes the cut
+			// worse, until `patience` moves in a row have not beaten the best state seen. The
+			// moves after that best state are then undone. States compare by excess weight first
+			// and cut second. Returns whether the pass improved on its starting state.
+			auto refine_pass(std::size_t patience) -> bool {
+				auto const& g = *this->g_;
+				auto const n = g.node_count();
+				std::fill(this->locked_.begin(), this->locked_.end(), char{0});
+				this->heap_.clear();
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					this->push(u);
+				}
+				auto moves = std::vector<std::pair<std::size_t, std::size_t>>{};
+				auto change = 0.0;
+				auto best = std::pair(this->excess_, 0.0);
+				auto best_moves = std::size_t{0};
+				auto since_best = std::size_t{0};
+				while (not this->heap_.empty() and since_best < patience) {
+					std::pop_heap(this->heap_.begin(), this->heap_.end());
+					auto const [gain, u] = this->heap_.back();
+					this->heap_.pop_back();
+					if (this->locked_[u] != 0) {
+						continue;
+					}
+					auto const [current, target] = this->best_move(u, false);
+					if (target == no_part) {
+						continue;
+					}
+					if (current != gain) {
+						this->heap_.emplace_back(current, u);
+						std::push_heap(this->heap_.begin(), this->heap_.end());
+						continue;
+					}
+					moves.emplace_back(u, this->parts_[u]);
+					this->move(u, target);
+					this->locked_[u] = 1;
+					change -= gain;
+					if (std::pair(this->excess_, change) < best) {
+						best = std::pair(this->excess_, change);
+						best_moves = moves.size();
+						since_best = 0U;
+					}
+					else {
+						++since_best;
+					}
+					for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+						if (this->locked_[g.targets[e]] == 0) {
+							this->push(g.targets[e]);
+						}
+					}
+				}
+				while (moves.size() > best_moves) {
+					this->move(moves.back().first, moves.back().second);
+					moves.pop_back();
+				}
+				return best_moves > 0U;
+			}
+
+		private:
+			community_graph const* g_;
+			std::vector<std::size_t> const* weights_;
+			std::size_t max_part_;
+			std::vector<std::size_t> parts_;
+			std::vector<std::size_t> part_weights_;
+			std::size_t excess_{0};
+			label_weights connections_;
+			std::vector<char> locked_;
+			std::vector<std::pair<double, std::size_t>> heap_;
+
+			// Whether u may move to part q: q must have room for it, or u's part must be over the
+			// limit and end up heavier than q.
+			[[nodiscard]] auto allowed(std::size_t u, std::size_t q) const noexcept -> bool {
+				auto const w = (*this->weights_)[u];
+				auto const from = this->part_weights_[this->parts_[u]];
+				auto const to = this->part_weights_[q] + w;
+				return to <= this->max_part_ or (from > this->max_part_ and to < from);
+			}
+
+			// The allowed move of u that cuts the most edge weight, and that weight, or no_part if
+			// u has no neighbour in another part it may join. With `anywhere`, u may also go to
+			// the lightest part when no neighbouring part will take it.
+			auto best_move(std::size_t u, bool anywhere) -> std::pair<double, std::size_t> {
+				auto const& g = *this->g_;
+				auto& connections = this->connections_;
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+					connections.add(this->parts_[g.targets[e]], g.weights[e]);
+				}
+				auto const own = this->parts_[u];
+				auto const internal = connections.weight(own);
+				auto best = std::pair(-std::numeric_limits<double>::infinity(), no_part);
+				for (auto const q : connections.touched()) {
+					auto const gain = connections.weight(q) - internal;
+					if (q != own and this->allowed(u, q) and gain > best.first) {
+						best = std::pair(gain, q);
+					}
+				}
+				connections.clear();
+				if (best.second == no_part and anywhere) {
+					auto const lightest = static_cast<std::size_t>(
+					   std::min_element(this->part_weights_.cbegin(), this->part_weights_.cend())
+					   - this->part_weights_.cbegin());
+					if (lightest != own and this->allowed(u, lightest)) {
+						best = std::pair(-internal, lightest);
+					}
+				}
+				return best;
+			}
+
+			auto push(std::size_t u) -> void {
+				auto const move = this->best_move(u, false);
+				if (move.second != no_part) {
+					this->heap_.emplace_back(move.first, u);
+					std::push_heap(this->heap_.begin(), this->heap_.end());
+				}
+			}
+
+			auto move(std::size_t u, std::size_t to) -> void {
+				auto const w = (*this->weights_)[u];
+				auto const from = this->parts_[u];
+				auto const over = [this](std::size_t weight) {
+					return weight > this->max_part_ ? weight - this->max_part_ : std::size_t{0};
+				};
+				this->excess_ -= over(this->part_weights_[from]) + over(this->part_weights_[to]);
+				this->part_weights_[from] -= w;
+				this->part_weights_[to] += w;
+				this->excess_ += over(this->part_weights_[from]) + over(this->part_weights_[to]);
+				this->parts_[u] = to;
+			}
+		};
+
+		// Rebalances, then runs FM passes until one gains nothing.
+		inline auto refine(partition_state& state, std::size_t passes) -> void {
+			auto const patience = std::max(std::size_t{64}, state.parts().size() / 100U);
+			state.rebalance();
+			for (auto pass = std::size_t{0}; pass < passes; ++pass) {
+				if (not state.refine_pass(patience)) {
+					break;
+				}
+			}
+		}
+
+		// Greedy graph growing: each part but the last starts from a random unassigned node and
+		// repeatedly takes the unassigned node most strongly connected to it, until it reaches
+		// an even share of the weight. The last part takes whatever is left.
+		inline auto grow_partition(community_graph const& g,
+		                           std::vector<std::size_t> const& weights,
+		                           std::size_t parts,
+		                           std::mt19937& engine) -> std::vector<std::size_t> {
+			auto const n = g.node_count();
+			auto const total = std::accumulate(weights.cbegin(), weights.cend(), std::size_t{0});
+			auto assignment = std::vector<std::size_t>(n, no_part);
+			auto const order = shuffled_nodes(n, engine);
+			auto next_seed = std::size_t{0};
+			auto strength = std::vector<double>(n, 0.0);
+			auto touched = std::vector<std::size_t>{};
+			auto heap = std::vector<std::pair<double, std::size_t>>{};
+			auto assigned = std::size_t{0};
+			for (auto p = std::size_t{0}; p + 1U < parts and assigned < total; ++p) {
+				auto const target = static_cast<double>(total) * static_cast<double>(p + 1U)
+				                    / static_cast<double>(parts);
+				heap.clear();
+				for (auto const v : touched) {
+					strength[v] = 0.0;
+				}
+				touched.clear();
+				while (static_cast<double>(assigned) < target) {
+					auto u = no_part;
+					while (not heap.empty() and u == no_part) {
+						std::pop_heap(heap.begin(), heap.end());
+						auto const [s, v] = heap.back();
+						heap.pop_back();
+						if (assignment[v] == no_part and s == strength[v]) {
+							u = v;
+						}
+					}
+					while (u == no_part) {
+						if (assignment[order[next_seed]] == no_part) {
+							u = order[next_seed];
+						}
+						++next_seed;
+					}
+					assignment[u] = p;
+					assigned += weights[u];
+					for (auto e = g.offsets[u]; e < g.offsets[u + 1U]; ++e) {
+						auto const v = g.targets[e];
+						if (assignment[v] == no_part) {
+							if (strength[v] == 0.0) {
+								touched.push_back(v);
+							}
+							strength[v] += g.weights[e];
+							heap.emplace_back(strength[v], v);
+							std::push_heap(heap.begin(), heap.end());
+						}
+					}
+				}
+			}
+			for (auto& part : assignment) {
+				part = part == no_part ? parts - 1U : part;
+			}
+			return assignment;
+		}
+
+		// Multilevel k-way partitioning after Karypis and Kumar. The graph is coarsened by
+		// heavy-edge matching until it is small or stops shrinking. The coarsest graph gets the
+		// best of several grown and refined partitions, found in parallel. That partition is
+		// then projected back up one level at a time, with FM refinement at every level.
+		inline auto multilevel_partition(community_graph g,
+		                                 std::size_t parts,
+		                                 partition_options const& options)
+		   -> std::vector<std::size_t> {
+			auto const n = g.node_count();
+			auto const max_part = std::max(
+			   (n + parts - 1U) / parts,
+			   static_cast<std::size_t>((1.0 + options.imbalance) * static_cast<double>(n)
+			                            / static_cast<double>(parts)));
+			auto engine = std::mt19937{options.seed};
+
+			auto graphs = std::vector<community_graph>{};
+			auto weights = std::vector<std::vector<std::size_t>>{std::vector<std::size_t>(n, 1U)};
+			auto maps = std::vector<std::vector<std::size_t>>{};
+			auto const small = options.coarsest_nodes_per_part * parts;
+			auto const max_node = std::max(std::size_t{1},
+			                               (3U * n) / (2U * std::max(small, std::size_t{1})));
+			graphs.push_back(std::move(g));
+			while (graphs.back().node_count() > small) {
+				auto const& fine = graphs.back();
+				auto [coarse, count] = heavy_edge_matching(fine, weights.back(), max_node, engine);
+				if (count * 20U > fine.node_count() * 19U) {
+					break;
+				}
+				auto coarse_weights = std::vector<std::size_t>(count, 0U);
+				for (auto u = std::size_t{0}; u < fine.node_count(); ++u) {
+					coarse_weights[coarse[u]] += weights.back()[u];
+				}
+				auto next = coarsen(fine, coarse, count);
+				graphs.push_back(std::move(next));
+				weights.push_back(std::move(coarse_weights));
+				maps.push_back(std::move(coarse));
+			}
+
+			// Initial partitions, each with its own engine so the result does not depend on the
+			// thread count.
+			auto const tries = std::max(std::size_t{1}, options.initial_tries);
+			auto seeds = std::vector<std::mt19937::result_type>(tries);
+			for (auto& seed : seeds) {
+				seed = engine();
+			}
+			auto candidates = std::vector<std::vector<std::size_t>>(tries);
+			auto scores = std::vector<std::pair<std::size_t, double>>(tries);
+			parallel_for_dynamic(
+			   0U,
+			   tries,
+			   [&](std::size_t t, std::size_t) {
+				   auto try_engine = std::mt19937{seeds[t]};
+				   auto state = partition_state(graphs.back(), weights.back(), parts, max_part);
+				   state.assign(grow_partition(graphs.back(), weights.back(), parts, try_engine));
+				   refine(state, options.refinement_passes);
+				   scores[t] = std::pair(state.excess(), state.cut());
+				   candidates[t] = state.parts();
+			   },
+			   1U);
+			auto const best = static_cast<std::size_t>(
+			   std::min_element(scores.cbegin(), scores.cend()) - scores.cbegin());
+			auto assignment = std::move(candidates[best]);
+
+			for (auto level = maps.size(); level-- > 0U;) {
+				auto projected = std::vector<std::size_t>(maps[level].size());
+				for (auto u = std::size_t{0}; u < projected.size(); ++u) {
+					projected[u] = assignment[maps[level][u]];
+				}
+				auto state = partition_state(graphs[level], weights[level], parts, max_part);
+				state.assign(std::move(projected));
+				refine(state, options.refinement_passes);
+				assignment = state.parts();
+			}
+			return assignment;
+		}
+
+		template<typename N, typename E>
+		auto check_partition_weights(csr<N, E> const& g, char const* message) -> void {
+			if constexpr (std::is_arithmetic_v<E>) {
+				if (std::any_of(g.weights.cbegin(), g.weights.cend(), [](E w) { return w < E{0}; })) {
+					throw std::runtime_error(message);
+				}
+			}
+		}
+	} // namespace detail
+
+	// Splits the nodes of `g` into `parts` parts of near-equal size with as little edge weight
+	// between them as possible, and returns a part id below `parts` for every node, in the same
+	// order as g.nodes(). No part holds more than options.imbalance over an even share of nodes.
+	// Edges are treated as undirected and weigh their weight if E is arithmetic (which must then
+	// be non-negative) or 1 otherwise; multi-edges add up and self-loops never count.
+	//
+	// The partitioner is multilevel: heavy-edge matching coarsens the graph, the coarsest graph
+	// is partitioned by greedy growing, and Fiduccia-Mattheyses refinement improves the cut at
+	// every level on the way back up. The initial tries run on std::thread workers. The result
+	// depends only on options.seed, not on the number of threads.
+	template<typename N, typename E>
+	auto partition(graph<N, E> const& g,
+	               std::size_t parts,
+	               partition_options const& options = {}) -> std::vector<std::size_t> {
+		if (parts == 0U) {
+			throw std::runtime_error("Cannot call gdwg::partition with zero parts");
+		}
+		auto const adjacency = g.to_csr();
+		detail::check_partition_weights(adjacency,
+		                                "Cannot call gdwg::partition on a graph with a negative "
+		                                "weight");
+		if (parts == 1U or adjacency.node_count() == 0U) {
+			return std::vector<std::size_t>(adjacency.node_count(), 0U);
+		}
+		return detail::multilevel_partition(detail::make_community_graph(adjacency), parts, options);
+	}
+
+	// Total weight of the edges of `g` whose endpoints lie in different parts, given one part id
+	// per node in the same order as g.nodes(). Edges weigh as in partition.
+	template<typename N, typename E>
+	auto edge_cut(graph<N, E> const& g, std::vector<std::size_t> const& parts) -> double {
+		auto const adjacency = g.to_csr();
+		if (parts.size() != adjacency.node_count()) {
+			throw std::runtime_error("Cannot call gdwg::edge_cut without exactly one part id per "
+			                         "node");
+		}
+		detail::check_partition_weights(adjacency,
+		                                "Cannot call gdwg::edge_cut on a graph with a negative "
+		                                "weight");
+		auto total = 0.0;
+		for (auto u = std::size_t{0}; u < adjacency.node_count(); ++u) {
+			for (auto e = adjacency.offsets[u]; e < adjacency.offsets[u + 1U]; ++e) {
+				if (parts[adjacency.targets[e]] != parts[u]) {
+					if constexpr (std::is_arithmetic_v<E>) {
+						total += static_cast<double>(adjacency.weights[e]);
+					}
+					else {
+						total += 1.0;
+					}
+				}
+			}
+		}
+		return total;
+	}
+} // namespace gdwg
+
+#endif // GDWG_PARTITION_HPP
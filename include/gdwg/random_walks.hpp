@@ -0,0 +1,347 @@
+#ifndef GDWG_RANDOM_WALKS_HPP
+#define GDWG_RANDOM_WALKS_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	struct walk_options {
+		// Nodes per walk, including the one it starts from.
+		std::size_t length = 80;
+		// Walks started from every node by random_walks.
+		std::size_t walks_per_node = 10;
+		// Whether each step is chosen in proportion to edge weight rather than uniformly.
+		bool weighted = false;
+		// node2vec return and in-out parameters. A small p favours stepping straight back and a
+		// small q favours moving away; both at 1 gives a plain first-order walk.
+		double p = 1.0;
+		double q = 1.0;
+		std::mt19937_64::result_type seed = std::mt19937_64::default_seed;
+	};
+
+	namespace detail {
+		// SplitMix64: one addition and three mixing steps per number, and cheap to seed, so every
+		// walk can have its own stream derived from its index.
+		class splitmix64 {
+		public:
+			using result_type = std::uint64_t;
+
+			splitmix64() noexcept = default;
+
+			explicit splitmix64(std::uint64_t state) noexcept
+			: state_(state) {}
+
+			static constexpr auto min() noexcept -> result_type {
+				return 0U;
+			}
+
+			static constexpr auto max() noexcept -> result_type {
+				return std::numeric_limits<result_type>::max();
+			}
+
+			auto operator()() noexcept -> result_type {
+				auto z = this->state_ += 0x9e3779b97f4a7c15U;
+				z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9U;
+				z = (z ^ (z >> 27U)) * 0x94d049bb133111ebU;
+				return z ^ (z >> 31U);
+			}
+
+		private:
+			std::uint64_t state_{0};
+		};
+	} // namespace detail
+
+	// Samples random walks over a graph from tables built once, so a step costs one random number
+	// and no allocation. Walks follow out-edges. Nodes are given as indices in the same order as
+	// g.nodes().
+	//
+	// A uniform walk picks each distinct out-neighbour with equal probability. A weighted walk
+	// picks a neighbour in proportion to the total weight of the edges to it, in O(1) through
+	// a per-node alias table. If E is not arithmetic, each edge weighs 1, so a multi-edge
+	// counts as many times as it has weights. Edges with zero weight are never taken.
+	//
+	// With p or q other than 1, the walk is node2vec's second-order walk. Having come from t to
+	// v, it weighs a step to x by 1/p if x is t, by 1 if t has an edge to x, and by 1/q
+	// otherwise. Instead of storing a table for every pair of edges, each step draws from v's
+	// first-order table and accepts the draw with probability proportional to that factor.
+	template<typename N, typename E>
+	class random_walker {
+	public:
+		using size_type = std::size_t;
+		// Fills the rest of a walk that reached a node with no way out.
+		static constexpr auto no_node = std::numeric_limits<size_type>::max();
+
+		explicit random_walker(graph<N, E> const& g, walk_options const& options = {})
+		: options_(options) {
+			if (not(options.p > 0.0) or not(options.q > 0.0)) {
+				throw std::runtime_error("Cannot call gdwg::random_walker with a non-positive p or q");
+			}
+			this->build(g);
+			auto const inverse_p = 1.0 / options.p;
+			auto const inverse_q = 1.0 / options.q;
+			this->second_order_ = options.p != 1.0 or options.q != 1.0;
+			auto const limit = std::max({inverse_p, 1.0, inverse_q});
+			this->return_factor_ = inverse_p / limit;
+			this->link_factor_ = 1.0 / limit;
+			this->away_factor_ = inverse_q / limit;
+		}
+
+		[[nodiscard]] auto nodes() const noexcept -> std::vector<N> const& {
+			return this->nodes_;
+		}
+
+		[[nodiscard]] auto length() const noexcept -> size_type {
+			return this->options_.length;
+		}
+
+		// Writes one walk per entry of `starts` into `out`, `length()` nodes each, back to back.
+		// Walks are split between std::thread workers. Every walk draws from its own random
+		// stream, fixed by the seed, `stream` and its position in `starts`, so the output does
+		// not depend on the number of threads. Pass a different `stream` for each batch.
+		auto walk(std::span<size_type const> starts,
+		          std::span<size_type> out,
+		          std::uint64_t stream = 0U) const -> void {
+			auto const length = this->options_.length;
+			if (out.size() != starts.size() * length) {
+				throw std::runtime_error("Cannot call gdwg::random_walker<N, E>::walk unless out "
+				                         "holds length() nodes per start");
+			}
+			if (std::any_of(starts.begin(), starts.end(), [this](size_type s) {
+				    return s >= this->nodes_.size();
+			    }))
+			{
+				throw std::runtime_error("Cannot call gdwg::random_walker<N, E>::walk with a start "
+				                         "that is not a node index");
+			}
+			if (length == 0U) {
+				return;
+			}
+			auto const base = this->options_.seed ^ detail::splitmix64(stream)();
+			detail::parallel_chunks(
+			   0U,
+			   starts.size(),
+			   [&](size_type first, size_type last, size_type) {
+				   for (auto w = first; w < last; w += interleave) {
+					   this->walk_group(w, std::min(w + interleave, last), starts, out, base);
+				   }
+			   },
+			   64U);
+		}
+
+	private:
+		static constexpr auto interleave = size_type{16};
+
+		walk_options options_;
+		std::vector<N> nodes_;
+		// Distinct out-neighbours of each node, sorted, without zero-weight ones when weighted.
+		std::vector<size_type> offsets_;
+		std::vector<size_type> targets_;
+		// Alias table for weighted walks: slot i of a row is kept with probability
+		// `probabilities_[i]` and otherwise replaced by the slot `aliases_[i]` of the same row.
+		std::vector<float> probabilities_;
+		std::vector<std::uint32_t> aliases_;
+		bool second_order_{false};
+		// node2vec factors divided by the largest of them, as acceptance probabilities.
+		double return_factor_{1.0};
+		double link_factor_{1.0};
+		double away_factor_{1.0};
+
+		auto build(graph<N, E> const& g) -> void {
+			auto adjacency = g.to_csr();
+			auto weights = std::vector<double>{};
+			this->offsets_.reserve(adjacency.node_count() + 1U);
+			this->offsets_.push_back(0U);
+			for (auto u = size_type{0}; u < adjacency.node_count(); ++u) {
+				// The weights of a multi-edge sit next to each other, so each run is one neighbour.
+				for (auto e = adjacency.offsets[u]; e < adjacency.offsets[u + 1U];) {
+					auto const v = adjacency.targets[e];
+					auto total = 0.0;
+					for (; e < adjacency.offsets[u + 1U] and adjacency.targets[e] == v; ++e) {
+						total += weight_of(adjacency.weights[e]);
+					}
+					if (not this->options_.weighted or total > 0.0) {
+						this->targets_.push_back(v);
+						weights.push_back(total);
+					}
+				}
+				this->offsets_.push_back(this->targets_.size());
+			}
+			this->nodes_ = std::move(adjacency.nodes);
+			if (this->options_.weighted) {
+				this->build_alias_tables(weights);
+			}
+		}
+
+		static auto weight_of(E const& w) -> double {
+			if constexpr (std::is_arithmetic_v<E>) {
+				if (w < E{0}) {
+					throw std::runtime_error("Cannot call gdwg::random_walker on a graph with a "
+					                         "negative weight");
+				}
+				return static_cast<double>(w);
+			}
+			else {
+				return 1.0;
+			}
+		}
+
+		// Vose's alias method, one row per node, with rows spread across workers.
+		auto build_alias_tables(std::vector<double> const& weights) -> void {
+			this->probabilities_.assign(this->targets_.size(), 1.0F);
+			this->aliases_.assign(this->targets_.size(), 0U);
+			detail::parallel_chunks(
+			   0U,
+			   this->nodes_.size(),
+			   [&](size_type first, size_type last, size_type) {
+				   auto scaled = std::vector<double>{};
+				   auto small = std::vector<std::uint32_t>{};
+				   auto large = std::vector<std::uint32_t>{};
+				   for (auto u = first; u < last; ++u) {
+					   auto const begin = this->offsets_[u];
+					   auto const degree = this->offsets_[u + 1U] - begin;
+					   auto total = 0.0;
+					   for (auto i = size_type{0}; i < degree; ++i) {
+						   total += weights[begin + i];
+					   }
+					   scaled.clear();
+					   small.clear();
+					   large.clear();
+					   for (auto i = size_type{0}; i < degree; ++i) {
+						   scaled.push_back(weights[begin + i] * static_cast<double>(degree) / total);
+						   (scaled.back() < 1.0 ? small : large).push_back(static_cast<std::uint32_t>(i));
+					   }
+					   while (not small.empty() and not large.empty()) {
+						   auto const s = small.back();
+						   small.pop_back();
+						   auto const l = large.back();
+						   this->probabilities_[begin + s] = static_cast<float>(scaled[s]);
+						   this->aliases_[begin + s] = l;
+						   scaled[l] -= 1.0 - scaled[s];
+						   if (scaled[l] < 1.0) {
+							   large.pop_back();
+							   small.push_back(l);
+						   }
+					   }
+					   // Whatever is left is 1 up to rounding, so it keeps its own slot.
+					   for (auto const i : small) {
+						   this->probabilities_[begin + i] = 1.0F;
+					   }
+					   for (auto const i : large) {
+						   this->probabilities_[begin + i] = 1.0F;
+					   }
+				   }
+			   });
+		}
+
+		// A first-order step from v, or no_node if v has no way out. The high half of one
+		// random number picks a slot and the low half flips the alias coin.
+		[[nodiscard]] auto step(size_type v, detail::splitmix64& engine) const -> size_type {
+			auto const begin = this->offsets_[v];
+			auto const degree = this->offsets_[v + 1U] - begin;
+			if (degree == 0U) {
+				return no_node;
+			}
+			auto const bits = engine();
+			auto slot = static_cast<size_type>(((bits >> 32U) * degree) >> 32U);
+			if (this->options_.weighted) {
+				auto const coin = static_cast<double>(bits & 0xffffffffU) * 0x1p-32;
+				if (coin >= static_cast<double>(this->probabilities_[begin + slot])) {
+					slot = this->aliases_[begin + slot];
+				}
+			}
+			return this->targets_[begin + slot];
+		}
+
+		[[nodiscard]] auto linked(size_type from, size_type to) const -> bool {
+			auto const row = std::span<size_type const>(this->targets_).subspan(
+			   this->offsets_[from], this->offsets_[from + 1U] - this->offsets_[from]);
+			return std::binary_search(row.begin(), row.end(), to);
+		}
+
+		// A node2vec step to a neighbour of `current`, having arrived from `previous`.
+		[[nodiscard]] auto second_order_step(size_type previous,
+		                                     size_type current,
+		                                     detail::splitmix64& engine) const -> size_type {
+			while (true) {
+				auto const next = this->step(current, engine);
+				if (next == no_node) {
+					return no_node;
+				}
+				auto const factor = next == previous                ? this->return_factor_
+				                    : this->linked(previous, next) ? this->link_factor_
+				                                                   : this->away_factor_;
+				if (static_cast<double>(engine() >> 11U) * 0x1p-53 < factor) {
+					return next;
+				}
+			}
+		}
+
+		// Runs walks [first, last) of a batch in lockstep, one step of each at a time, so that
+		// the memory accesses of different walks overlap instead of waiting on each other.
+		auto walk_group(size_type first,
+		                size_type last,
+		                std::span<size_type const> starts,
+		                std::span<size_type> out,
+		                std::uint64_t base) const -> void {
+			auto const length = this->options_.length;
+			auto engines = std::array<detail::splitmix64, interleave>{};
+			auto live = std::array<bool, interleave>{};
+			for (auto w = first; w < last; ++w) {
+				engines[w - first] = detail::splitmix64(base + w * 0xd1b54a32d192ed03U);
+				live[w - first] = true;
+				out[w * length] = starts[w];
+			}
+			for (auto i = size_type{1}; i < length; ++i) {
+				for (auto w = first; w < last; ++w) {
+					if (not live[w - first]) {
+						continue;
+					}
+					auto const walk = out.subspan(w * length, length);
+					auto& engine = engines[w - first];
+					auto const next = i == 1U or not this->second_order_
+					                     ? this->step(walk[i - 1U], engine)
+					                     : this->second_order_step(walk[i - 2U], walk[i - 1U], engine);
+					if (next == no_node) {
+						std::fill(walk.begin() + static_cast<std::ptrdiff_t>(i), walk.end(), no_node);
+						live[w - first] = false;
+					}
+					else {
+						walk[i] = next;
+					}
+				}
+			}
+		}
+	};
+
+	// `options.walks_per_node` walks from every node, each `options.length` nodes long, as node
+	// indices in the same order as g.nodes(). Walk r * n + u starts from node u, and a walk that
+	// reaches a node with no way out is padded with random_walker<N, E>::no_node.
+	template<typename N, typename E>
+	auto random_walks(graph<N, E> const& g, walk_options const& options = {})
+	   -> std::vector<std::size_t> {
+		auto const walker = random_walker<N, E>(g, options);
+		auto const n = walker.nodes().size();
+		auto starts = std::vector<std::size_t>(n * options.walks_per_node);
+		for (auto i = std::size_t{0}; i < starts.size(); ++i) {
+			starts[i] = i % n;
+		}
+		auto walks = std::vector<std::size_t>(starts.size() * options.length);
+		walker.walk(starts, walks);
+		return walks;
+	}
+} // namespace gdwg
+
+#endif // GDWG_RANDOM_WALKS_HPP
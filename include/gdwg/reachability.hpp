@@ -0,0 +1,293 @@
+#ifndef GDWG_REACHABILITY_HPP
+#define GDWG_REACHABILITY_HPP
+
+#include "gdwg/components.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// A 2-hop labelling for answering "can src reach dst?" in time proportional to two short
+	// labels. Strongly connected components are collapsed first, since their members share their
+	// answers. Every component then gets an `out` label of landmark components it reaches and
+	// an `in` label of landmark components that reach it. src reaches dst exactly when the two
+	// labels share a landmark. Labels come from pruned landmark labelling: landmarks are
+	// searched from in order of decreasing degree, and a search stops at any component whose
+	// labels already answer for that landmark, which keeps labels small on real graphs.
+	//
+	// The index is built from a snapshot and does not watch the graph. Report each change made
+	// to the graph to the matching member function. Inserted nodes and edges are folded into the
+	// labels, and any removal marks the index stale until rebuild() is called.
+	template<typename N>
+	class reachability_index {
+	public:
+		using size_type = std::size_t;
+
+		template<typename E>
+		explicit reachability_index(graph<N, E> const& g) {
+			this->rebuild(g);
+		}
+
+		// Rebuilds the whole index from `g`, clearing any staleness.
+		template<typename E>
+		auto rebuild(graph<N, E> const& g) -> void {
+			auto const adjacency = g.to_csr();
+			auto const n = adjacency.node_count();
+			this->nodes_ = adjacency.nodes;
+			this->components_ = strongly_connected_components(g);
+			auto const& components = this->components_;
+			auto const count =
+			   n == 0U ? size_type{0}
+			           : 1U + *std::max_element(components.cbegin(), components.cend());
+			this->successors_.assign(count, {});
+			this->predecessors_.assign(count, {});
+			for (auto u = size_type{0}; u < n; ++u) {
+				for (auto const v : adjacency.neighbours(u)) {
+					auto const from = this->components_[u];
+					auto const to = this->components_[v];
+					if (from != to) {
+						this->successors_[from].push_back(to);
+						this->predecessors_[to].push_back(from);
+					}
+				}
+			}
+			for (auto c = size_type{0}; c < count; ++c) {
+				deduplicate(this->successors_[c]);
+				deduplicate(this->predecessors_[c]);
+			}
+
+			auto order = std::vector<size_type>(count);
+			std::iota(order.begin(), order.end(), size_type{0});
+			auto const weight = [this](size_type c) {
+				return (this->successors_[c].size() + 1U) * (this->predecessors_[c].size() + 1U);
+			};
+			std::stable_sort(order.begin(), order.end(), [&](size_type a, size_type b) {
+				return weight(a) > weight(b);
+			});
+
+			this->out_labels_.assign(count, {});
+			this->in_labels_.assign(count, {});
+			this->landmarks_.clear();
+			this->visited_.assign(count, 0);
+			for (auto const c : order) {
+				this->add_landmark(c);
+			}
+			this->stale_ = false;
+		}
+
+		// Whether a removal has been reported since the index was last built.
+		[[nodiscard]] auto stale() const noexcept -> bool {
+			return this->stale_;
+		}
+
+		// Whether `dst` can be reached from `src` along zero or more edges.
+		[[nodiscard]] auto reachable(N const& src, N const& dst) const -> bool {
+			if (this->stale_) {
+				throw std::runtime_error("Cannot call gdwg::reachability_index<N>::reachable on a "
+				                         "stale index without calling rebuild first");
+			}
+			auto const s = this->find(src);
+			auto const d = this->find(dst);
+			if (s == this->nodes_.size() or d == this->nodes_.size()) {
+				throw std::runtime_error("Cannot call gdwg::reachability_index<N>::reachable if src "
+				                         "or dst node don't exist in the index");
+			}
+			return this->reaches(this->components_[s], this->components_[d]);
+		}
+
+		// Adds a node without edges, as its own component. Returns false if it already exists.
+		auto insert_node(N const& value) -> bool {
+			auto const itr = std::lower_bound(this->nodes_.cbegin(), this->nodes_.cend(), value);
+			if (itr != this->nodes_.cend() and not(value < *itr)) {
+				return false;
+			}
+			auto const c = this->successors_.size();
+			auto const position = itr - this->nodes_.cbegin();
+			this->nodes_.insert(itr, value);
+			this->components_.insert(this->components_.cbegin() + position, c);
+			this->successors_.emplace_back();
+			this->predecessors_.emplace_back();
+			this->out_labels_.emplace_back();
+			this->in_labels_.emplace_back();
+			this->visited_.push_back(0);
+			this->add_landmark(c);
+			return true;
+		}
+
+		// Records an edge from `src` to `dst`. If dst was not already reachable, every landmark in
+		// src's in label resumes its forward search from dst. The searches prune against the
+		// labels from before the edge, and their additions are applied together afterwards. Every
+		// newly reachable pair then shares the landmark that connected its source to src.
+		// Components joined into a cycle by the edge stay separate, which only costs label space.
+		auto insert_edge(N const& src, N const& dst) -> void {
+			auto const s = this->find(src);
+			auto const d = this->find(dst);
+			if (s == this->nodes_.size() or d == this->nodes_.size()) {
+				throw std::runtime_error("Cannot call gdwg::reachability_index<N>::insert_edge when "
+				                         "either src or dst node does not exist");
+			}
+			auto const from = this->components_[s];
+			auto const to = this->components_[d];
+			if (this->stale_ or this->reaches(from, to)) {
+				return;
+			}
+			add_sorted(this->successors_[from], to);
+			add_sorted(this->predecessors_[to], from);
+			auto additions = std::vector<std::pair<size_type, size_type>>{};
+			for (auto const rank : this->in_labels_[from]) {
+				auto const landmark = this->landmarks_[rank];
+				this->search(to, this->successors_, [&](size_type v) {
+					if (this->reaches(landmark, v)) {
+						return false;
+					}
+					additions.emplace_back(v, rank);
+					return true;
+				});
+			}
+			for (auto const& [v, rank] : additions) {
+				add_sorted(this->in_labels_[v], rank);
+			}
+		}
+
+		// Records the removal of an edge, which makes the index stale.
+		auto erase_edge(N const&, N const&) noexcept -> void {
+			this->stale_ = true;
+		}
+
+		// Records the removal of a node, which makes the index stale.
+		auto erase_node(N const&) noexcept -> void {
+			this->stale_ = true;
+		}
+
+	private:
+		std::vector<N> nodes_;
+		std::vector<size_type> components_;
+		std::vector<std::vector<size_type>> successors_;
+		std::vector<std::vector<size_type>> predecessors_;
+		// Labels hold landmark ranks, sorted, so a query is a single merge.
+		std::vector<std::vector<size_type>> out_labels_;
+		std::vector<std::vector<size_type>> in_labels_;
+		// The component of each landmark rank.
+		std::vector<size_type> landmarks_;
+		std::vector<char> visited_;
+		std::vector<size_type> queue_;
+		bool stale_{false};
+
+		static auto deduplicate(std::vector<size_type>& values) -> void {
+			std::sort(values.begin(), values.end());
+			values.erase(std::unique(values.begin(), values.end()), values.end());
+		}
+
+		static auto add_sorted(std::vector<size_type>& values, size_type value) -> void {
+			if (values.empty() or values.back() < value) {
+				values.push_back(value);
+				return;
+			}
+			auto const itr = std::lower_bound(values.begin(), values.end(), value);
+			if (*itr != value) {
+				values.insert(itr, value);
+			}
+		}
+
+		[[nodiscard]] auto find(N const& value) const -> size_type {
+			auto const itr = std::lower_bound(this->nodes_.cbegin(), this->nodes_.cend(), value);
+			if (itr == this->nodes_.cend() or value < *itr) {
+				return this->nodes_.size();
+			}
+			return static_cast<size_type>(itr - this->nodes_.cbegin());
+		}
+
+		[[nodiscard]] auto reaches(size_type from, size_type to) const noexcept -> bool {
+			if (from == to) {
+				return true;
+			}
+			auto const& out = this->out_labels_[from];
+			auto const& in = this->in_labels_[to];
+			auto i = out.cbegin();
+			auto j = in.cbegin();
+			while (i != out.cend() and j != in.cend()) {
+				if (*i == *j) {
+					return true;
+				}
+				if (*i < *j) {
+					++i;
+				}
+				else {
+					++j;
+				}
+			}
+			return false;
+		}
+
+		// Makes component `c` the next landmark and runs its pruned searches in both directions.
+		auto add_landmark(size_type c) -> void {
+			auto const rank = this->landmarks_.size();
+			this->landmarks_.push_back(c);
+			add_sorted(this->out_labels_[c], rank);
+			add_sorted(this->in_labels_[c], rank);
+			for (auto const v : this->successors_[c]) {
+				this->label_forward(rank, v);
+			}
+			for (auto const v : this->predecessors_[c]) {
+				this->label_backward(rank, v);
+			}
+		}
+
+		// Breadth-first search from `start` along successors, adding landmark `rank` to the in
+		// label of every component it reaches that the labels don't already answer for.
+		auto label_forward(size_type rank, size_type start) -> void {
+			auto const landmark = this->landmarks_[rank];
+			this->search(start, this->successors_, [&](size_type v) {
+				if (this->reaches(landmark, v)) {
+					return false;
+				}
+				add_sorted(this->in_labels_[v], rank);
+				return true;
+			});
+		}
+
+		// As label_forward, along predecessors and into out labels.
+		auto label_backward(size_type rank, size_type start) -> void {
+			auto const landmark = this->landmarks_[rank];
+			this->search(start, this->predecessors_, [&](size_type v) {
+				if (this->reaches(v, landmark)) {
+					return false;
+				}
+				add_sorted(this->out_labels_[v], rank);
+				return true;
+			});
+		}
+
+		// Visits components from `start` along `adjacency`, expanding those for which
+		// `label(v)` returns true.
+		template<typename Label>
+		auto search(size_type start,
+		            std::vector<std::vector<size_type>> const& adjacency,
+		            Label const& label) -> void {
+			this->queue_.assign(1U, start);
+			this->visited_[start] = 1;
+			for (auto i = size_type{0}; i < this->queue_.size(); ++i) {
+				auto const u = this->queue_[i];
+				if (not label(u)) {
+					continue;
+				}
+				for (auto const v : adjacency[u]) {
+					if (this->visited_[v] == 0) {
+						this->visited_[v] = 1;
+						this->queue_.push_back(v);
+					}
+				}
+			}
+			for (auto const u : this->queue_) {
+				this->visited_[u] = 0;
+			}
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_REACHABILITY_HPP
@@ -0,0 +1,202 @@
+#ifndef GDWG_SPANNING_FOREST_HPP
+#define GDWG_SPANNING_FOREST_HPP
+
+#include "gdwg/components.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace gdwg {
+	// Selects the minimum_spanning_forest implementation. `automatic` picks `kruskal` for
+	// moderate graphs or when only one thread is available, and `boruvka` otherwise.
+	enum class spanning_forest_algorithm { automatic, kruskal, boruvka };
+
+	namespace detail {
+		// The undirected candidate edges of a graph: the lightest weight of every multi-edge,
+		// without self-loops. Edges are ranked by weight and then by position, which makes the
+		// order strict, so the minimum spanning forest is unique and every algorithm finds the
+		// same one.
+		template<typename N, typename E>
+		struct forest_edges {
+			csr<N, E> adjacency;
+			std::vector<std::size_t> sources;
+			std::vector<std::size_t> slots;
+
+			explicit forest_edges(graph<N, E> const& g)
+			: adjacency{g.to_csr().lightest_edges()} {
+				for (auto u = std::size_t{0}; u < this->adjacency.node_count(); ++u) {
+					for (auto e = this->adjacency.offsets[u]; e < this->adjacency.offsets[u + 1U]; ++e) {
+						if (this->adjacency.targets[e] != u) {
+							this->sources.push_back(u);
+							this->slots.push_back(e);
+						}
+					}
+				}
+			}
+
+			[[nodiscard]] auto size() const noexcept -> std::size_t {
+				return this->slots.size();
+			}
+
+			[[nodiscard]] auto target(std::size_t i) const noexcept -> std::size_t {
+				return this->adjacency.targets[this->slots[i]];
+			}
+
+			[[nodiscard]] auto weight(std::size_t i) const noexcept -> E const& {
+				return this->adjacency.weights[this->slots[i]];
+			}
+
+			[[nodiscard]] auto lighter(std::size_t i, std::size_t j) const noexcept -> bool {
+				if (this->weight(i) < this->weight(j)) {
+					return true;
+				}
+				return not(this->weight(j) < this->weight(i)) and i < j;
+			}
+
+			[[nodiscard]] auto to_value(std::size_t i) const -> typename graph<N, E>::value_type {
+				return {this->adjacency.nodes[this->sources[i]],
+				        this->adjacency.nodes[this->target(i)],
+				        this->weight(i)};
+			}
+		};
+
+		// Kruskal: sort every candidate edge in parallel, then keep each one that joins two
+		// different trees.
+		template<typename N, typename E>
+		auto kruskal_forest(forest_edges<N, E> const& edges) -> std::vector<std::size_t> {
+			auto order = std::vector<std::size_t>(edges.size());
+			std::iota(order.begin(), order.end(), std::size_t{0});
+			parallel_sort(order.begin(), order.end(), [&edges](std::size_t i, std::size_t j) {
+				return edges.lighter(i, j);
+			});
+
+			auto trees = concurrent_union_find(edges.adjacency.node_count());
+			auto chosen = std::vector<std::size_t>{};
+			for (auto const i : order) {
+				if (trees.unite(edges.sources[i], edges.target(i))) {
+					chosen.push_back(i);
+				}
+			}
+			return chosen;
+		}
+
+		// Boruvka: in every round, each tree picks its lightest edge to another tree, all picked
+		// edges are added at once, and edges that now lie inside a single tree are dropped. Both
+		// the search and the merge run across std::thread workers; since the edge order is strict,
+		// the picked edges can never form a cycle.
+		template<typename N, typename E>
+		auto boruvka_forest(forest_edges<N, E> const& edges) -> std::vector<std::size_t> {
+			constexpr auto none = std::numeric_limits<std::size_t>::max();
+			constexpr auto grain = std::size_t{4096};
+			auto const n = edges.adjacency.node_count();
+			auto trees = concurrent_union_find(n);
+			auto lightest = std::vector<std::atomic<std::size_t>>(n);
+			auto live = std::vector<std::size_t>(edges.size());
+			std::iota(live.begin(), live.end(), std::size_t{0});
+			auto chosen = std::vector<std::size_t>{};
+
+			auto const offer = [&](std::size_t tree, std::size_t i) {
+				auto current = lightest[tree].load(std::memory_order_relaxed);
+				while ((current == none or edges.lighter(i, current))
+				       and not lightest[tree].compare_exchange_weak(current, i))
+				{
+				}
+			};
+			while (not live.empty()) {
+				for (auto& edge : lightest) {
+					edge.store(none, std::memory_order_relaxed);
+				}
+				parallel_chunks(
+				   0U,
+				   live.size(),
+				   [&](std::size_t first, std::size_t last, std::size_t) {
+					   for (auto k = first; k < last; ++k) {
+						   auto const i = live[k];
+						   offer(trees.find(edges.sources[i]), i);
+						   offer(trees.find(edges.target(i)), i);
+					   }
+				   },
+				   grain);
+
+				auto picked = std::vector<std::vector<std::size_t>>(worker_count(n, grain));
+				parallel_chunks(
+				   0U,
+				   n,
+				   [&](std::size_t first, std::size_t last, std::size_t worker) {
+					   for (auto tree = first; tree < last; ++tree) {
+						   auto const i = lightest[tree].load(std::memory_order_relaxed);
+						   if (i != none and trees.unite(edges.sources[i], edges.target(i))) {
+							   picked[worker].push_back(i);
+						   }
+					   }
+				   },
+				   grain);
+				auto const before = chosen.size();
+				for (auto const& part : picked) {
+					chosen.insert(chosen.end(), part.cbegin(), part.cend());
+				}
+				if (chosen.size() == before) {
+					break;
+				}
+
+				std::erase_if(live, [&](std::size_t i) {
+					return trees.find(edges.sources[i]) == trees.find(edges.target(i));
+				});
+			}
+
+			std::sort(chosen.begin(), chosen.end(), [&edges](std::size_t i, std::size_t j) {
+				return edges.lighter(i, j);
+			});
+			return chosen;
+		}
+	} // namespace detail
+
+	// A minimum spanning forest of the undirected view of `g`, in which each multi-edge weighs as
+	// much as its lightest weight. Returns the chosen edges, lightest first, each in the direction
+	// it has in `g`. Ties are broken consistently, so both algorithms return the same forest.
+	template<typename N, typename E>
+	auto minimum_spanning_forest(graph<N, E> const& g,
+	                             spanning_forest_algorithm algorithm =
+	                                spanning_forest_algorithm::automatic)
+	   -> std::vector<typename graph<N, E>::value_type> {
+		constexpr auto parallel_threshold = std::size_t{1} << 20U;
+		auto const edges = detail::forest_edges<N, E>(g);
+		if (algorithm == spanning_forest_algorithm::automatic) {
+			algorithm = edges.size() < parallel_threshold or max_threads() == 1U
+			               ? spanning_forest_algorithm::kruskal
+			               : spanning_forest_algorithm::boruvka;
+		}
+		auto const chosen = algorithm == spanning_forest_algorithm::kruskal
+		                       ? detail::kruskal_forest(edges)
+		                       : detail::boruvka_forest(edges);
+
+		auto forest = std::vector<typename graph<N, E>::value_type>{};
+		forest.reserve(chosen.size());
+		for (auto const i : chosen) {
+			forest.push_back(edges.to_value(i));
+		}
+		return forest;
+	}
+
+	// As minimum_spanning_forest, but returned as a graph with every node of `g` and only the
+	// forest's edges.
+	template<typename N, typename E>
+	auto minimum_spanning_forest_graph(graph<N, E> const& g,
+	                                   spanning_forest_algorithm algorithm =
+	                                      spanning_forest_algorithm::automatic) -> graph<N, E> {
+		auto const nodes = g.nodes();
+		auto forest = graph<N, E>(nodes.cbegin(), nodes.cend());
+		for (auto const& [from, to, weight] : minimum_spanning_forest(g, algorithm)) {
+			forest.insert_edge(from, to, weight);
+		}
+		return forest;
+	}
+} // namespace gdwg
+
+#endif // GDWG_SPANNING_FOREST_HPP
@@ -0,0 +1,365 @@
+#ifndef GDWG_SUBGRAPH_MATCHING_HPP
+#define GDWG_SUBGRAPH_MATCHING_HPP
+
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Which embeddings of a pattern count as matches. Under `monomorphism` every pattern edge
+	// must be present between the matched target nodes. Under `isomorphism` the match must also
+	// be induced: target edges between matched nodes must be present in the pattern as well.
+	enum class subgraph_kind { isomorphism, monomorphism };
+
+	namespace detail {
+		inline constexpr auto unmatched = std::numeric_limits<std::size_t>::max();
+
+		// The default node and edge predicate.
+		struct match_anything {
+			template<typename A, typename B>
+			auto operator()(A const&, B const&) const noexcept -> bool {
+				return true;
+			}
+		};
+
+		// A graph snapshot for matching: the CSR for edge lookups, plus the distinct in- and
+		// out-neighbours of every node without self-loops, to generate candidates from.
+		template<typename N, typename E>
+		struct match_graph {
+			csr<N, E> edges;
+			std::vector<std::size_t> out_offsets;
+			std::vector<std::size_t> out_targets;
+			std::vector<std::size_t> in_offsets;
+			std::vector<std::size_t> in_targets;
+
+			explicit match_graph(graph<N, E> const& g)
+			: edges(g.to_csr()) {
+				distinct_neighbours(this->edges, this->out_offsets, this->out_targets);
+				distinct_neighbours(this->edges.transpose(), this->in_offsets, this->in_targets);
+			}
+
+			[[nodiscard]] auto node_count() const noexcept -> std::size_t {
+				return this->edges.node_count();
+			}
+
+			[[nodiscard]] auto out(std::size_t u) const noexcept -> std::span<std::size_t const> {
+				return {this->out_targets.data() + this->out_offsets[u],
+				        this->out_offsets[u + 1U] - this->out_offsets[u]};
+			}
+
+			[[nodiscard]] auto in(std::size_t u) const noexcept -> std::span<std::size_t const> {
+				return {this->in_targets.data() + this->in_offsets[u],
+				        this->in_offsets[u + 1U] - this->in_offsets[u]};
+			}
+
+			// Every weight of the edges from u to v, empty if there are none.
+			[[nodiscard]] auto weights(std::size_t u, std::size_t v) const -> std::span<E const> {
+				auto const row = this->edges.neighbours(u);
+				auto const [first, last] = std::equal_range(row.begin(), row.end(), v);
+				return {this->edges.weights.data() + this->edges.offsets[u]
+				           + static_cast<std::size_t>(first - row.begin()),
+				        static_cast<std::size_t>(last - first)};
+			}
+
+		private:
+			static auto distinct_neighbours(csr<N, E> const& g,
+			                                std::vector<std::size_t>& offsets,
+			                                std::vector<std::size_t>& targets) -> void {
+				offsets.assign(1U, 0U);
+				for (auto u = std::size_t{0}; u < g.node_count(); ++u) {
+					auto const row = g.neighbours(u);
+					for (auto i = std::size_t{0}; i < row.size(); ++i) {
+						if (row[i] != u and (i == 0U or row[i] != row[i - 1U])) {
+							targets.push_back(row[i]);
+						}
+					}
+					offsets.push_back(targets.size());
+				}
+			}
+		};
+
+		// One depth-first search over the pattern in a fixed order. Each step after a
+		// component's first takes its candidates from the neighbours of an already matched
+		// node, and a candidate is kept only if it passes the node filters and every pattern
+		// pair it closes agrees with the target.
+		template<typename N1,
+		         typename E1,
+		         typename N2,
+		         typename E2,
+		         typename NodeMatch,
+		         typename EdgeMatch,
+		         typename Report>
+		class subgraph_search {
+		public:
+			subgraph_search(match_graph<N1, E1> const& pattern,
+			                match_graph<N2, E2> const& target,
+			                subgraph_kind kind,
+			                std::vector<std::size_t> const& order,
+			                std::vector<std::size_t> const& parents,
+			                std::vector<char> const& parent_out,
+			                NodeMatch const& node_match,
+			                EdgeMatch const& edge_match,
+			                Report const& report)
+			: pattern_(pattern)
+			, target_(target)
+			, kind_(kind)
+			, order_(order)
+			, parents_(parents)
+			, parent_out_(parent_out)
+			, node_match_(node_match)
+			, edge_match_(edge_match)
+			, report_(report)
+			, mapping_(pattern.node_count(), unmatched)
+			, used_(target.node_count(), 0) {}
+
+			// Searches every match with the first pattern node in the order mapped to `root`.
+			// Returns false once the report asks to stop.
+			auto run(std::size_t root) -> bool {
+				return this->try_extend(0U, root);
+			}
+
+			// Whether target node `t` passes the filters for pattern node `p` that do not depend
+			// on the rest of the match. A pattern node's distinct neighbours must all map to
+			// distinct neighbours of its image, so the image's degrees can only be larger.
+			auto admits(std::size_t p, std::size_t t) const -> bool {
+				return this->target_.out(t).size() >= this->pattern_.out(p).size()
+				       and this->target_.in(t).size() >= this->pattern_.in(p).size()
+				       and static_cast<bool>(std::invoke(this->node_match_,
+				                                         this->pattern_.edges.nodes[p],
+				                                         this->target_.edges.nodes[t]));
+			}
+
+		private:
+			match_graph<N1, E1> const& pattern_;
+			match_graph<N2, E2> const& target_;
+			subgraph_kind kind_;
+			std::vector<std::size_t> const& order_;
+			std::vector<std::size_t> const& parents_;
+			std::vector<char> const& parent_out_;
+			NodeMatch const& node_match_;
+			EdgeMatch const& edge_match_;
+			Report const& report_;
+			std::vector<std::size_t> mapping_;
+			std::vector<char> used_;
+
+			auto try_extend(std::size_t depth, std::size_t t) -> bool {
+				auto const p = this->order_[depth];
+				if (not this->feasible(depth, p, t)) {
+					return true;
+				}
+				this->mapping_[p] = t;
+				this->used_[t] = 1;
+				auto const go_on = this->extend(depth + 1U);
+				this->used_[t] = 0;
+				this->mapping_[p] = unmatched;
+				return go_on;
+			}
+
+			auto extend(std::size_t depth) -> bool {
+				if (depth == this->order_.size()) {
+					return this->report_(this->mapping_);
+				}
+				auto const parent = this->parents_[depth];
+				if (parent == unmatched) {
+					// A later component of the pattern may start anywhere in the target.
+					for (auto t = std::size_t{0}; t < this->target_.node_count(); ++t) {
+						if (not this->try_extend(depth, t)) {
+							return false;
+						}
+					}
+					return true;
+				}
+				auto const image = this->mapping_[parent];
+				auto const next = this->parent_out_[depth] != 0 ? this->target_.out(image)
+				                                                : this->target_.in(image);
+				for (auto const t : next) {
+					if (not this->try_extend(depth, t)) {
+						return false;
+					}
+				}
+				return true;
+			}
+
+			// Whether pattern node `p`, at position `depth` in the order, can map to `t`.
+			auto feasible(std::size_t depth, std::size_t p, std::size_t t) const -> bool {
+				if (this->used_[t] != 0 or not this->admits(p, t) or not this->agree(p, p, t, t)) {
+					return false;
+				}
+				for (auto i = std::size_t{0}; i < depth; ++i) {
+					auto const q = this->order_[i];
+					auto const m = this->mapping_[q];
+					if (not this->agree(p, q, t, m) or not this->agree(q, p, m, t)) {
+						return false;
+					}
+				}
+				return true;
+			}
+
+			// Whether the pattern pair (a, b) and the target pair (x, y) agree: a pattern edge needs
+			// a target edge that can stand for each of its weights, and an induced match also
+			// rules out target edges that the pattern lacks.
+			auto agree(std::size_t a, std::size_t b, std::size_t x, std::size_t y) const -> bool {
+				auto const wanted = this->pattern_.weights(a, b);
+				auto const present = this->target_.weights(x, y);
+				if (wanted.empty()) {
+					return present.empty() or this->kind_ == subgraph_kind::monomorphism;
+				}
+				return std::all_of(wanted.begin(), wanted.end(), [&](E1 const& w) {
+					return std::any_of(present.begin(), present.end(), [&](E2 const& v) {
+						return static_cast<bool>(std::invoke(this->edge_match_, w, v));
+					});
+				});
+			}
+		};
+	} // namespace detail
+
+	// Finds every embedding of `pattern` in `target` and reports each one to `callback` as a
+	// std::vector<N2> holding the target node matched to each pattern node, in the same order
+	// as pattern.nodes(). A pattern node may only match a target node for which
+	// `node_match(pattern_node, target_node)` holds, and a pattern edge may only use a target
+	// edge whose weight `edge_match(pattern_weight, target_weight)` accepts. Each weight of a
+	// pattern multi-edge needs some acceptable weight between the matched target nodes. Returns
+	// the number of matches reported. Symmetric patterns are reported once per automorphism.
+	//
+	// The search follows a VF2++ style order, starting from the pattern node of highest degree
+	// and adding the node with the most links to those already ordered. Only the first node's
+	// candidates are listed up front, filtered by node_match and by in- and out-degree; they are
+	// split between std::thread workers. Candidates for later nodes come from the neighbours of
+	// a matched node, so only nearby target nodes are tried, and the same filters are applied
+	// to each as it is tried. Calls to `callback` are serialised, and if it returns bool,
+	// returning false stops the search.
+	template<typename N1,
+	         typename E1,
+	         typename N2,
+	         typename E2,
+	         typename Callback,
+	         typename NodeMatch = detail::match_anything,
+	         typename EdgeMatch = detail::match_anything>
+	auto match_subgraphs(graph<N1, E1> const& pattern,
+	                     graph<N2, E2> const& target,
+	                     Callback callback,
+	                     subgraph_kind kind = subgraph_kind::monomorphism,
+	                     NodeMatch node_match = {},
+	                     EdgeMatch edge_match = {}) -> std::size_t {
+		auto const p = detail::match_graph<N1, E1>(pattern);
+		auto const t = detail::match_graph<N2, E2>(target);
+		auto const pn = p.node_count();
+		auto lock = std::mutex{};
+		auto reported = std::size_t{0};
+		auto stopped = std::atomic<bool>{false};
+		auto images = std::vector<N2>(pn);
+		auto const report = [&](std::vector<std::size_t> const& mapping) -> bool {
+			auto const guard = std::lock_guard{lock};
+			if (stopped.load(std::memory_order_relaxed)) {
+				return false;
+			}
+			for (auto i = std::size_t{0}; i < pn; ++i) {
+				images[i] = t.edges.nodes[mapping[i]];
+			}
+			++reported;
+			using result = std::invoke_result_t<Callback&, std::vector<N2> const&>;
+			if constexpr (std::is_same_v<result, bool>) {
+				if (not std::invoke(callback, std::as_const(images))) {
+					stopped.store(true, std::memory_order_relaxed);
+					return false;
+				}
+			}
+			else {
+				std::invoke(callback, std::as_const(images));
+			}
+			return true;
+		};
+		if (pn == 0U) {
+			report({});
+			return reported;
+		}
+
+		// Matching order, with the matched neighbour each later node takes its candidates from.
+		auto order = std::vector<std::size_t>{};
+		auto parents = std::vector<std::size_t>{};
+		auto parent_out = std::vector<char>{};
+		auto placed = std::vector<char>(pn, 0);
+		auto links = std::vector<std::size_t>(pn, 0U);
+		auto const degree = [&p](std::size_t u) { return p.out(u).size() + p.in(u).size(); };
+		while (order.size() < pn) {
+			auto best = detail::unmatched;
+			for (auto u = std::size_t{0}; u < pn; ++u) {
+				if (placed[u] != 0) {
+					continue;
+				}
+				// A new component starts from its node of highest degree, which the degree
+				// filter leaves the fewest candidates for.
+				if (best == detail::unmatched or links[u] > links[best]
+				    or (links[u] == links[best] and degree(u) > degree(best)))
+				{
+					best = u;
+				}
+			}
+			auto parent = detail::unmatched;
+			auto out = char{0};
+			for (auto const q : p.in(best)) {
+				if (placed[q] != 0) {
+					parent = q;
+					out = 1;
+					break;
+				}
+			}
+			for (auto const q : p.out(best)) {
+				if (parent == detail::unmatched and placed[q] != 0) {
+					parent = q;
+				}
+			}
+			placed[best] = 1;
+			order.push_back(best);
+			parents.push_back(parent);
+			parent_out.push_back(out);
+			for (auto const q : p.out(best)) {
+				++links[q];
+			}
+			for (auto const q : p.in(best)) {
+				++links[q];
+			}
+		}
+
+		using search_type =
+		   detail::subgraph_search<N1, E1, N2, E2, NodeMatch, EdgeMatch, decltype(report)>;
+		auto searches = std::vector<search_type>{};
+		searches.emplace_back(p, t, kind, order, parents, parent_out, node_match, edge_match, report);
+		auto roots = std::vector<std::size_t>{};
+		for (auto v = std::size_t{0}; v < t.node_count(); ++v) {
+			if (searches.front().admits(order.front(), v)) {
+				roots.push_back(v);
+			}
+		}
+		auto const workers = detail::worker_count(roots.size(), 1U);
+		searches.reserve(workers);
+		while (searches.size() < workers) {
+			searches.emplace_back(
+			   p, t, kind, order, parents, parent_out, node_match, edge_match, report);
+		}
+		detail::parallel_for_dynamic(
+		   0U,
+		   roots.size(),
+		   [&](std::size_t i, std::size_t worker) {
+			   if (not stopped.load(std::memory_order_relaxed)) {
+				   searches[worker].run(roots[i]);
+			   }
+		   },
+		   1U,
+		   workers);
+		return reported;
+	}
+} // namespace gdwg
+
+#endif // GDWG_SUBGRAPH_MATCHING_HPP
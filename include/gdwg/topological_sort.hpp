@@ -0,0 +1,315 @@
+#ifndef GDWG_TOPOLOGICAL_SORT_HPP
+#define GDWG_TOPOLOGICAL_SORT_HPP
+
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// A topological order of the nodes of `g` by Kahn's algorithm, or std::nullopt if `g` has a
+	// cycle (a self-loop counts as one). Ties are broken by node order.
+	template<typename N, typename E>
+	auto topological_order(graph<N, E> const& g) -> std::optional<std::vector<N>> {
+		auto const adjacency = g.to_csr();
+		auto const n = adjacency.node_count();
+		auto in_degree = std::vector<std::size_t>(n, 0U);
+		for (auto const v : adjacency.targets) {
+			++in_degree[v];
+		}
+
+		auto ready = std::deque<std::size_t>{};
+		for (auto u = std::size_t{0}; u < n; ++u) {
+			if (in_degree[u] == 0U) {
+				ready.push_back(u);
+			}
+		}
+		auto order = std::vector<N>{};
+		order.reserve(n);
+		while (not ready.empty()) {
+			auto const u = ready.front();
+			ready.pop_front();
+			order.push_back(adjacency.nodes[u]);
+			for (auto const v : adjacency.neighbours(u)) {
+				if (--in_degree[v] == 0U) {
+					ready.push_back(v);
+				}
+			}
+		}
+		if (order.size() != n) {
+			return std::nullopt;
+		}
+		return order;
+	}
+
+	// A graph that is kept acyclic, together with a topological order that is repaired after each
+	// edge insertion using the Pearce-Kelly algorithm. Inserting src -> dst only searches the
+	// nodes that sit between dst and src in the current order, instead of recomputing the whole
+	// order, and an edge that would close a cycle is rejected with an exception before anything
+	// is changed. Erasing edges never invalidates the order.
+	template<typename N, typename E>
+	class incremental_topological_order {
+	public:
+		incremental_topological_order() = default;
+
+		explicit incremental_topological_order(graph<N, E> const& g) {
+			auto const order = topological_order(g);
+			if (not order.has_value()) {
+				throw std::runtime_error("Cannot construct gdwg::incremental_topological_order<N, E> "
+				                         "from a graph with a cycle");
+			}
+			for (auto const& value : *order) {
+				this->insert_node(value);
+			}
+			for (auto const& [from, to, weight] : g) {
+				this->insert_edge(from, to, weight);
+			}
+		}
+
+		auto insert_node(N const& value) -> bool {
+			if (not this->graph_.insert_node(value)) {
+				return false;
+			}
+			if (this->vacancies_ > this->order_.size() / 2U) {
+				this->compact();
+			}
+
+			auto slot = this->values_.size();
+			if (this->free_slots_.empty()) {
+				this->values_.emplace_back();
+				this->position_.push_back(0U);
+				this->out_.emplace_back();
+				this->in_.emplace_back();
+			}
+			else {
+				slot = this->free_slots_.back();
+				this->free_slots_.pop_back();
+			}
+			this->values_[slot] = value;
+			this->slots_.emplace(value, slot);
+			this->position_[slot] = this->order_.size();
+			this->order_.push_back(slot);
+			return true;
+		}
+
+		// Throws, leaving the structure unchanged, if the edge would create a cycle.
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+			if (not(this->is_node(src) and this->is_node(dst))) {
+				throw std::runtime_error("Cannot call gdwg::incremental_topological_order<N, "
+				                         "E>::insert_edge when either src or dst node does not exist");
+			}
+			if (this->graph_.find(src, dst, weight) != this->graph_.end()) {
+				return false;
+			}
+			if (not this->graph_.is_connected(src, dst)) {
+				auto const x = this->slot(src);
+				auto const y = this->slot(dst);
+				if (not this->reorder(x, y)) {
+					throw std::runtime_error("Cannot call gdwg::incremental_topological_order<N, "
+					                         "E>::insert_edge when the edge would create a cycle");
+				}
+				this->out_[x].push_back(y);
+				this->in_[y].push_back(x);
+			}
+			return this->graph_.insert_edge(src, dst, weight);
+		}
+
+		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+			if (not(this->is_node(src) and this->is_node(dst))) {
+				throw std::runtime_error("Cannot call gdwg::incremental_topological_order<N, "
+				                         "E>::erase_edge on src or dst if they don't exist in the "
+				                         "graph");
+			}
+			if (not this->graph_.erase_edge(src, dst, weight)) {
+				return false;
+			}
+			if (not this->graph_.is_connected(src, dst)) {
+				auto const x = this->slot(src);
+				auto const y = this->slot(dst);
+				std::erase(this->out_[x], y);
+				std::erase(this->in_[y], x);
+			}
+			return true;
+		}
+
+		auto erase_node(N const& value) -> bool {
+			if (not this->graph_.is_node(value)) {
+				return false;
+			}
+			auto const x = this->slot(value);
+			for (auto const y : this->out_[x]) {
+				std::erase(this->in_[y], x);
+			}
+			for (auto const y : this->in_[x]) {
+				std::erase(this->out_[y], x);
+			}
+			this->out_[x].clear();
+			this->in_[x].clear();
+			this->order_[this->position_[x]] = vacant;
+			++this->vacancies_;
+			this->values_[x].reset();
+			this->free_slots_.push_back(x);
+			this->slots_.erase(this->slots_.find(value));
+			this->graph_.erase_node(value);
+			return true;
+		}
+
+		[[nodiscard]] auto is_node(N const& value) const noexcept -> bool {
+			return this->graph_.is_node(value);
+		}
+
+		// Whether inserting an edge src -> dst would create a cycle.
+		[[nodiscard]] auto would_create_cycle(N const& src, N const& dst) const -> bool {
+			if (not(this->is_node(src) and this->is_node(dst))) {
+				throw std::runtime_error("Cannot call gdwg::incremental_topological_order<N, "
+				                         "E>::would_create_cycle if src or dst node don't exist in "
+				                         "the graph");
+			}
+			auto const x = this->slot(src);
+			auto const y = this->slot(dst);
+			if (x == y) {
+				return true;
+			}
+			if (this->position_[x] < this->position_[y]) {
+				return false;
+			}
+			return this->forward_region(y, this->position_[x]).second;
+		}
+
+		// Whether `a` comes before `b` in the current order.
+		[[nodiscard]] auto precedes(N const& a, N const& b) const -> bool {
+			if (not(this->is_node(a) and this->is_node(b))) {
+				throw std::runtime_error("Cannot call gdwg::incremental_topological_order<N, "
+				                         "E>::precedes if either node doesn't exist in the graph");
+			}
+			return this->position_[this->slot(a)] < this->position_[this->slot(b)];
+		}
+
+		[[nodiscard]] auto order() const -> std::vector<N> {
+			auto result = std::vector<N>{};
+			result.reserve(this->slots_.size());
+			for (auto const slot : this->order_) {
+				if (slot != vacant) {
+					result.push_back(*this->values_[slot]);
+				}
+			}
+			return result;
+		}
+
+		[[nodiscard]] auto get_graph() const noexcept -> graph<N, E> const& {
+			return this->graph_;
+		}
+
+	private:
+		static constexpr auto vacant = std::numeric_limits<std::size_t>::max();
+
+		graph<N, E> graph_{};
+		std::map<N, std::size_t> slots_{};
+		// Per slot: the node value (empty once erased), its position in order_ and its distinct
+		// out- and in-neighbours. Slots of erased nodes are reused.
+		std::vector<std::optional<N>> values_{};
+		std::vector<std::size_t> position_{};
+		std::vector<std::vector<std::size_t>> out_{};
+		std::vector<std::vector<std::size_t>> in_{};
+		std::vector<std::size_t> free_slots_{};
+		// Slots in topological order. Erased nodes leave a vacant position behind until there are
+		// enough of them to be worth compacting away.
+		std::vector<std::size_t> order_{};
+		std::size_t vacancies_{0U};
+
+		auto compact() -> void {
+			std::erase(this->order_, vacant);
+			for (auto i = std::size_t{0}; i < this->order_.size(); ++i) {
+				this->position_[this->order_[i]] = i;
+			}
+			this->vacancies_ = 0U;
+		}
+
+		[[nodiscard]] auto slot(N const& value) const -> std::size_t {
+			return this->slots_.find(value)->second;
+		}
+
+		// Nodes reachable from `start` whose position is below `bound`, and whether the node at
+		// `bound` itself is reachable.
+		[[nodiscard]] auto forward_region(std::size_t start, std::size_t bound) const
+		   -> std::pair<std::vector<std::size_t>, bool> {
+			auto region = std::vector<std::size_t>{start};
+			auto seen = std::unordered_set<std::size_t>{start};
+			for (auto i = std::size_t{0}; i < region.size(); ++i) {
+				for (auto const w : this->out_[region[i]]) {
+					if (this->position_[w] == bound) {
+						return {region, true};
+					}
+					if (this->position_[w] < bound and seen.insert(w).second) {
+						region.push_back(w);
+					}
+				}
+			}
+			return {region, false};
+		}
+
+		// Nodes that reach `start` whose position is above `bound`.
+		[[nodiscard]] auto backward_region(std::size_t start, std::size_t bound) const
+		   -> std::vector<std::size_t> {
+			auto region = std::vector<std::size_t>{start};
+			auto seen = std::unordered_set<std::size_t>{start};
+			for (auto i = std::size_t{0}; i < region.size(); ++i) {
+				for (auto const w : this->in_[region[i]]) {
+					if (this->position_[w] > bound and seen.insert(w).second) {
+						region.push_back(w);
+					}
+				}
+			}
+			return region;
+		}
+
+		// Makes room for an edge x -> y. Only the nodes between y and x in the current order can
+		// be out of place: those reachable from y move after those that reach x, and both groups
+		// reuse the positions they already occupied. Returns false if y reaches x.
+		auto reorder(std::size_t x, std::size_t y) -> bool {
+			if (x == y) {
+				return false;
+			}
+			auto const lower = this->position_[y];
+			auto const upper = this->position_[x];
+			if (upper < lower) {
+				return true;
+			}
+			auto [forward, cycle] = this->forward_region(y, upper);
+			if (cycle) {
+				return false;
+			}
+			auto backward = this->backward_region(x, lower);
+
+			auto const by_position = [this](std::size_t a, std::size_t b) {
+				return this->position_[a] < this->position_[b];
+			};
+			std::sort(backward.begin(), backward.end(), by_position);
+			std::sort(forward.begin(), forward.end(), by_position);
+			auto moved = std::move(backward);
+			moved.insert(moved.end(), forward.cbegin(), forward.cend());
+
+			auto positions = std::vector<std::size_t>{};
+			positions.reserve(moved.size());
+			for (auto const w : moved) {
+				positions.push_back(this->position_[w]);
+			}
+			std::sort(positions.begin(), positions.end());
+			for (auto i = std::size_t{0}; i < moved.size(); ++i) {
+				this->position_[moved[i]] = positions[i];
+				this->order_[positions[i]] = moved[i];
+			}
+			return true;
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_TOPOLOGICAL_SORT_HPP
@@ -0,0 +1,233 @@
+#ifndef GDWG_TRIANGLES_HPP
+#define GDWG_TRIANGLES_HPP
+
+#include "gdwg/detail/undirected.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	namespace detail {
+		// When one sorted list is this many times longer than the other, searching the longer one
+		// for each element of the shorter beats a linear merge.
+		constexpr auto gallop_ratio = std::size_t{32};
+
+		// Number of values in both sorted lists of distinct values. Lists of similar length are
+		// intersected a block at a time: every value of a block of `a` is compared against the
+		// whole block of `b`, and then whichever block ends lower is replaced by the next one.
+		// The 4 x 4 comparison has no branches. On targets with 64-bit vector compares, such as
+		// AVX2, compilers turn it into packed compares, which roughly halves the time of a plain
+		// merge; elsewhere it runs about as fast as the merge. Any values left after the last
+		// whole block go through a plain merge.
+		inline auto count_common(std::span<std::size_t const> a, std::span<std::size_t const> b)
+		   -> std::size_t {
+			if (a.size() > b.size()) {
+				std::swap(a, b);
+			}
+			auto count = std::size_t{0};
+			if (a.size() * gallop_ratio < b.size()) {
+				auto itr = b.begin();
+				for (auto const x : a) {
+					itr = std::lower_bound(itr, b.end(), x);
+					if (itr == b.end()) {
+						break;
+					}
+					count += *itr == x ? 1U : 0U;
+				}
+				return count;
+			}
+			constexpr auto block = std::size_t{4};
+			auto i = std::size_t{0};
+			auto j = std::size_t{0};
+			while (i + block <= a.size() and j + block <= b.size()) {
+				auto const b0 = b[j];
+				auto const b1 = b[j + 1U];
+				auto const b2 = b[j + 2U];
+				auto const b3 = b[j + 3U];
+				// The values are distinct, so each x matches at most one value of the block.
+				for (auto p = std::size_t{0}; p < block; ++p) {
+					auto const x = a[i + p];
+					count += static_cast<std::size_t>((x == b0) | (x == b1) | (x == b2) | (x == b3));
+				}
+				auto const a_last = a[i + block - 1U];
+				auto const b_last = b[j + block - 1U];
+				i += a_last <= b_last ? block : 0U;
+				j += b_last <= a_last ? block : 0U;
+			}
+			while (i < a.size() and j < b.size()) {
+				auto const x = a[i];
+				auto const y = b[j];
+				count += x == y ? 1U : 0U;
+				i += x <= y ? 1U : 0U;
+				j += y <= x ? 1U : 0U;
+			}
+			return count;
+		}
+
+		// Calls `f(x)` for every value x in both sorted lists.
+		template<typename F>
+		auto for_each_common(std::span<std::size_t const> a,
+		                     std::span<std::size_t const> b,
+		                     F const& f) -> void {
+			if (a.size() > b.size()) {
+				std::swap(a, b);
+			}
+			if (a.size() * gallop_ratio < b.size()) {
+				auto itr = b.begin();
+				for (auto const x : a) {
+					itr = std::lower_bound(itr, b.end(), x);
+					if (itr == b.end()) {
+						return;
+					}
+					if (*itr == x) {
+						f(x);
+					}
+				}
+				return;
+			}
+			auto i = std::size_t{0};
+			auto j = std::size_t{0};
+			while (i < a.size() and j < b.size()) {
+				auto const x = a[i];
+				auto const y = b[j];
+				if (x == y) {
+					f(x);
+				}
+				i += x <= y ? 1U : 0U;
+				j += y <= x ? 1U : 0U;
+			}
+		}
+
+		// Each undirected edge kept once, pointing from the endpoint of lower degree to the one of
+		// higher degree (ties broken by id). Every node then has O(sqrt(m)) out-neighbours, and
+		// every triangle is found exactly once, at its lowest ranked corner.
+		inline auto orient_by_degree(undirected_adjacency const& g) -> undirected_adjacency {
+			auto const n = g.node_count();
+			auto const before = [&g](std::size_t u, std::size_t v) {
+				return g.degree(u) < g.degree(v) or (g.degree(u) == g.degree(v) and u < v);
+			};
+			auto sizes = std::vector<std::size_t>(n + 1U, 0U);
+			parallel_edge_chunks(g.offsets, [&](std::size_t first, std::size_t last, std::size_t) {
+				for (auto u = first; u < last; ++u) {
+					auto const row = g.neighbours(u);
+					auto const later = [&](std::size_t v) { return before(u, v); };
+					auto const count = std::count_if(row.begin(), row.end(), later);
+					sizes[u + 1U] = static_cast<std::size_t>(count);
+				}
+			});
+			auto result = undirected_adjacency{};
+			result.offsets.resize(n + 1U);
+			std::partial_sum(sizes.cbegin(), sizes.cend(), result.offsets.begin());
+			result.targets.resize(result.offsets.back());
+			parallel_edge_chunks(g.offsets, [&](std::size_t first, std::size_t last, std::size_t) {
+				for (auto u = first; u < last; ++u) {
+					auto const row = g.neighbours(u);
+					auto const later = [&](std::size_t v) { return before(u, v); };
+					auto const out =
+					   result.targets.begin() + static_cast<std::ptrdiff_t>(result.offsets[u]);
+					std::copy_if(row.begin(), row.end(), out, later);
+				}
+			});
+			return result;
+		}
+
+		// Triangles through every node of the simple undirected graph `g`. The outer loop hands
+		// out nodes dynamically, since the work per node is very uneven on skewed graphs.
+		inline auto triangles_per_node(undirected_adjacency const& g) -> std::vector<std::size_t> {
+			auto const n = g.node_count();
+			auto const oriented = orient_by_degree(g);
+			auto counts = std::vector<std::atomic<std::size_t>>(n);
+			parallel_for_dynamic(
+			   0U,
+			   n,
+			   [&](std::size_t u, std::size_t) {
+				   auto const out = oriented.neighbours(u);
+				   auto at_u = std::size_t{0};
+				   for (auto const v : out) {
+					   auto at_v = std::size_t{0};
+					   for_each_common(out, oriented.neighbours(v), [&](std::size_t w) {
+						   ++at_v;
+						   counts[w].fetch_add(1U, std::memory_order_relaxed);
+					   });
+					   at_u += at_v;
+					   if (at_v != 0U) {
+						   counts[v].fetch_add(at_v, std::memory_order_relaxed);
+					   }
+				   }
+				   if (at_u != 0U) {
+					   counts[u].fetch_add(at_u, std::memory_order_relaxed);
+				   }
+			   },
+			   64U);
+
+			auto result = std::vector<std::size_t>(n);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				result[u] = counts[u].load(std::memory_order_relaxed);
+			}
+			return result;
+		}
+	} // namespace detail
+
+	// Number of triangles in the undirected view of `g`, ignoring directions, multi-edges and
+	// self-loops. Adjacency is oriented by degree and the intersections of sorted neighbour
+	// lists are spread over std::thread workers.
+	template<typename N, typename E>
+	auto triangle_count(graph<N, E> const& g) -> std::size_t {
+		constexpr auto batch = std::size_t{64};
+		auto const oriented = detail::orient_by_degree(detail::make_undirected(g.to_csr()));
+		auto const n = oriented.node_count();
+		auto const workers = detail::worker_count(n, batch);
+		auto partial = std::vector<std::size_t>(workers, 0U);
+		// Batches of nodes are counted into a local, so workers touch the shared totals only once
+		// per batch rather than once per edge.
+		detail::parallel_for_dynamic(
+		   0U,
+		   (n + batch - 1U) / batch,
+		   [&](std::size_t b, std::size_t worker) {
+			   auto count = std::size_t{0};
+			   for (auto u = b * batch; u < std::min(n, (b + 1U) * batch); ++u) {
+				   auto const out = oriented.neighbours(u);
+				   for (auto const v : out) {
+					   count += detail::count_common(out, oriented.neighbours(v));
+				   }
+			   }
+			   partial[worker] += count;
+		   },
+		   1U,
+		   workers);
+		return std::accumulate(partial.cbegin(), partial.cend(), std::size_t{0});
+	}
+
+	// Number of triangles through each node of the undirected view of `g`, in the same order as
+	// g.nodes().
+	template<typename N, typename E>
+	auto triangles(graph<N, E> const& g) -> std::vector<std::size_t> {
+		return detail::triangles_per_node(detail::make_undirected(g.to_csr()));
+	}
+
+	// Local clustering coefficient of each node of the undirected view of `g`: the fraction of
+	// pairs of its distinct neighbours that are themselves adjacent. Nodes with fewer than two
+	// neighbours get 0. Returned in the same order as g.nodes().
+	template<typename N, typename E>
+	auto clustering_coefficients(graph<N, E> const& g) -> std::vector<double> {
+		auto const undirected = detail::make_undirected(g.to_csr());
+		auto const counts = detail::triangles_per_node(undirected);
+		auto result = std::vector<double>(counts.size(), 0.0);
+		for (auto u = std::size_t{0}; u < counts.size(); ++u) {
+			auto const degree = static_cast<double>(undirected.degree(u));
+			if (undirected.degree(u) >= 2U) {
+				result[u] = 2.0 * static_cast<double>(counts[u]) / (degree * (degree - 1.0));
+			}
+		}
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_TRIANGLES_HPP
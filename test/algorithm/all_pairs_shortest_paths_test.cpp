@@ -0,0 +1,167 @@
+#include "gdwg/all_pairs_shortest_paths.hpp"
+#include "gdwg/graph.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+	using gdwg::testing::random_graph;
+
+	// Reference answer from the textbook triple loop.
+	auto naive_distances(gdwg::graph<int, int> const& g)
+	   -> std::vector<std::vector<std::optional<int>>> {
+		auto const nodes = g.nodes();
+		auto const n = nodes.size();
+		auto d = std::vector<std::vector<std::optional<int>>>(n, std::vector<std::optional<int>>(n));
+		for (auto i = std::size_t{0}; i < n; ++i) {
+			d[i][i] = 0;
+			for (auto j = std::size_t{0}; j < n; ++j) {
+				for (auto const w : g.weights(nodes[i], nodes[j])) {
+					d[i][j] = d[i][j].has_value() ? std::min(*d[i][j], w) : w;
+				}
+			}
+		}
+		for (auto k = std::size_t{0}; k < n; ++k) {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				for (auto j = std::size_t{0}; j < n; ++j) {
+					if (d[i][k].has_value() and d[k][j].has_value()
+					    and (not d[i][j].has_value() or *d[i][k] + *d[k][j] < *d[i][j]))
+					{
+						d[i][j] = *d[i][k] + *d[k][j];
+					}
+				}
+			}
+		}
+		return d;
+	}
+
+	// Weights in [min_weight, 100]. Only forward edges may be negative, and every backward edge
+	// outweighs any run of them, so that no negative cycle can form.
+	auto acyclic_negative_weights(int nodes, int min_weight) {
+		return [weight = std::uniform_int_distribution<int>{min_weight, 100},
+		        nodes](int, int from, int to, std::mt19937& engine) mutable {
+			return from < to ? weight(engine) : 100 * nodes + weight(engine);
+		};
+	}
+} // namespace
+
+TEST_CASE("floyd_warshall finds shortest paths using the lightest of each multi-edge") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	CHECK(g.insert_edge("a", "b", 5));
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("b", "c", 2));
+	CHECK(g.insert_edge("a", "c", 4));
+	CHECK(g.insert_edge("c", "a", 7));
+
+	auto const d = gdwg::floyd_warshall(g);
+	CHECK(d.size() == 4);
+	CHECK(d.nodes() == g.nodes());
+	CHECK(d.distance("a", "a") == 0);
+	CHECK(d.distance("a", "b") == 1);
+	CHECK(d.distance("a", "c") == 3);
+	CHECK(d.distance("c", "b") == 8);
+	CHECK(d.distance("a", "d") == std::nullopt);
+	CHECK(d.distance("d", "a") == std::nullopt);
+	CHECK_THROWS_WITH(d.distance("a", "e"),
+	                  "Cannot call gdwg::distance_matrix<N, E>::distance if src or dst node don't "
+	                  "exist in the graph");
+}
+
+TEST_CASE("floyd_warshall handles negative weights and rejects negative cycles") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	CHECK(g.insert_edge(1, 2, 4));
+	CHECK(g.insert_edge(2, 3, -3));
+	CHECK(g.insert_edge(1, 3, 2));
+	auto const d = gdwg::floyd_warshall(g);
+	CHECK(d.distance(1, 3) == 1);
+	CHECK(d.distance(3, 1) == std::nullopt);
+
+	CHECK(g.insert_edge(3, 2, 1));
+	CHECK_THROWS_WITH(gdwg::floyd_warshall(g),
+	                  "Cannot call gdwg::floyd_warshall on a graph with a negative cycle");
+}
+
+TEST_CASE("floyd_warshall works with floating point weights") {
+	auto g = gdwg::graph<int, double>{1, 2, 3};
+	CHECK(g.insert_edge(1, 2, 0.5));
+	CHECK(g.insert_edge(2, 3, 0.25));
+	auto const d = gdwg::floyd_warshall(g);
+	CHECK(d.distance(1, 3) == Approx(0.75));
+	CHECK(d.distance(3, 1) == std::nullopt);
+}
+
+TEST_CASE("floyd_warshall agrees with the unblocked algorithm across several blocks") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	auto const g = random_graph(150, 1200, 6771U, acyclic_negative_weights(150, -20));
+	auto const expected = naive_distances(g);
+	auto const d = gdwg::floyd_warshall(g);
+	auto mismatches = 0;
+	for (auto i = std::size_t{0}; i < expected.size(); ++i) {
+		for (auto j = std::size_t{0}; j < expected.size(); ++j) {
+			mismatches += d.distance(i, j) == expected[i][j] ? 0 : 1;
+		}
+	}
+	CHECK(mismatches == 0);
+}
+
+TEST_CASE("floyd_warshall on an empty graph gives an empty matrix") {
+	auto const d = gdwg::floyd_warshall(gdwg::graph<int, float>{});
+	CHECK(d.size() == 0);
+}
+
+TEST_CASE("johnson streams one row per source that matches floyd_warshall") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	auto const g = random_graph(120, 700, 2021U, acyclic_negative_weights(120, -20));
+	auto const expected = gdwg::floyd_warshall(g);
+	auto const nodes = g.nodes();
+
+	auto rows = std::map<int, std::vector<int>>{};
+	auto rows_mutex = std::mutex{};
+	gdwg::johnson(g, [&](int const& src, std::span<int const> distances) {
+		auto lock = std::lock_guard{rows_mutex};
+		CHECK(rows.emplace(src, std::vector<int>(distances.begin(), distances.end())).second);
+	});
+	REQUIRE(rows.size() == nodes.size());
+
+	auto mismatches = 0;
+	for (auto i = std::size_t{0}; i < nodes.size(); ++i) {
+		for (auto j = std::size_t{0}; j < nodes.size(); ++j) {
+			auto const d = rows[nodes[i]][j];
+			auto const actual =
+			   d == std::numeric_limits<int>::max() ? std::nullopt : std::optional<int>{d};
+			mismatches += actual == expected.distance(i, j) ? 0 : 1;
+		}
+	}
+	CHECK(mismatches == 0);
+}
+
+TEST_CASE("johnson reports unreachable nodes and rejects negative cycles") {
+	auto g = gdwg::graph<std::string, unsigned>{"a", "b", "c"};
+	CHECK(g.insert_edge("a", "b", 3U));
+	CHECK(g.insert_edge("a", "b", 2U));
+	gdwg::johnson(g, [](std::string const& src, std::span<unsigned const> distances) {
+		auto constexpr unreachable = std::numeric_limits<unsigned>::max();
+		if (src == "a") {
+			CHECK(std::vector<unsigned>(distances.begin(), distances.end())
+			      == std::vector<unsigned>{0U, 2U, unreachable});
+		}
+		else {
+			CHECK(distances[2] == (src == "c" ? 0U : unreachable));
+		}
+	});
+
+	auto h = gdwg::graph<int, int>{1, 2};
+	CHECK(h.insert_edge(1, 2, 1));
+	CHECK(h.insert_edge(2, 1, -2));
+	CHECK_THROWS_WITH(gdwg::johnson(h, [](int const&, std::span<int const>) {}),
+	                  "Cannot call gdwg::johnson on a graph with a negative cycle");
+}
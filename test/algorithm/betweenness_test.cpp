@@ -0,0 +1,163 @@
+#include "gdwg/betweenness.hpp"
+#include "gdwg/graph.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	using gdwg::testing::random_graph;
+	using gdwg::testing::uniform_weights;
+
+	// Reference scores from all-pairs distances and path counts, checking every (s, v, t).
+	auto reference_betweenness(gdwg::graph<int, int> const& g, bool weighted)
+	   -> std::vector<double> {
+		constexpr auto infinity = std::numeric_limits<int>::max() / 4;
+		auto const n = g.nodes().size();
+		auto length = std::vector<std::vector<int>>(n, std::vector<int>(n, infinity));
+		for (auto const& [from, to, weight] : g) {
+			auto& entry = length[static_cast<std::size_t>(from)][static_cast<std::size_t>(to)];
+			if (from != to) {
+				entry = std::min(entry, weighted ? weight : 1);
+			}
+		}
+		auto distance = length;
+		auto paths = std::vector<std::vector<double>>(n, std::vector<double>(n, 0.0));
+		for (auto s = std::size_t{0}; s < n; ++s) {
+			distance[s][s] = 0;
+		}
+		for (auto k = std::size_t{0}; k < n; ++k) {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				for (auto j = std::size_t{0}; j < n; ++j) {
+					distance[i][j] = std::min(distance[i][j], distance[i][k] + distance[k][j]);
+				}
+			}
+		}
+		// Paths to each target, counted in order of distance from the source.
+		for (auto s = std::size_t{0}; s < n; ++s) {
+			auto order = std::vector<std::size_t>{};
+			for (auto v = std::size_t{0}; v < n; ++v) {
+				order.push_back(v);
+			}
+			std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+				return distance[s][a] < distance[s][b];
+			});
+			paths[s][s] = 1.0;
+			for (auto const v : order) {
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					auto const reached = distance[s][v] < infinity and length[u][v] < infinity;
+					if (u != v and reached and distance[s][u] + length[u][v] == distance[s][v]) {
+						paths[s][v] += paths[s][u];
+					}
+				}
+			}
+		}
+		auto scores = std::vector<double>(n, 0.0);
+		for (auto s = std::size_t{0}; s < n; ++s) {
+			for (auto t = std::size_t{0}; t < n; ++t) {
+				if (s == t or distance[s][t] >= infinity) {
+					continue;
+				}
+				for (auto v = std::size_t{0}; v < n; ++v) {
+					if (v != s and v != t and distance[s][v] + distance[v][t] == distance[s][t]) {
+						scores[v] += paths[s][v] * paths[v][t] / paths[s][t];
+					}
+				}
+			}
+		}
+		return scores;
+	}
+} // namespace
+
+TEST_CASE("betweenness_centrality counts the shortest paths through each node") {
+	// a -> b -> c, plus a second route a -> d -> c of the same hop count but longer weight.
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("a", "b", 5));
+	CHECK(g.insert_edge("b", "c", 1));
+	CHECK(g.insert_edge("a", "d", 2));
+	CHECK(g.insert_edge("d", "c", 2));
+	CHECK(g.insert_edge("d", "d", 1));
+
+	CHECK(gdwg::betweenness_centrality(g) == std::vector<double>{0.0, 0.5, 0.0, 0.5});
+	auto options = gdwg::betweenness_options{};
+	options.weighted = true;
+	CHECK(gdwg::betweenness_centrality(g, options) == std::vector<double>{0.0, 1.0, 0.0, 0.0});
+	options.normalised = true;
+	auto const normalised = gdwg::betweenness_centrality(g, options);
+	CHECK(normalised[1] == Approx(1.0 / 6.0));
+}
+
+TEST_CASE("parallel exact betweenness matches a brute-force count") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	for (auto const seed : {1U, 2U, 3U}) {
+		auto const g = random_graph(40, 120, seed, uniform_weights(1, 4));
+		for (auto const weighted : {false, true}) {
+			auto options = gdwg::betweenness_options{};
+			options.weighted = weighted;
+			auto const scores = gdwg::betweenness_centrality(g, options);
+			auto const expected = reference_betweenness(g, weighted);
+			REQUIRE(scores.size() == expected.size());
+			for (auto i = std::size_t{0}; i < scores.size(); ++i) {
+				CHECK(scores[i] == Approx(expected[i]));
+			}
+		}
+	}
+}
+
+TEST_CASE("sampled betweenness stays within its error bound") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	auto const g = random_graph(2000, 8000, 7U, uniform_weights(1, 4));
+	auto exact_options = gdwg::betweenness_options{};
+	exact_options.normalised = true;
+	auto const exact = gdwg::betweenness_centrality(g, exact_options);
+
+	auto options = exact_options;
+	options.epsilon = 0.1;
+	options.seed = 11U;
+	CHECK(gdwg::detail::betweenness_samples(2000, options.epsilon, options.delta) < 1000);
+	auto const sampled = gdwg::betweenness_centrality(g, options);
+	REQUIRE(sampled.size() == exact.size());
+	auto sampled_total = 0.0;
+	auto exact_total = 0.0;
+	for (auto i = std::size_t{0}; i < exact.size(); ++i) {
+		CHECK(std::abs(sampled[i] - exact[i]) <= options.epsilon);
+		sampled_total += sampled[i];
+		exact_total += exact[i];
+	}
+	// The estimator is unbiased, so the totals should be close as well.
+	CHECK(sampled_total == Approx(exact_total).epsilon(0.1));
+
+	// A bound too tight to beat n samples falls back to the exact scores.
+	options.epsilon = 0.001;
+	auto const fallback = gdwg::betweenness_centrality(g, options);
+	for (auto i = std::size_t{0}; i < exact.size(); ++i) {
+		CHECK(fallback[i] == Approx(exact[i]));
+	}
+}
+
+TEST_CASE("weighted betweenness needs positive weights") {
+	auto options = gdwg::betweenness_options{};
+	options.weighted = true;
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	CHECK(g.insert_edge(1, 2, 0));
+	CHECK_THROWS_MATCHES(gdwg::betweenness_centrality(g, options),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::betweenness_centrality with "
+	                                              "weighted lengths unless every weight is "
+	                                              "positive"));
+
+	auto named = gdwg::graph<int, std::string>{1, 2, 3};
+	CHECK(named.insert_edge(1, 2, "x"));
+	CHECK(named.insert_edge(2, 3, "y"));
+	CHECK(gdwg::betweenness_centrality(named) == std::vector<double>{0.0, 1.0, 0.0});
+	CHECK_THROWS_MATCHES(gdwg::betweenness_centrality(named, options),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::betweenness_centrality with "
+	                                              "weighted lengths on non-arithmetic weights"));
+}
@@ -0,0 +1,146 @@
+#include "gdwg/breadth_first_search.hpp"
+#include "gdwg/graph.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	constexpr auto unreached = gdwg::breadth_first_tree::unreached;
+
+	// Edges from a preferential-attachment process, so that a few hubs have most of the edges.
+	auto skewed_graph(int nodes, int edges, unsigned seed) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		auto engine = std::mt19937{seed};
+		auto node = std::uniform_int_distribution<int>{0, nodes - 1};
+		auto ends = std::vector<int>{0};
+		for (auto i = 0; i < edges; ++i) {
+			auto pick = std::uniform_int_distribution<std::size_t>{0U, ends.size() - 1U};
+			auto const hub = ends[pick(engine)];
+			auto const other = node(engine);
+			if (i % 2 == 0) {
+				g.insert_edge(other, hub, 1);
+			}
+			else {
+				g.insert_edge(hub, other, 1);
+			}
+			ends.push_back(hub);
+			ends.push_back(other);
+		}
+		return g;
+	}
+
+	auto reference_distances(gdwg::graph<int, int> const& g, std::size_t source)
+	   -> std::vector<std::size_t> {
+		auto const n = g.nodes().size();
+		auto adjacency = std::vector<std::vector<std::size_t>>(n);
+		for (auto const& [from, to, weight] : g) {
+			adjacency[static_cast<std::size_t>(from)].push_back(static_cast<std::size_t>(to));
+		}
+		auto distances = std::vector<std::size_t>(n, unreached);
+		auto queue = std::queue<std::size_t>{};
+		distances[source] = 0U;
+		queue.push(source);
+		while (not queue.empty()) {
+			auto const u = queue.front();
+			queue.pop();
+			for (auto const v : adjacency[u]) {
+				if (distances[v] == unreached) {
+					distances[v] = distances[u] + 1U;
+					queue.push(v);
+				}
+			}
+		}
+		return distances;
+	}
+
+	auto check_tree(gdwg::graph<int, int> const& g,
+	                int source,
+	                gdwg::breadth_first_tree const& tree) -> void {
+		auto const s = static_cast<std::size_t>(source);
+		CHECK(tree.distances == reference_distances(g, s));
+		REQUIRE(tree.parents.size() == tree.distances.size());
+		for (auto v = std::size_t{0}; v < tree.parents.size(); ++v) {
+			auto const parent = tree.parents[v];
+			if (tree.distances[v] == unreached) {
+				CHECK(parent == unreached);
+			}
+			else if (v == s) {
+				CHECK(parent == s);
+			}
+			else {
+				REQUIRE(parent != unreached);
+				CHECK(tree.distances[parent] + 1U == tree.distances[v]);
+				CHECK(g.is_connected(static_cast<int>(parent), static_cast<int>(v)));
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("breadth_first_search gives hop distances and parents") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	CHECK(g.insert_edge("a", "b", 5));
+	CHECK(g.insert_edge("a", "b", 7));
+	CHECK(g.insert_edge("b", "c", 1));
+	CHECK(g.insert_edge("c", "a", 1));
+	CHECK(g.insert_edge("c", "c", 1));
+	CHECK(g.insert_edge("e", "a", 1));
+
+	for (auto const algorithm : {gdwg::bfs_algorithm::top_down,
+	                             gdwg::bfs_algorithm::direction_optimising,
+	                             gdwg::bfs_algorithm::automatic})
+	{
+		auto const tree = gdwg::breadth_first_search(g, std::string{"a"}, algorithm);
+		CHECK(tree.distances == std::vector<std::size_t>{0, 1, 2, unreached, unreached});
+		CHECK(tree.parents == std::vector<std::size_t>{0, 0, 1, unreached, unreached});
+	}
+	CHECK_THROWS_MATCHES(gdwg::breadth_first_search(g, std::string{"f"}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::breadth_first_search if source "
+	                                              "node doesn't exist in the graph"));
+}
+
+TEST_CASE("direction-optimising search matches a plain queue on skewed graphs") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	for (auto const seed : {1U, 2U, 3U}) {
+		auto const g = skewed_graph(5000, 40000, seed);
+		for (auto const source : {0, 17, 4999}) {
+			check_tree(g, source, gdwg::breadth_first_search(g, source));
+			check_tree(g,
+			           source,
+			           gdwg::breadth_first_search(g, source, gdwg::bfs_algorithm::top_down));
+			check_tree(
+			   g,
+			   source,
+			   gdwg::breadth_first_search(g, source, gdwg::bfs_algorithm::direction_optimising));
+		}
+	}
+}
+
+TEST_CASE("a hub's whole neighbourhood is found bottom-up") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	// Every node hangs off node 0 and points at a few others, so the second level is searched
+	// from the unreached side.
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 3000; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 1; i < 1500; ++i) {
+		g.insert_edge(0, i, 1);
+		g.insert_edge(i, 1500 + i, 1);
+		g.insert_edge(1500 + i, (i * 7) % 3000, 1);
+	}
+	for (auto const source : {0, 1, 2999}) {
+		check_tree(
+		   g,
+		   source,
+		   gdwg::breadth_first_search(g, source, gdwg::bfs_algorithm::direction_optimising));
+	}
+}
@@ -0,0 +1,151 @@
+#include "gdwg/cliques.hpp"
+#include "gdwg/graph.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+	using gdwg::testing::index_weights;
+	using gdwg::testing::random_graph;
+
+	// Plain Bron-Kerbosch without pivoting or ordering, on sets of node values.
+	auto reference_cliques(std::vector<std::set<int>> const& adjacent,
+	                       std::vector<int>& clique,
+	                       std::set<int> candidates,
+	                       std::set<int> excluded,
+	                       std::vector<std::vector<int>>& result) -> void {
+		if (candidates.empty() and excluded.empty()) {
+			auto sorted = clique;
+			std::sort(sorted.begin(), sorted.end());
+			result.push_back(sorted);
+			return;
+		}
+		while (not candidates.empty()) {
+			auto const v = *candidates.begin();
+			auto const& row = adjacent[static_cast<std::size_t>(v)];
+			auto next_candidates = std::set<int>{};
+			auto next_excluded = std::set<int>{};
+			std::set_intersection(candidates.cbegin(),
+			                      candidates.cend(),
+			                      row.cbegin(),
+			                      row.cend(),
+			                      std::inserter(next_candidates, next_candidates.end()));
+			std::set_intersection(excluded.cbegin(),
+			                      excluded.cend(),
+			                      row.cbegin(),
+			                      row.cend(),
+			                      std::inserter(next_excluded, next_excluded.end()));
+			clique.push_back(v);
+			reference_cliques(adjacent, clique, next_candidates, next_excluded, result);
+			clique.pop_back();
+			candidates.erase(v);
+			excluded.insert(v);
+		}
+	}
+
+	auto reference_cliques(gdwg::graph<int, int> const& g) -> std::vector<std::vector<int>> {
+		auto const n = g.nodes().size();
+		auto adjacent = std::vector<std::set<int>>(n);
+		for (auto const& [from, to, weight] : g) {
+			if (from != to) {
+				adjacent[static_cast<std::size_t>(from)].insert(to);
+				adjacent[static_cast<std::size_t>(to)].insert(from);
+			}
+		}
+		auto all = std::set<int>{};
+		for (auto i = 0; i < static_cast<int>(n); ++i) {
+			all.insert(i);
+		}
+		auto clique = std::vector<int>{};
+		auto result = std::vector<std::vector<int>>{};
+		reference_cliques(adjacent, clique, all, {}, result);
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+} // namespace
+
+TEST_CASE("maximal_cliques ignores directions, multi-edges and self-loops") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("b", "a", 2));
+	CHECK(g.insert_edge("b", "c", 1));
+	CHECK(g.insert_edge("c", "a", 1));
+	CHECK(g.insert_edge("c", "a", 3));
+	CHECK(g.insert_edge("c", "d", 1));
+	CHECK(g.insert_edge("d", "d", 1));
+	CHECK(gdwg::maximal_cliques(g)
+	      == std::vector<std::vector<std::string>>{{"a", "b", "c"}, {"c", "d"}, {"e"}});
+	CHECK(gdwg::maximal_cliques(gdwg::graph<int, int>{}).empty());
+}
+
+TEST_CASE("a cocktail party graph has one maximal clique per choice from each pair") {
+	// Every node is adjacent to all others except its partner, so 2^8 cliques of size 8.
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 16; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 16; ++i) {
+		for (auto j = i + 1; j < 16; ++j) {
+			if (j != (i ^ 1)) {
+				g.insert_edge(i, j, 1);
+			}
+		}
+	}
+	auto const cliques = gdwg::maximal_cliques(g);
+	CHECK(cliques.size() == 256U);
+	CHECK(std::all_of(cliques.cbegin(), cliques.cend(), [](auto const& c) {
+		return c.size() == 8U;
+	}));
+	CHECK(cliques == reference_cliques(g));
+
+	auto seen = std::size_t{0};
+	CHECK(gdwg::maximal_cliques(g, [&seen](std::vector<int> const&) { return ++seen < 10U; })
+	      == 10U);
+	CHECK(seen == 10U);
+}
+
+TEST_CASE("cliques wider than one word of candidates are found whole") {
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 150; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 130; ++i) {
+		for (auto j = i + 1; j < 130; ++j) {
+			g.insert_edge(j, i, 1);
+		}
+	}
+	for (auto i = 130; i < 150; ++i) {
+		g.insert_edge(i, i - 70, 1);
+		g.insert_edge(i, i - 1, 1);
+	}
+	// Node 130 closes a triangle with 129 and 60, and the rest of the tail forms only edges.
+	auto expected = std::vector<std::vector<int>>{{60, 129, 130}};
+	expected.emplace_back();
+	for (auto i = 0; i < 130; ++i) {
+		expected.back().push_back(i);
+	}
+	for (auto i = 131; i < 150; ++i) {
+		expected.push_back({i - 70, i});
+		expected.push_back({i - 1, i});
+	}
+	std::sort(expected.begin(), expected.end());
+	CHECK(gdwg::maximal_cliques(g) == expected);
+}
+
+TEST_CASE("parallel searches find the same cliques as plain Bron-Kerbosch") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	for (auto const seed : {1U, 2U, 3U}) {
+		auto const g = random_graph(90, 1500, seed, index_weights(3));
+		auto const expected = reference_cliques(g);
+		CHECK(gdwg::maximal_cliques(g) == expected);
+		auto count = std::size_t{0};
+		CHECK(gdwg::maximal_cliques(g, [&count](std::vector<int> const&) { ++count; })
+		      == expected.size());
+		CHECK(count == expected.size());
+	}
+}
@@ -0,0 +1,89 @@
+#include "gdwg/colouring.hpp"
+#include "gdwg/graph.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+	constexpr auto algorithms = {gdwg::colouring_algorithm::automatic,
+	                             gdwg::colouring_algorithm::largest_first,
+	                             gdwg::colouring_algorithm::jones_plassmann,
+	                             gdwg::colouring_algorithm::speculative};
+
+	// Checks that no edge joins two nodes of the same colour, and that no node's colour exceeds
+	// its number of distinct neighbours.
+	template<typename N, typename E>
+	auto check_colouring(gdwg::graph<N, E> const& g, std::vector<std::size_t> const& colours)
+	   -> void {
+		auto const nodes = g.nodes();
+		REQUIRE(colours.size() == nodes.size());
+		auto const colour_of = [&](N const& value) {
+			auto const itr = std::lower_bound(nodes.cbegin(), nodes.cend(), value);
+			return colours[static_cast<std::size_t>(itr - nodes.cbegin())];
+		};
+		auto neighbours = std::vector<std::set<N>>(nodes.size());
+		for (auto const& [from, to, weight] : g) {
+			if (from != to) {
+				CHECK(colour_of(from) != colour_of(to));
+				auto const itr = std::lower_bound(nodes.cbegin(), nodes.cend(), from);
+				neighbours[static_cast<std::size_t>(itr - nodes.cbegin())].insert(to);
+				auto const jtr = std::lower_bound(nodes.cbegin(), nodes.cend(), to);
+				neighbours[static_cast<std::size_t>(jtr - nodes.cbegin())].insert(from);
+			}
+		}
+		for (auto u = std::size_t{0}; u < nodes.size(); ++u) {
+			CHECK(colours[u] <= neighbours[u].size());
+		}
+	}
+} // namespace
+
+TEST_CASE("colouring ignores directions, multi-edges and self-loops") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("b", "a", 2));
+	CHECK(g.insert_edge("b", "c", 1));
+	CHECK(g.insert_edge("c", "a", 1));
+	CHECK(g.insert_edge("c", "d", 1));
+	CHECK(g.insert_edge("d", "d", 1));
+	for (auto const algorithm : algorithms) {
+		auto const colours = gdwg::colouring(g, algorithm);
+		check_colouring(g, colours);
+		// A triangle needs three colours, and the lone node takes the first.
+		CHECK(std::set<std::size_t>{colours[0], colours[1], colours[2]}.size() == 3U);
+		CHECK(colours[4] == 0U);
+	}
+	CHECK(gdwg::colouring(gdwg::graph<int, int>{}).empty());
+}
+
+TEST_CASE("largest_first colours a star in two colours") {
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 21; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 1; i < 21; ++i) {
+		g.insert_edge(0, i, 1);
+	}
+	auto const colours = gdwg::colouring(g, gdwg::colouring_algorithm::largest_first);
+	check_colouring(g, colours);
+	CHECK(*std::max_element(colours.cbegin(), colours.cend()) == 1U);
+}
+
+TEST_CASE("parallel colourings are proper on dense random graphs") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	auto g = gdwg::testing::random_graph(2000, 40000, 9U);
+	// A clique, so that clashes between concurrent picks are likely.
+	for (auto i = 0; i < 60; ++i) {
+		for (auto j = i + 1; j < 60; ++j) {
+			g.insert_edge(i * 7, j * 7, 1);
+		}
+	}
+	for (auto const algorithm : algorithms) {
+		auto const colours = gdwg::colouring(g, algorithm);
+		check_colouring(g, colours);
+		CHECK(*std::max_element(colours.cbegin(), colours.cend()) >= 59U);
+	}
+}
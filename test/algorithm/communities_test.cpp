@@ -0,0 +1,146 @@
+#include "gdwg/communities.hpp"
+#include "gdwg/graph.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	// `count` cliques of `size` nodes each, joined in a ring by one edge between neighbours.
+	auto ring_of_cliques(int count, int size) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < count * size; ++i) {
+			g.insert_node(i);
+		}
+		for (auto c = 0; c < count; ++c) {
+			for (auto i = 0; i < size; ++i) {
+				for (auto j = i + 1; j < size; ++j) {
+					g.insert_edge(c * size + i, c * size + j, 1);
+				}
+			}
+			g.insert_edge(c * size, (c + 1) % count * size + 1, 1);
+		}
+		return g;
+	}
+
+	// Nodes split into `groups` blocks, with edges far more likely inside a block than across.
+	auto planted_partition(int nodes, int groups, unsigned seed) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		auto engine = std::mt19937{seed};
+		auto chance = std::uniform_real_distribution<double>{0.0, 1.0};
+		for (auto i = 0; i < nodes; ++i) {
+			for (auto j = i + 1; j < nodes; ++j) {
+				auto const inside = i % groups == j % groups;
+				if (chance(engine) < (inside ? 0.3 : 0.01)) {
+					g.insert_edge(i, j, 1);
+				}
+			}
+		}
+		return g;
+	}
+
+	auto expect_blocks(std::vector<std::size_t> const& ids, int count, int size) -> void {
+		auto distinct = std::set<std::size_t>(ids.cbegin(), ids.cend());
+		CHECK(distinct.size() == static_cast<std::size_t>(count));
+		for (auto i = std::size_t{0}; i < ids.size(); ++i) {
+			CHECK(ids[i] == i / static_cast<std::size_t>(size));
+		}
+	}
+
+	// Label propagation may let a label spread across a bridge, but never splits a clique.
+	auto expect_whole_blocks(std::vector<std::size_t> const& ids, int count, int size) -> void {
+		auto distinct = std::set<std::size_t>(ids.cbegin(), ids.cend());
+		CHECK(distinct.size() >= static_cast<std::size_t>(count / 2));
+		for (auto i = std::size_t{0}; i < ids.size(); ++i) {
+			CHECK(ids[i] == ids[i - i % static_cast<std::size_t>(size)]);
+		}
+	}
+} // namespace
+
+TEST_CASE("louvain separates two cliques joined by a bridge") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e", "f"};
+	for (auto const& [from, to] : std::vector<std::pair<std::string, std::string>>{
+	        {"a", "b"}, {"b", "c"}, {"c", "a"}, {"d", "e"}, {"e", "f"}, {"f", "d"}, {"c", "d"}})
+	{
+		CHECK(g.insert_edge(from, to, 1));
+	}
+	auto const ids = gdwg::communities(g);
+	CHECK(ids == std::vector<std::size_t>{0, 0, 0, 1, 1, 1});
+	// 6 of 7 edges inside, and each side holds half of the total degree.
+	CHECK(gdwg::modularity(g, ids) == Approx(6.0 / 7.0 - 0.5));
+	CHECK(gdwg::modularity(g, std::vector<std::size_t>(6, 0U)) == Approx(0.0));
+}
+
+TEST_CASE("modularity weighs edges, multi-edges and self-loops") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	CHECK(g.insert_edge(1, 2, 2));
+	CHECK(g.insert_edge(2, 1, 1));
+	CHECK(g.insert_edge(3, 3, 1));
+	CHECK(g.insert_edge(2, 3, 1));
+	// A[1][2] = 3, A[2][3] = 1, A[3][3] = 2, so the degrees are 3, 4 and 3 out of 10.
+	auto const q = gdwg::modularity(g, {0, 0, 1});
+	CHECK(q == Approx(6.0 / 10.0 - 0.49 + 2.0 / 10.0 - 0.09));
+	CHECK(gdwg::modularity(g, {0, 0, 1}, 2.0) == Approx(0.8 - 2.0 * 0.58));
+	CHECK(gdwg::communities(g) == std::vector<std::size_t>{0, 0, 1});
+
+	CHECK_THROWS_MATCHES(gdwg::modularity(g, {0, 1}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::modularity without exactly one "
+	                                              "community id below the node count per node"));
+	CHECK(g.insert_edge(1, 3, -1));
+	CHECK_THROWS_MATCHES(gdwg::communities(g),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::communities on a graph with a "
+	                                              "negative weight"));
+}
+
+TEST_CASE("communities count non-arithmetic edges once each") {
+	auto g = gdwg::graph<int, std::string>{1, 2, 3, 4, 5, 6, 7};
+	for (auto const& [from, to] :
+	     std::vector<std::pair<int, int>>{{1, 2}, {2, 3}, {3, 1}, {4, 5}, {5, 6}, {6, 4}, {3, 4}})
+	{
+		CHECK(g.insert_edge(from, to, "x"));
+	}
+	CHECK(gdwg::communities(g) == std::vector<std::size_t>{0, 0, 0, 1, 1, 1, 2});
+}
+
+TEST_CASE("parallel community detection finds every clique in a ring") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	// Few enough cliques that merging neighbours would lower modularity.
+	auto const g = ring_of_cliques(12, 6);
+	for (auto const seed : {1U, 2U, 3U}) {
+		auto options = gdwg::community_options{};
+		options.seed = seed;
+		expect_blocks(gdwg::communities(g, options), 12, 6);
+		options.algorithm = gdwg::community_algorithm::label_propagation;
+		expect_whole_blocks(gdwg::communities(g, options), 12, 6);
+	}
+}
+
+TEST_CASE("louvain beats the planted partition of a random graph") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	constexpr auto groups = 8;
+	auto const g = planted_partition(800, groups, 5U);
+	auto planted = std::vector<std::size_t>{};
+	for (auto i = 0; i < 800; ++i) {
+		planted.push_back(static_cast<std::size_t>(i % groups));
+	}
+	auto const target = gdwg::modularity(g, planted);
+
+	auto const ids = gdwg::communities(g);
+	REQUIRE(ids.size() == 800U);
+	CHECK(gdwg::modularity(g, ids) >= target - 1e-9);
+
+	auto options = gdwg::community_options{};
+	options.algorithm = gdwg::community_algorithm::label_propagation;
+	auto const labels = gdwg::communities(g, options);
+	CHECK(gdwg::modularity(g, labels) > 0.5 * target);
+	CHECK(gdwg::modularity(g, labels) <= gdwg::modularity(g, ids) + 1e-9);
+}
@@ -0,0 +1,164 @@
+#include "gdwg/components.hpp"
+#include "gdwg/graph.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <deque>
+#include <numeric>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+	using gdwg::testing::index_weights;
+	using gdwg::testing::random_graph;
+
+	// Reference labelling by breadth-first search over the undirected view.
+	auto reference_components(gdwg::graph<int, int> const& g) -> std::vector<std::size_t> {
+		auto const n = g.nodes().size();
+		auto neighbours = std::vector<std::vector<int>>(n);
+		for (auto const& [from, to, weight] : g) {
+			neighbours[static_cast<std::size_t>(from)].push_back(to);
+			neighbours[static_cast<std::size_t>(to)].push_back(from);
+		}
+		auto labels = std::vector<std::size_t>(n, n);
+		auto count = std::size_t{0};
+		for (auto start = std::size_t{0}; start < n; ++start) {
+			if (labels[start] != n) {
+				continue;
+			}
+			auto queue = std::deque<std::size_t>{start};
+			labels[start] = count;
+			while (not queue.empty()) {
+				auto const u = queue.front();
+				queue.pop_front();
+				for (auto const v : neighbours[u]) {
+					if (labels[static_cast<std::size_t>(v)] == n) {
+						labels[static_cast<std::size_t>(v)] = count;
+						queue.push_back(static_cast<std::size_t>(v));
+					}
+				}
+			}
+			++count;
+		}
+		return labels;
+	}
+} // namespace
+
+TEST_CASE("connected_components ignores edge direction and numbers components densely") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	CHECK(g.insert_edge("b", "a", 1));
+	CHECK(g.insert_edge("e", "c", 1));
+	CHECK(g.insert_edge("d", "d", 1));
+	CHECK(gdwg::connected_components(g) == std::vector<std::size_t>{0, 0, 1, 2, 1});
+	CHECK(gdwg::connected_components(gdwg::graph<int, int>{}).empty());
+}
+
+TEST_CASE("connected_components merges edge partitions from several threads consistently") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	auto const g = random_graph(30000, 20000, 6771U, index_weights());
+	CHECK(gdwg::connected_components(g) == reference_components(g));
+}
+
+TEST_CASE("strongly_connected_components finds cycles and numbers them by first node") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("b", "a", 1));
+	CHECK(g.insert_edge("b", "c", 2));
+	CHECK(g.insert_edge("c", "d", 3));
+	CHECK(g.insert_edge("d", "c", 4));
+	CHECK(g.insert_edge("e", "e", 5));
+	auto const expected = std::vector<std::size_t>{0, 0, 1, 1, 2};
+	CHECK(gdwg::strongly_connected_components(g, gdwg::scc_algorithm::tarjan) == expected);
+	CHECK(gdwg::strongly_connected_components(g, gdwg::scc_algorithm::parallel) == expected);
+
+	auto const dag = gdwg::condensation(g, expected);
+	CHECK(dag.nodes() == std::vector<std::size_t>{0, 1, 2});
+	CHECK(dag.weights(0, 1) == std::vector<int>{2});
+	CHECK(not dag.is_connected(1, 0));
+	CHECK(not dag.is_connected(2, 2));
+	CHECK_THROWS_WITH(gdwg::condensation(g, std::vector<std::size_t>{0}),
+	                  "Cannot call gdwg::condensation without exactly one component id per node");
+}
+
+TEST_CASE("strongly_connected_components handles chains far deeper than the call stack") {
+	auto constexpr length = 100000;
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < length; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i + 1 < length; ++i) {
+		g.insert_edge(i, i + 1, 0);
+	}
+	auto const chain = gdwg::strongly_connected_components(g, gdwg::scc_algorithm::tarjan);
+	CHECK(std::set<std::size_t>(chain.cbegin(), chain.cend()).size() == length);
+
+	g.insert_edge(length - 1, 0, 0);
+	auto const cycle = gdwg::strongly_connected_components(g, gdwg::scc_algorithm::tarjan);
+	CHECK(cycle == std::vector<std::size_t>(length, 0));
+}
+
+TEST_CASE("the parallel strongly_connected_components agrees with Tarjan") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	for (auto const seed : {1U, 2U, 3U}) {
+		auto const edges = 16000 + 4000 * static_cast<int>(seed);
+		auto const g = random_graph(20000, edges, seed, index_weights());
+		auto const expected = gdwg::strongly_connected_components(g, gdwg::scc_algorithm::tarjan);
+		CHECK(gdwg::strongly_connected_components(g, gdwg::scc_algorithm::parallel) == expected);
+	}
+}
+
+TEST_CASE("the parallel strongly_connected_components hands deep chains over to Tarjan") {
+	// Edges point to lower ids, so colour propagation would need a pass per node and settle one
+	// component per round. Every third node closes a triangle.
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	auto constexpr length = 3 * 45000;
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < length; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 1; i < length; ++i) {
+		g.insert_edge(i, i - 1, 0);
+	}
+	auto chain = std::vector<std::size_t>(length);
+	std::iota(chain.begin(), chain.end(), std::size_t{0});
+	CHECK(gdwg::strongly_connected_components(g, gdwg::scc_algorithm::parallel) == chain);
+
+	for (auto i = 0; i + 2 < length; i += 3) {
+		g.insert_edge(i, i + 2, 0);
+	}
+	auto triangles = std::vector<std::size_t>(length);
+	for (auto i = std::size_t{0}; i < triangles.size(); ++i) {
+		triangles[i] = i / 3U;
+	}
+	CHECK(gdwg::strongly_connected_components(g) == triangles);
+	CHECK(gdwg::strongly_connected_components(g, gdwg::scc_algorithm::parallel) == triangles);
+}
+
+TEST_CASE("the parallel strongly_connected_components hands unsettled colours over to Tarjan") {
+	// A chain towards lower ids that closes through higher ids is one component, but its highest
+	// colour needs a pass per node to reach the bottom of the chain, far more than the pass cap.
+	// The 2-cycle on -2 and -1 comes first, so the forward-backward pivot lands on it.
+	auto constexpr top = 1100;
+	auto g = gdwg::graph<int, int>{-2, -1};
+	for (auto i = 1; i <= top + 2; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = top; i > 1; --i) {
+		g.insert_edge(i, i - 1, 0);
+	}
+	g.insert_edge(1, top + 1, 0);
+	g.insert_edge(top + 1, top + 2, 0);
+	g.insert_edge(top + 2, top, 0);
+	g.insert_edge(-2, -1, 0);
+	g.insert_edge(-1, -2, 0);
+
+	auto expected = std::vector<std::size_t>(top + 4, 1);
+	expected[0] = 0;
+	expected[1] = 0;
+	CHECK(gdwg::strongly_connected_components(g, gdwg::scc_algorithm::tarjan) == expected);
+	for (auto const threads : {1U, 4U}) {
+		auto const limit = gdwg::testing::scoped_max_threads(threads);
+		CHECK(gdwg::strongly_connected_components(g, gdwg::scc_algorithm::parallel) == expected);
+	}
+}
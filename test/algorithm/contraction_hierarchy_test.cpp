@@ -0,0 +1,138 @@
+#include "gdwg/contraction_hierarchy.hpp"
+#include "gdwg/graph.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	// A road-like grid with random travel times, some one-way streets and a few highways.
+	auto road_grid(int side, unsigned seed) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < side * side; ++i) {
+			g.insert_node(i);
+		}
+		auto engine = std::mt19937{seed};
+		auto weight = std::uniform_int_distribution<int>{1, 20};
+		auto chance = std::uniform_int_distribution<int>{0, 9};
+		auto const link = [&](int a, int b) {
+			g.insert_edge(a, b, weight(engine));
+			if (chance(engine) != 0) {
+				g.insert_edge(b, a, weight(engine));
+			}
+		};
+		for (auto r = 0; r < side; ++r) {
+			for (auto c = 0; c < side; ++c) {
+				auto const u = r * side + c;
+				if (c + 1 < side) {
+					link(u, u + 1);
+				}
+				if (r + 1 < side) {
+					link(u, u + side);
+				}
+			}
+		}
+		auto node = std::uniform_int_distribution<int>{0, side * side - 1};
+		for (auto i = 0; i < side; ++i) {
+			link(node(engine), node(engine));
+		}
+		return g;
+	}
+
+	auto reference_distances(gdwg::graph<int, int> const& g, int source)
+	   -> std::vector<std::optional<int>> {
+		auto const n = g.nodes().size();
+		auto distances = std::vector<std::optional<int>>(n);
+		auto heap = std::vector<std::pair<int, int>>{{0, source}};
+		while (not heap.empty()) {
+			std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+			auto const [d, u] = heap.back();
+			heap.pop_back();
+			if (distances[static_cast<std::size_t>(u)].has_value()) {
+				continue;
+			}
+			distances[static_cast<std::size_t>(u)] = d;
+			for (auto const& [from, to, weight] : g) {
+				if (from == u and not distances[static_cast<std::size_t>(to)].has_value()) {
+					heap.emplace_back(d + weight, to);
+					std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+				}
+			}
+		}
+		return distances;
+	}
+
+	auto path_length(gdwg::graph<int, int> const& g, std::vector<int> const& path) -> int {
+		auto total = 0;
+		for (auto i = std::size_t{1}; i < path.size(); ++i) {
+			auto const weights = g.weights(path[i - 1U], path[i]);
+			REQUIRE(not weights.empty());
+			total += *std::min_element(weights.cbegin(), weights.cend());
+		}
+		return total;
+	}
+} // namespace
+
+TEST_CASE("contraction_hierarchy answers shortest paths through shortcuts") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	CHECK(g.insert_edge("a", "b", 2));
+	CHECK(g.insert_edge("a", "b", 9));
+	CHECK(g.insert_edge("b", "c", 2));
+	CHECK(g.insert_edge("a", "c", 5));
+	CHECK(g.insert_edge("c", "d", 1));
+	CHECK(g.insert_edge("d", "d", 1));
+	using hierarchy = gdwg::contraction_hierarchy<std::string, int>;
+	auto const ch = hierarchy(g);
+
+	CHECK(ch.distance("a", "d") == 5);
+	CHECK(ch.distance("a", "a") == 0);
+	CHECK(ch.distance("d", "a") == std::nullopt);
+	CHECK(ch.distance("a", "e") == std::nullopt);
+	CHECK(ch.path("a", "d") == std::vector<std::string>{"a", "b", "c", "d"});
+	CHECK(ch.path("c", "c") == std::vector<std::string>{"c"});
+	CHECK(ch.path("d", "a").empty());
+	CHECK_THROWS_MATCHES(ch.distance("a", "f"),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::contraction_hierarchy<N, E>::"
+	                                              "distance if src or dst node don't exist in the "
+	                                              "graph"));
+
+	CHECK(g.insert_edge("e", "a", -1));
+	CHECK_THROWS_MATCHES(hierarchy(g),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::contraction_hierarchy on a "
+	                                              "graph with a negative weight"));
+}
+
+TEST_CASE("parallel contraction matches Dijkstra on road-like grids") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	for (auto const seed : {1U, 2U}) {
+		auto const g = road_grid(20, seed);
+		auto const ch = gdwg::contraction_hierarchy<int, int>(g);
+		auto query = gdwg::contraction_hierarchy<int, int>::query(ch);
+		for (auto const source : {0, 57, 210, 399}) {
+			auto const expected = reference_distances(g, source);
+			for (auto target = 0; target < 400; ++target) {
+				auto const distance = query.distance(source, target);
+				REQUIRE(distance == expected[static_cast<std::size_t>(target)]);
+				auto const path = query.path(source, target);
+				if (distance.has_value()) {
+					REQUIRE(path.front() == source);
+					REQUIRE(path.back() == target);
+					CHECK(path_length(g, path) == *distance);
+				}
+				else {
+					CHECK(path.empty());
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,100 @@
+#include "gdwg/core_numbers.hpp"
+#include "gdwg/graph.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	using gdwg::testing::index_weights;
+	using gdwg::testing::skewed_random_graph;
+
+	constexpr auto degrees = {gdwg::core_degree::total,
+	                          gdwg::core_degree::in,
+	                          gdwg::core_degree::out};
+
+	// Reference cores straight from the definition: for each k, repeatedly delete nodes whose
+	// degree among the survivors is below k.
+	auto reference_cores(gdwg::graph<int, int> const& g, gdwg::core_degree degree)
+	   -> std::vector<std::size_t> {
+		auto const n = g.nodes().size();
+		auto pairs = std::set<std::pair<std::size_t, std::size_t>>{};
+		for (auto const& [from, to, weight] : g) {
+			if (from != to) {
+				pairs.emplace(static_cast<std::size_t>(from), static_cast<std::size_t>(to));
+			}
+		}
+		auto cores = std::vector<std::size_t>(n, 0U);
+		for (auto k = std::size_t{1};; ++k) {
+			auto alive = std::vector<char>(n, 1);
+			for (auto changed = true; changed;) {
+				changed = false;
+				auto counts = std::vector<std::size_t>(n, 0U);
+				for (auto const& [u, v] : pairs) {
+					if (alive[u] != 0 and alive[v] != 0) {
+						counts[u] += degree != gdwg::core_degree::in ? 1U : 0U;
+						counts[v] += degree != gdwg::core_degree::out ? 1U : 0U;
+					}
+				}
+				for (auto v = std::size_t{0}; v < n; ++v) {
+					if (alive[v] != 0 and counts[v] < k) {
+						alive[v] = 0;
+						changed = true;
+					}
+				}
+			}
+			auto any = false;
+			for (auto v = std::size_t{0}; v < n; ++v) {
+				if (alive[v] != 0) {
+					cores[v] = k;
+					any = true;
+				}
+			}
+			if (not any) {
+				return cores;
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("core_numbers peels by total, in or out degree") {
+	// A directed triangle a -> b -> c -> a with a tail c -> d and a duplicate, reversed edge.
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("a", "b", 2));
+	CHECK(g.insert_edge("b", "c", 1));
+	CHECK(g.insert_edge("c", "a", 1));
+	CHECK(g.insert_edge("c", "d", 1));
+	CHECK(g.insert_edge("d", "d", 1));
+
+	for (auto const algorithm : {gdwg::core_algorithm::bucket, gdwg::core_algorithm::parallel}) {
+		CHECK(gdwg::core_numbers(g, gdwg::core_degree::total, algorithm)
+		      == std::vector<std::size_t>{2, 2, 2, 1});
+		CHECK(gdwg::core_numbers(g, gdwg::core_degree::in, algorithm)
+		      == std::vector<std::size_t>{1, 1, 1, 1});
+		CHECK(gdwg::core_numbers(g, gdwg::core_degree::out, algorithm)
+		      == std::vector<std::size_t>{1, 1, 1, 0});
+	}
+	CHECK(gdwg::core_numbers(gdwg::graph<int, int>{}).empty());
+}
+
+TEST_CASE("bucket and parallel peeling match the definition on random graphs") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	for (auto const seed : {1U, 2U, 3U}) {
+		auto const g = skewed_random_graph(300, 3000, seed, index_weights(2));
+		for (auto const degree : degrees) {
+			auto const expected = reference_cores(g, degree);
+			CHECK(gdwg::core_numbers(g, degree, gdwg::core_algorithm::bucket) == expected);
+			CHECK(gdwg::core_numbers(g, degree, gdwg::core_algorithm::parallel) == expected);
+		}
+	}
+
+	auto const large = skewed_random_graph(20000, 200000, 4U, index_weights(2));
+	for (auto const degree : degrees) {
+		CHECK(gdwg::core_numbers(large, degree, gdwg::core_algorithm::parallel)
+		      == gdwg::core_numbers(large, degree, gdwg::core_algorithm::bucket));
+	}
+}
@@ -0,0 +1,47 @@
+#include "gdwg/csr.hpp"
+#include "gdwg/graph.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("to_csr exports every weight of every edge in node order") {
+	auto g = gdwg::graph<std::string, int>{"c", "a", "b"};
+	CHECK(g.insert_edge("a", "c", 3));
+	CHECK(g.insert_edge("a", "b", 2));
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("c", "c", 4));
+	auto const adjacency = g.to_csr();
+	CHECK(adjacency.nodes == g.nodes());
+	CHECK(adjacency.offsets == std::vector<std::size_t>{0, 3, 3, 4});
+	CHECK(adjacency.targets == std::vector<std::size_t>{1, 1, 2, 2});
+	CHECK(adjacency.weights == std::vector<int>{1, 2, 3, 4});
+	CHECK(adjacency.node_count() == 3);
+	CHECK(adjacency.edge_count() == 4);
+	CHECK(adjacency.degree(0) == 3);
+	CHECK(adjacency.index_of("b") == 1);
+	CHECK(adjacency.contains("c"));
+	CHECK(not adjacency.contains("d"));
+	CHECK_THROWS_AS(adjacency.index_of("d"), std::out_of_range);
+
+	auto const lightest = adjacency.lightest_edges();
+	CHECK(lightest.offsets == std::vector<std::size_t>{0, 2, 2, 3});
+	CHECK(lightest.targets == std::vector<std::size_t>{1, 2, 2});
+	CHECK(lightest.weights == std::vector<int>{1, 3, 4});
+}
+
+TEST_CASE("transpose reverses every edge and keeps rows sorted by source") {
+	auto g = gdwg::graph<std::string, int>{"c", "a", "b"};
+	CHECK(g.insert_edge("a", "c", 3));
+	CHECK(g.insert_edge("a", "b", 2));
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("c", "c", 4));
+	CHECK(g.insert_edge("c", "b", 5));
+	auto const reversed = g.to_csr().transpose();
+	CHECK(reversed.nodes == g.nodes());
+	CHECK(reversed.offsets == std::vector<std::size_t>{0, 0, 3, 5});
+	CHECK(reversed.targets == std::vector<std::size_t>{0, 0, 2, 0, 2});
+	CHECK(reversed.weights == std::vector<int>{1, 2, 5, 3, 4});
+	CHECK(gdwg::graph<int, int>{}.to_csr().transpose().offsets == std::vector<std::size_t>{0});
+}
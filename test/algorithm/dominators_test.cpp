@@ -0,0 +1,133 @@
+#include "gdwg/dominators.hpp"
+#include "gdwg/graph.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	using gdwg::testing::random_graph;
+
+	constexpr auto unreached = gdwg::dominator_tree::unreached;
+
+	// Nodes reachable from `root` without passing through `removed`.
+	auto reachable(gdwg::graph<int, int> const& g, int root, int removed) -> std::vector<char> {
+		auto seen = std::vector<char>(g.nodes().size(), 0);
+		if (root == removed) {
+			return seen;
+		}
+		auto stack = std::vector<int>{root};
+		seen[static_cast<std::size_t>(root)] = 1;
+		while (not stack.empty()) {
+			auto const u = stack.back();
+			stack.pop_back();
+			for (auto const v : g.connections(u)) {
+				if (v != removed and seen[static_cast<std::size_t>(v)] == 0) {
+					seen[static_cast<std::size_t>(v)] = 1;
+					stack.push_back(v);
+				}
+			}
+		}
+		return seen;
+	}
+
+	// Checks the tree against the definition: a dominates b exactly when removing a cuts b off
+	// from the root, and b's immediate dominator is the strict dominator that all others
+	// dominate.
+	auto check_tree(gdwg::graph<int, int> const& g, int root, gdwg::dominator_tree const& tree)
+	   -> void {
+		auto const n = g.nodes().size();
+		auto const everything = reachable(g, root, -1);
+		for (auto a = std::size_t{0}; a < n; ++a) {
+			auto const without = reachable(g, root, static_cast<int>(a));
+			for (auto b = std::size_t{0}; b < n; ++b) {
+				auto const expected = everything[a] != 0 and everything[b] != 0
+				                      and (a == b or without[b] == 0);
+				REQUIRE(tree.dominates(a, b) == expected);
+			}
+		}
+		for (auto b = std::size_t{0}; b < n; ++b) {
+			if (everything[b] == 0) {
+				CHECK(tree.idoms[b] == unreached);
+				continue;
+			}
+			auto const idom = tree.idoms[b];
+			if (b == static_cast<std::size_t>(root)) {
+				CHECK(idom == b);
+				continue;
+			}
+			CHECK(idom != b);
+			CHECK(tree.dominates(idom, b));
+			for (auto a = std::size_t{0}; a < n; ++a) {
+				if (a != b and tree.dominates(a, b)) {
+					CHECK(tree.dominates(a, idom));
+				}
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("dominators and post-dominators of a small control-flow graph") {
+	// entry -> cond -> {then, else} -> join -> exit, with a loop from join back to cond and a
+	// dead block that only reaches exit.
+	auto g = gdwg::graph<std::string, int>{"entry", "cond", "then", "else", "join", "exit", "dead"};
+	CHECK(g.insert_edge("entry", "cond", 1));
+	CHECK(g.insert_edge("cond", "then", 1));
+	CHECK(g.insert_edge("cond", "else", 1));
+	CHECK(g.insert_edge("then", "join", 1));
+	CHECK(g.insert_edge("then", "join", 2));
+	CHECK(g.insert_edge("else", "join", 1));
+	CHECK(g.insert_edge("join", "cond", 1));
+	CHECK(g.insert_edge("join", "exit", 1));
+	CHECK(g.insert_edge("dead", "exit", 1));
+	CHECK(g.insert_edge("then", "then", 1));
+	// Node order: cond, dead, else, entry, exit, join, then.
+	auto const tree = gdwg::dominators(g, std::string{"entry"});
+	CHECK(tree.idoms == std::vector<std::size_t>{3, unreached, 0, 3, 5, 0, 0});
+	CHECK(tree.dominates(0, 4));
+	CHECK(not tree.dominates(6, 5));
+	CHECK(not tree.dominates(1, 1));
+
+	auto const post = gdwg::post_dominators(g, std::string{"exit"});
+	CHECK(post.idoms == std::vector<std::size_t>{5, 4, 5, 0, 4, 4, 5});
+	CHECK(post.dominates(5, 3));
+
+	CHECK_THROWS_MATCHES(gdwg::dominators(g, std::string{"missing"}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::dominators if root node "
+	                                              "doesn't exist in the graph"));
+	CHECK_THROWS_MATCHES(gdwg::post_dominators(g, std::string{"missing"}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::post_dominators if exit node "
+	                                              "doesn't exist in the graph"));
+}
+
+TEST_CASE("dominator trees match the definition on random graphs") {
+	for (auto const seed : {1U, 2U, 3U, 4U, 5U}) {
+		auto const g = random_graph(40, 70, seed);
+		check_tree(g, 0, gdwg::dominators(g, 0));
+		check_tree(g, 7, gdwg::dominators(g, 7));
+	}
+}
+
+TEST_CASE("a long chain does not overflow the stack") {
+	constexpr auto length = 200000;
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < length; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 1; i < length; ++i) {
+		g.insert_edge(i - 1, i, 1);
+		g.insert_edge(i, 0, 1);
+	}
+	auto const tree = gdwg::dominators(g, 0);
+	auto const post = gdwg::post_dominators(g, length - 1);
+	for (auto i = std::size_t{1}; i < length; ++i) {
+		REQUIRE(tree.idoms[i] == i - 1U);
+		REQUIRE(post.idoms[i - 1U] == i);
+	}
+	CHECK(tree.dominates(0, length - 1));
+	CHECK(post.dominates(length - 1, 0));
+}
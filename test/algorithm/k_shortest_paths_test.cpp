@@ -0,0 +1,156 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/k_shortest_paths.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	using gdwg::testing::random_graph;
+	using gdwg::testing::uniform_weights;
+
+	// The length of every loopless path from `u` to `dst`, one per choice of multi-edge weight.
+	auto all_lengths(gdwg::graph<int, int> const& g,
+	                 int u,
+	                 int dst,
+	                 std::vector<int>& visited,
+	                 int length,
+	                 std::vector<int>& lengths) -> void {
+		if (u == dst) {
+			lengths.push_back(length);
+			return;
+		}
+		visited.push_back(u);
+		for (auto const v : g.connections(u)) {
+			if (std::find(visited.cbegin(), visited.cend(), v) == visited.cend()) {
+				for (auto const w : g.weights(u, v)) {
+					all_lengths(g, v, dst, visited, length + w, lengths);
+				}
+			}
+		}
+		visited.pop_back();
+	}
+
+	auto check_path(gdwg::graph<int, int> const& g,
+	                gdwg::weighted_path<int, int> const& path,
+	                int src,
+	                int dst) -> void {
+		REQUIRE(path.nodes.size() == path.weights.size() + 1U);
+		CHECK(path.nodes.front() == src);
+		CHECK(path.nodes.back() == dst);
+		CHECK(std::set<int>(path.nodes.cbegin(), path.nodes.cend()).size() == path.nodes.size());
+		auto length = 0;
+		for (auto i = std::size_t{0}; i < path.weights.size(); ++i) {
+			CHECK(g.is_connected(path.nodes[i], path.nodes[i + 1U]));
+			auto const weights = g.weights(path.nodes[i], path.nodes[i + 1U]);
+			CHECK(std::find(weights.cbegin(), weights.cend(), path.weights[i]) != weights.cend());
+			length += path.weights[i];
+		}
+		CHECK(path.length == length);
+	}
+} // namespace
+
+TEST_CASE("loopless_paths counts each weight of a multi-edge separately") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("a", "b", 2));
+	CHECK(g.insert_edge("b", "c", 1));
+	CHECK(g.insert_edge("c", "a", 1));
+	CHECK(g.insert_edge("a", "c", 4));
+	using path = gdwg::weighted_path<std::string, int>;
+
+	auto paths = gdwg::loopless_paths<std::string, int>(g, "a", "c");
+	CHECK(paths.next() == path{2, {"a", "b", "c"}, {1, 1}});
+	CHECK(paths.next() == path{3, {"a", "b", "c"}, {2, 1}});
+	CHECK(paths.next() == path{4, {"a", "c"}, {4}});
+	CHECK(paths.next() == std::nullopt);
+	CHECK(paths.next() == std::nullopt);
+
+	CHECK(gdwg::k_shortest_paths(g, std::string{"a"}, std::string{"a"}, 3)
+	      == std::vector<path>{path{0, {"a"}, {}}});
+	CHECK(gdwg::k_shortest_paths(g, std::string{"a"}, std::string{"d"}, 3).empty());
+	CHECK(gdwg::k_shortest_paths(g, std::string{"a"}, std::string{"c"}, 2).size() == 2U);
+	CHECK_THROWS_MATCHES(gdwg::k_shortest_paths(g, std::string{"a"}, std::string{"e"}, 1),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::k_shortest_paths if src or dst "
+	                                              "node don't exist in the graph"));
+
+	CHECK(g.insert_edge("d", "a", -1));
+	using enumerator = gdwg::loopless_paths<std::string, int>;
+	CHECK_THROWS_MATCHES(enumerator(g, "a", "c"),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::loopless_paths on a graph with a "
+	                                              "negative weight"));
+}
+
+TEST_CASE("zero-weight cycles do not trap the shortest-path tree") {
+	auto g = gdwg::graph<int, int>{1, 2, 3, 4};
+	CHECK(g.insert_edge(1, 2, 0));
+	CHECK(g.insert_edge(2, 1, 0));
+	CHECK(g.insert_edge(2, 3, 0));
+	CHECK(g.insert_edge(3, 2, 0));
+	CHECK(g.insert_edge(3, 4, 5));
+	CHECK(g.insert_edge(1, 4, 5));
+	auto const paths = gdwg::k_shortest_paths(g, 1, 4, 5);
+	REQUIRE(paths.size() == 2U);
+	for (auto const& path : paths) {
+		check_path(g, path, 1, 4);
+		CHECK(path.length == 5);
+	}
+}
+
+TEST_CASE("parallel deviations enumerate the same lengths as brute force") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	for (auto const seed : {1U, 2U, 3U, 4U}) {
+		auto const g = random_graph(9, 40, seed, uniform_weights(0, 9));
+		for (auto const& [src, dst] : std::vector<std::pair<int, int>>{{0, 8}, {3, 5}}) {
+			auto visited = std::vector<int>{};
+			auto expected = std::vector<int>{};
+			all_lengths(g, src, dst, visited, 0, expected);
+			std::sort(expected.begin(), expected.end());
+
+			auto paths = gdwg::loopless_paths<int, int>(g, src, dst);
+			auto lengths = std::vector<int>{};
+			auto seen = std::set<std::pair<std::vector<int>, std::vector<int>>>{};
+			while (auto const path = paths.next()) {
+				check_path(g, *path, src, dst);
+				CHECK(seen.emplace(path->nodes, path->weights).second);
+				lengths.push_back(path->length);
+			}
+			CHECK(lengths == expected);
+		}
+	}
+}
+
+TEST_CASE("loopless_paths carries on after being moved or copied between paths") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	auto const g = random_graph(9, 40, 1U, uniform_weights(0, 9));
+	auto const expected = gdwg::k_shortest_paths(g, 0, 8, 12);
+	REQUIRE(expected.size() == 12U);
+
+	auto first = gdwg::loopless_paths<int, int>(g, 0, 8);
+	CHECK(first.next() == expected[0]);
+	CHECK(first.next() == expected[1]);
+	auto moved = std::optional<gdwg::loopless_paths<int, int>>{std::move(first)};
+	CHECK(moved->next() == expected[2]);
+	CHECK(moved->next() == expected[3]);
+
+	auto copy = *moved;
+	moved = gdwg::loopless_paths<int, int>(g, 0, 8);
+	for (auto i = std::size_t{4}; i < expected.size(); ++i) {
+		CHECK(copy.next() == expected[i]);
+	}
+	for (auto i = std::size_t{0}; i < 4U; ++i) {
+		CHECK(moved->next() == expected[i]);
+	}
+	copy = std::move(*moved);
+	for (auto i = std::size_t{4}; i < expected.size(); ++i) {
+		CHECK(copy.next() == expected[i]);
+	}
+}
@@ -0,0 +1,173 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/landmarks.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	// A road-like grid with random travel times and some one-way streets, plus a one-way spur
+	// that leads away from the grid and never back.
+	auto road_grid(int side, unsigned seed) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < side * side + 3; ++i) {
+			g.insert_node(i);
+		}
+		auto engine = std::mt19937{seed};
+		auto weight = std::uniform_int_distribution<int>{1, 20};
+		auto chance = std::uniform_int_distribution<int>{0, 9};
+		auto const link = [&](int a, int b) {
+			g.insert_edge(a, b, weight(engine));
+			if (chance(engine) != 0) {
+				g.insert_edge(b, a, weight(engine));
+			}
+		};
+		for (auto r = 0; r < side; ++r) {
+			for (auto c = 0; c < side; ++c) {
+				auto const u = r * side + c;
+				if (c + 1 < side) {
+					link(u, u + 1);
+				}
+				if (r + 1 < side) {
+					link(u, u + side);
+				}
+			}
+		}
+		g.insert_edge(side * side - 1, side * side, 4);
+		g.insert_edge(side * side, side * side + 1, 0);
+		g.insert_edge(side * side + 1, side * side, 3);
+		return g;
+	}
+
+	auto reference_distances(gdwg::graph<int, int> const& g, int source)
+	   -> std::vector<std::optional<int>> {
+		auto const n = g.nodes().size();
+		auto distances = std::vector<std::optional<int>>(n);
+		auto heap = std::vector<std::pair<int, int>>{{0, source}};
+		while (not heap.empty()) {
+			std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+			auto const [d, u] = heap.back();
+			heap.pop_back();
+			if (distances[static_cast<std::size_t>(u)].has_value()) {
+				continue;
+			}
+			distances[static_cast<std::size_t>(u)] = d;
+			for (auto const& [from, to, weight] : g) {
+				if (from == u and not distances[static_cast<std::size_t>(to)].has_value()) {
+					heap.emplace_back(d + weight, to);
+					std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+				}
+			}
+		}
+		return distances;
+	}
+
+	auto path_length(gdwg::graph<int, int> const& g, std::vector<int> const& path) -> int {
+		auto total = 0;
+		for (auto i = std::size_t{1}; i < path.size(); ++i) {
+			auto const weights = g.weights(path[i - 1U], path[i]);
+			REQUIRE(not weights.empty());
+			total += *std::min_element(weights.cbegin(), weights.cend());
+		}
+		return total;
+	}
+} // namespace
+
+TEST_CASE("landmark_oracle bounds distances and answers A* queries") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	CHECK(g.insert_edge("a", "b", 2));
+	CHECK(g.insert_edge("a", "b", 9));
+	CHECK(g.insert_edge("b", "c", 2));
+	CHECK(g.insert_edge("a", "c", 5));
+	CHECK(g.insert_edge("c", "d", 1));
+	CHECK(g.insert_edge("d", "d", 1));
+	using oracle_type = gdwg::landmark_oracle<std::string, int>;
+	auto const oracle = oracle_type(g, {.count = 8});
+
+	auto const landmarks = oracle.landmarks();
+	CHECK(std::set<std::string>(landmarks.cbegin(), landmarks.cend()).size() == 5U);
+	// With every node a landmark, both bounds are exact.
+	CHECK(oracle.lower_bound("a", "d") == 5);
+	CHECK(oracle.upper_bound("a", "d") == 5);
+	CHECK(oracle.lower_bound("d", "a") == std::numeric_limits<int>::max());
+	CHECK(oracle.upper_bound("d", "a") == std::nullopt);
+	CHECK(oracle.upper_bound("e", "e") == 0);
+	CHECK(oracle.distance("a", "d") == 5);
+	CHECK(oracle.distance("a", "e") == std::nullopt);
+	CHECK(oracle.path("a", "d") == std::vector<std::string>{"a", "b", "c", "d"});
+	CHECK(oracle.path("c", "c") == std::vector<std::string>{"c"});
+	CHECK(oracle.path("d", "a").empty());
+	CHECK_THROWS_MATCHES(oracle.lower_bound("a", "f"),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::landmark_oracle<N, E>::"
+	                                              "lower_bound if src or dst node don't exist in "
+	                                              "the graph"));
+
+	CHECK(oracle_type(gdwg::graph<std::string, int>{}).landmarks().empty());
+	CHECK(g.insert_edge("e", "a", -1));
+	CHECK_THROWS_MATCHES(oracle_type(g),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::landmark_oracle on a graph "
+	                                              "with a negative weight"));
+}
+
+TEST_CASE("landmark bounds bracket Dijkstra distances on road-like grids") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	auto const g = road_grid(20, 3U);
+	auto const n = static_cast<int>(g.nodes().size());
+	for (auto const selection : {gdwg::landmark_selection::farthest,
+	                             gdwg::landmark_selection::avoid})
+	{
+		auto const oracle = gdwg::landmark_oracle<int, int>(g, {.count = 6, .selection = selection});
+		REQUIRE(oracle.landmarks().size() == 6U);
+		auto query = gdwg::landmark_oracle<int, int>::query(oracle);
+		for (auto const source : {0, 57, 210, 399, 401}) {
+			auto const expected = reference_distances(g, source);
+			for (auto target = 0; target < n; ++target) {
+				auto const exact = expected[static_cast<std::size_t>(target)];
+				auto const lower = oracle.lower_bound(source, target);
+				auto const upper = oracle.upper_bound(source, target);
+				auto const distance = query.distance(source, target);
+				REQUIRE(distance == exact);
+				auto const path = query.path(source, target);
+				if (exact.has_value()) {
+					CHECK(lower <= *exact);
+					CHECK((not upper.has_value() or *upper >= *exact));
+					REQUIRE(path.front() == source);
+					REQUIRE(path.back() == target);
+					CHECK(path_length(g, path) == *exact);
+				}
+				else {
+					CHECK(not upper.has_value());
+					CHECK(path.empty());
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("the landmark heuristic settles fewer nodes than a blind search") {
+	auto const g = road_grid(30, 5U);
+	auto const blind = gdwg::landmark_oracle<int, int>(g, {.count = 0});
+	auto const guided = gdwg::landmark_oracle<int, int>(g);
+	auto blind_query = gdwg::landmark_oracle<int, int>::query(blind);
+	auto guided_query = gdwg::landmark_oracle<int, int>::query(guided);
+	auto blind_total = std::size_t{0};
+	auto guided_total = std::size_t{0};
+	auto const queries = std::vector<std::pair<int, int>>{{0, 899}, {15, 885}, {450, 479}};
+	for (auto const& [source, target] : queries) {
+		CHECK(blind_query.distance(source, target) == guided_query.distance(source, target));
+		blind_total += blind_query.settled();
+		guided_total += guided_query.settled();
+	}
+	CHECK(guided_total * 2U < blind_total);
+}
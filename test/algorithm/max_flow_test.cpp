@@ -0,0 +1,168 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/max_flow.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	using gdwg::testing::random_graph;
+	using gdwg::testing::uniform_weights;
+
+	// Reference maximum flow by Edmonds-Karp on a capacity matrix.
+	auto reference_max_flow(gdwg::graph<int, int> const& g, int source, int sink) -> int {
+		auto const n = g.nodes().size();
+		auto capacity = std::vector<std::vector<int>>(n, std::vector<int>(n, 0));
+		for (auto const& [from, to, weight] : g) {
+			if (from != to) {
+				capacity[static_cast<std::size_t>(from)][static_cast<std::size_t>(to)] += weight;
+			}
+		}
+		auto const s = static_cast<std::size_t>(source);
+		auto const t = static_cast<std::size_t>(sink);
+		auto total = 0;
+		while (true) {
+			auto parent = std::vector<std::size_t>(n, n);
+			parent[s] = s;
+			auto queue = std::deque<std::size_t>{s};
+			while (not queue.empty() and parent[t] == n) {
+				auto const u = queue.front();
+				queue.pop_front();
+				for (auto v = std::size_t{0}; v < n; ++v) {
+					if (parent[v] == n and capacity[u][v] > 0) {
+						parent[v] = u;
+						queue.push_back(v);
+					}
+				}
+			}
+			if (parent[t] == n) {
+				return total;
+			}
+			auto bottleneck = capacity[parent[t]][t];
+			for (auto v = t; v != s; v = parent[v]) {
+				bottleneck = std::min(bottleneck, capacity[parent[v]][v]);
+			}
+			for (auto v = t; v != s; v = parent[v]) {
+				capacity[parent[v]][v] -= bottleneck;
+				capacity[v][parent[v]] += bottleneck;
+			}
+			total += bottleneck;
+		}
+	}
+
+	// Checks capacity limits, conservation and that the cut is saturated and as heavy as the flow.
+	template<typename N, typename E>
+	auto check_flow(gdwg::graph<N, E> const& g,
+	                N const& source,
+	                N const& sink,
+	                gdwg::max_flow_result<N, E> const& result) -> void {
+		auto balance = std::map<N, E>{};
+		for (auto const& [from, to, flow] : result.flows) {
+			auto capacity = E{0};
+			for (auto const weight : g.weights(from, to)) {
+				capacity += weight;
+			}
+			CHECK(flow >= E{0});
+			CHECK(flow <= capacity);
+			balance[from] -= flow;
+			balance[to] += flow;
+		}
+		for (auto const& [node, net] : balance) {
+			if (node == source) {
+				CHECK(net == -result.value);
+			}
+			else if (node == sink) {
+				CHECK(net == result.value);
+			}
+			else {
+				CHECK(net == E{0});
+			}
+		}
+
+		auto const side = std::set<N>(result.source_side.cbegin(), result.source_side.cend());
+		CHECK(side.contains(source));
+		CHECK(not side.contains(sink));
+		auto cut = E{0};
+		for (auto const& [from, to, weight] : g) {
+			if (side.contains(from) and not side.contains(to)) {
+				cut += weight;
+			}
+		}
+		CHECK(cut == result.value);
+	}
+} // namespace
+
+TEST_CASE("max_flow finds the maximum flow and a minimum cut") {
+	auto g = gdwg::graph<std::string, int>{"s", "a", "b", "c", "d", "t"};
+	CHECK(g.insert_edge("s", "a", 16));
+	CHECK(g.insert_edge("s", "c", 13));
+	CHECK(g.insert_edge("a", "b", 12));
+	CHECK(g.insert_edge("c", "a", 4));
+	CHECK(g.insert_edge("b", "c", 9));
+	CHECK(g.insert_edge("c", "d", 14));
+	CHECK(g.insert_edge("d", "b", 7));
+	CHECK(g.insert_edge("b", "t", 20));
+	CHECK(g.insert_edge("d", "t", 4));
+
+	auto const result = gdwg::max_flow(g, std::string{"s"}, std::string{"t"});
+	CHECK(result.value == 23);
+	CHECK(result.flows.size() == 9);
+	CHECK(result.source_side == std::vector<std::string>{"a", "c", "d", "s"});
+	check_flow(g, std::string{"s"}, std::string{"t"}, result);
+}
+
+TEST_CASE("max_flow sums the capacities of a multi-edge and ignores self-loops") {
+	auto g = gdwg::graph<int, double>{1, 2, 3};
+	CHECK(g.insert_edge(1, 2, 1.5));
+	CHECK(g.insert_edge(1, 2, 2.0));
+	CHECK(g.insert_edge(2, 2, 100.0));
+	CHECK(g.insert_edge(2, 3, 10.0));
+	CHECK(g.insert_edge(3, 2, 1.0));
+
+	auto const result = gdwg::max_flow(g, 1, 3);
+	CHECK(result.value == Approx(3.5));
+	REQUIRE(result.flows.size() == 3);
+	CHECK((result.flows[0].from == 1 and result.flows[0].to == 2));
+	CHECK(result.flows[0].weight == Approx(3.5));
+	CHECK(result.source_side == std::vector<int>{1});
+
+	auto const none = gdwg::max_flow(g, 3, 1);
+	CHECK(none.value == 0.0);
+	CHECK(none.source_side == std::vector<int>{2, 3});
+}
+
+TEST_CASE("max_flow matches Edmonds-Karp on random graphs") {
+	for (auto const seed : {1U, 2U, 3U, 4U, 5U, 6U}) {
+		auto const g = random_graph(40, 200, seed, uniform_weights(0, 20));
+		for (auto const& [source, sink] : {std::pair{0, 39}, std::pair{5, 17}, std::pair{30, 2}})
+		{
+			auto const result = gdwg::max_flow(g, source, sink);
+			CHECK(result.value == reference_max_flow(g, source, sink));
+			check_flow(g, source, sink, result);
+		}
+	}
+}
+
+TEST_CASE("max_flow rejects invalid arguments") {
+	auto g = gdwg::graph<int, int>{1, 2};
+	CHECK(g.insert_edge(1, 2, 3));
+	CHECK_THROWS_MATCHES(gdwg::max_flow(g, 1, 3),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::max_flow if source or sink "
+	                                              "node don't exist in the graph"));
+	CHECK_THROWS_MATCHES(gdwg::max_flow(g, 1, 1),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::max_flow when source and sink "
+	                                              "are the same node"));
+	CHECK(g.insert_edge(2, 1, -1));
+	CHECK_THROWS_MATCHES(gdwg::max_flow(g, 1, 2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::max_flow on a graph with a "
+	                                              "negative capacity"));
+}
@@ -0,0 +1,260 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/max_flow.hpp"
+#include "gdwg/min_cost_flow.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	using gdwg::testing::random_graph;
+
+	using arc = std::pair<int, int>;
+
+	constexpr auto algorithms = {gdwg::min_cost_flow_algorithm::successive_shortest_paths,
+	                             gdwg::min_cost_flow_algorithm::cost_scaling};
+
+	// Capacities in [0, 10] and costs in [min_cost, 30]. Only forward edges may cost less than
+	// nothing, and every backward edge then costs more than any run of them, so that no negative
+	// cycle can form.
+	auto random_arcs(int nodes, int min_cost) {
+		return [capacity = std::uniform_int_distribution<int>{0, 10},
+		        cost = std::uniform_int_distribution<int>{min_cost, 30},
+		        nodes,
+		        min_cost](int, int from, int to, std::mt19937& engine) mutable {
+			auto const c = capacity(engine);
+			auto const w = cost(engine);
+			return arc{c, min_cost < 0 and to < from ? w - min_cost * nodes : w};
+		};
+	}
+
+	// Checks conservation, capacities and optimality: a flow is cheapest exactly when its residual
+	// graph has no negative cost cycle. Self-loops carry no flow and are left out.
+	auto check_optimal(gdwg::graph<int, arc> const& g,
+	                   int source,
+	                   int sink,
+	                   gdwg::min_cost_flow_result<int, int> const& result) -> void {
+		auto const n = g.nodes().size();
+		auto balance = std::vector<int>(n, 0);
+		auto residual = std::vector<std::pair<std::pair<std::size_t, std::size_t>, int>>{};
+		auto i = std::size_t{0};
+		auto cost = 0;
+		for (auto const& [from, to, weight] : g) {
+			auto const flow = result.edge_flows[i++];
+			auto const u = static_cast<std::size_t>(from);
+			auto const v = static_cast<std::size_t>(to);
+			CHECK(flow >= 0);
+			CHECK(flow <= weight.first);
+			balance[u] -= flow;
+			balance[v] += flow;
+			cost += flow * weight.second;
+			if (u == v) {
+				continue;
+			}
+			if (flow < weight.first) {
+				residual.push_back({{u, v}, weight.second});
+			}
+			if (flow > 0) {
+				residual.push_back({{v, u}, -weight.second});
+			}
+		}
+		CHECK(result.cost == cost);
+		for (auto u = std::size_t{0}; u < n; ++u) {
+			auto const expected = u == static_cast<std::size_t>(source) ? -result.flow
+			                      : u == static_cast<std::size_t>(sink) ? result.flow
+			                                                            : 0;
+			CHECK(balance[u] == expected);
+		}
+
+		auto distance = std::vector<int>(n, 0);
+		auto changed = true;
+		for (auto round = std::size_t{0}; round <= n and changed; ++round) {
+			changed = false;
+			for (auto const& [ends, weight] : residual) {
+				if (distance[ends.first] + weight < distance[ends.second]) {
+					distance[ends.second] = distance[ends.first] + weight;
+					changed = true;
+				}
+			}
+		}
+		CHECK(not changed);
+	}
+} // namespace
+
+TEST_CASE("min_cost_flow solves an assignment problem") {
+	auto g = gdwg::graph<std::string, arc>{"s", "t", "w1", "w2", "w3", "j1", "j2", "j3"};
+	auto const cost = std::map<std::pair<std::string, std::string>, int>{
+	   {{"w1", "j1"}, 9}, {{"w1", "j2"}, 2}, {{"w1", "j3"}, 7},
+	   {{"w2", "j1"}, 6}, {{"w2", "j2"}, 4}, {{"w2", "j3"}, 3},
+	   {{"w3", "j1"}, 5}, {{"w3", "j2"}, 8}, {{"w3", "j3"}, 1}};
+	for (auto const& [pair, c] : cost) {
+		CHECK(g.insert_edge(pair.first, pair.second, {1, c}));
+	}
+	for (auto const* const worker : {"w1", "w2", "w3"}) {
+		CHECK(g.insert_edge("s", worker, {1, 0}));
+	}
+	for (auto const* const job : {"j1", "j2", "j3"}) {
+		CHECK(g.insert_edge(job, "t", {1, 0}));
+	}
+
+	for (auto const algorithm : algorithms) {
+		auto const result = gdwg::min_cost_flow(g, std::string{"s"}, std::string{"t"}, algorithm);
+		CHECK(result.flow == 3);
+		// w1 -> j2, w2 -> j1, w3 -> j3.
+		CHECK(result.cost == 9);
+		auto assigned = std::vector<std::pair<std::string, std::string>>{};
+		auto i = std::size_t{0};
+		for (auto const& [from, to, weight] : g) {
+			if (result.edge_flows[i++] == 1 and from.starts_with("w")) {
+				assigned.emplace_back(from, to);
+			}
+		}
+		CHECK(assigned
+		      == std::vector<std::pair<std::string, std::string>>{{"w1", "j2"},
+		                                                          {"w2", "j1"},
+		                                                          {"w3", "j3"}});
+	}
+}
+
+TEST_CASE("min_cost_flow treats every weight of a multi-edge as a separate edge") {
+	auto g = gdwg::graph<char, arc>{'a', 'b', 'c'};
+	CHECK(g.insert_edge('a', 'b', {3, 5}));
+	CHECK(g.insert_edge('a', 'b', {2, 1}));
+	CHECK(g.insert_edge('b', 'b', {9, -4}));
+	CHECK(g.insert_edge('b', 'c', {4, 0}));
+
+	for (auto const algorithm : algorithms) {
+		auto const result = gdwg::min_cost_flow(g, 'a', 'c', algorithm);
+		CHECK(result.flow == 4);
+		CHECK(result.cost == 2 * 1 + 2 * 5);
+		// Edges in iteration order: (a, b, {2, 1}), (a, b, {3, 5}), (b, b, ...), (b, c, ...).
+		CHECK(result.edge_flows == std::vector<int>{2, 2, 0, 4});
+	}
+}
+
+TEST_CASE("min_cost_flow reads capacities and costs through accessors") {
+	// Each weight packs a capacity and a cost as capacity * 100 + cost.
+	auto g = gdwg::graph<int, int>{1, 2, 3, 4};
+	CHECK(g.insert_edge(1, 2, 504));
+	CHECK(g.insert_edge(1, 3, 301));
+	CHECK(g.insert_edge(3, 2, 301));
+	CHECK(g.insert_edge(2, 4, 402));
+	CHECK(g.insert_edge(3, 4, 110));
+
+	auto const capacity = [](int weight) { return weight / 100; };
+	auto const cost = [](int weight) { return static_cast<double>(weight % 100); };
+	auto const result = gdwg::min_cost_flow(g, 1, 4, capacity, cost);
+	CHECK(result.flow == 5);
+	// Saturating 3-4 uses one unit of 1-3, which leaves room for two units along 1-3-2-4 at 4
+	// each. The other two take 1-2-4 at 6 each, and the one along 1-3-4 costs 11.
+	CHECK(result.cost == Approx(31.0));
+	CHECK_THROWS_MATCHES(
+	   gdwg::min_cost_flow(g, 1, 4, capacity, cost, gdwg::min_cost_flow_algorithm::cost_scaling),
+	   std::runtime_error,
+	   Catch::Matchers::Message("Cannot call gdwg::min_cost_flow with cost_scaling on "
+	                            "non-integral costs"));
+}
+
+TEST_CASE("min_cost_flow supports unsigned capacities") {
+	// Every edge is needed for the maximum flow, so both paths carry two units at a cost of 4.
+	auto g = gdwg::graph<int, std::pair<unsigned, int>>{1, 2, 3, 4};
+	CHECK(g.insert_edge(1, 2, {2U, 1}));
+	CHECK(g.insert_edge(1, 3, {2U, 3}));
+	CHECK(g.insert_edge(2, 3, {1U, 1}));
+	CHECK(g.insert_edge(2, 4, {2U, 3}));
+	CHECK(g.insert_edge(3, 4, {2U, 1}));
+	for (auto const algorithm : algorithms) {
+		auto const result = gdwg::min_cost_flow(g, 1, 4, algorithm);
+		CHECK(result.flow == 4U);
+		CHECK(result.cost == 16);
+		CHECK(result.edge_flows == std::vector<unsigned>{2U, 2U, 0U, 2U, 2U});
+	}
+}
+
+TEST_CASE("min_cost_flow with unsigned costs matches the same graph with signed costs") {
+	for (auto const seed : {1U, 2U, 3U, 4U, 5U}) {
+		auto const g = random_graph(30, 150, seed, random_arcs(30, 0));
+		auto unsigned_g = gdwg::graph<int, std::pair<unsigned, unsigned>>{};
+		for (auto const& node : g.nodes()) {
+			unsigned_g.insert_node(node);
+		}
+		for (auto const& [from, to, weight] : g) {
+			unsigned_g.insert_edge(from,
+			                       to,
+			                       {static_cast<unsigned>(weight.first),
+			                        static_cast<unsigned>(weight.second)});
+		}
+		for (auto const algorithm : algorithms) {
+			auto const expected = gdwg::min_cost_flow(g, 0, 29, algorithm);
+			auto const result = gdwg::min_cost_flow(unsigned_g, 0, 29, algorithm);
+			CHECK(result.flow == static_cast<unsigned>(expected.flow));
+			CHECK(result.cost == static_cast<unsigned>(expected.cost));
+		}
+	}
+}
+
+TEST_CASE("successive shortest paths and cost scaling agree on random graphs") {
+	for (auto const seed : {1U, 2U, 3U, 4U}) {
+		for (auto const min_cost : {0, -10}) {
+			auto const g = random_graph(30, 150, seed, random_arcs(30, min_cost));
+			// The max_flow reference needs one summed capacity per multi-edge.
+			auto summed = std::map<std::pair<int, int>, int>{};
+			for (auto const& [from, to, weight] : g) {
+				summed[{from, to}] += weight.first;
+			}
+			auto capacities = gdwg::graph<int, int>{};
+			for (auto const& node : g.nodes()) {
+				capacities.insert_node(node);
+			}
+			for (auto const& [ends, capacity] : summed) {
+				capacities.insert_edge(ends.first, ends.second, capacity);
+			}
+			auto const maximum = gdwg::max_flow(capacities, 0, 29);
+			auto const ssp = gdwg::min_cost_flow(
+			   g,
+			   0,
+			   29,
+			   gdwg::min_cost_flow_algorithm::successive_shortest_paths);
+			auto const scaling =
+			   gdwg::min_cost_flow(g, 0, 29, gdwg::min_cost_flow_algorithm::cost_scaling);
+			CHECK(ssp.flow == maximum.value);
+			CHECK(scaling.flow == maximum.value);
+			CHECK(ssp.cost == scaling.cost);
+			check_optimal(g, 0, 29, ssp);
+			check_optimal(g, 0, 29, scaling);
+		}
+	}
+}
+
+TEST_CASE("min_cost_flow rejects invalid arguments") {
+	auto g = gdwg::graph<int, arc>{1, 2, 3};
+	CHECK(g.insert_edge(1, 2, {1, 1}));
+	CHECK_THROWS_MATCHES(gdwg::min_cost_flow(g, 1, 4),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::min_cost_flow if source or "
+	                                              "sink node don't exist in the graph"));
+	CHECK_THROWS_MATCHES(gdwg::min_cost_flow(g, 2, 2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::min_cost_flow when source and "
+	                                              "sink are the same node"));
+
+	CHECK(g.insert_edge(2, 3, {2, -5}));
+	CHECK(g.insert_edge(3, 2, {2, 1}));
+	for (auto const algorithm : algorithms) {
+		CHECK_THROWS_MATCHES(gdwg::min_cost_flow(g, 1, 3, algorithm),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::min_cost_flow on a graph "
+		                                              "with a negative cost cycle"));
+	}
+
+	CHECK(g.insert_edge(1, 3, {-1, 0}));
+	CHECK_THROWS_MATCHES(gdwg::min_cost_flow(g, 1, 3),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::min_cost_flow on a graph with "
+	                                              "a negative capacity"));
+}
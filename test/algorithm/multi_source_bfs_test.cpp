@@ -0,0 +1,71 @@
+#include "gdwg/breadth_first_search.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/multi_source_bfs.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	using gdwg::testing::random_graph;
+
+	constexpr auto unreached = gdwg::breadth_first_tree::unreached;
+} // namespace
+
+TEST_CASE("multi_source_distances gives hop distances from each source") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("a", "b", 2));
+	CHECK(g.insert_edge("b", "c", 1));
+	CHECK(g.insert_edge("c", "a", 1));
+	CHECK(g.insert_edge("c", "d", 1));
+	CHECK(g.insert_edge("d", "d", 1));
+	auto const sources = std::vector<std::string>{"a", "d", "a", "e"};
+	CHECK(gdwg::multi_source_distances(g, sources)
+	      == std::vector<std::vector<std::size_t>>{{0, 1, 2, 3, unreached},
+	                                               {unreached, unreached, unreached, 0, unreached},
+	                                               {0, 1, 2, 3, unreached},
+	                                               {unreached, unreached, unreached, unreached, 0}});
+	CHECK(gdwg::multi_source_distances(g, std::vector<std::string>{}).empty());
+	CHECK_THROWS_MATCHES(gdwg::multi_source_distances(g, std::vector<std::string>{"f"}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::multi_source_bfs if a source "
+	                                              "node doesn't exist in the graph"));
+}
+
+TEST_CASE("every pass width matches single-source searches") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	auto const g = random_graph(400, 1200, 7U);
+	auto sources = std::vector<int>{};
+	for (auto i = 0; i < 600; ++i) {
+		sources.push_back((i * 37) % 400);
+	}
+	auto expected = std::vector<std::vector<std::size_t>>{};
+	for (auto const source : sources) {
+		expected.push_back(gdwg::breadth_first_search(g, source).distances);
+	}
+	for (auto const width : {gdwg::msbfs_width::automatic,
+	                         gdwg::msbfs_width::bits_64,
+	                         gdwg::msbfs_width::bits_256,
+	                         gdwg::msbfs_width::bits_512})
+	{
+		CHECK(gdwg::multi_source_distances(g, sources, width) == expected);
+	}
+
+	// Each source visits each node it reaches exactly once.
+	auto visits = std::vector<std::size_t>(sources.size(), 0U);
+	gdwg::multi_source_bfs(
+	   g,
+	   sources,
+	   [&visits](std::size_t i, std::size_t, std::size_t) { ++visits[i]; },
+	   gdwg::msbfs_width::bits_256);
+	for (auto i = std::size_t{0}; i < sources.size(); ++i) {
+		auto reached = std::size_t{0};
+		for (auto const d : expected[i]) {
+			reached += d != unreached ? 1U : 0U;
+		}
+		CHECK(visits[i] == reached);
+	}
+}
@@ -0,0 +1,122 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/pagerank.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+	using gdwg::testing::index_weights;
+	using gdwg::testing::random_graph;
+
+	// Reference power iteration through the public graph interface. With a `source`, teleports
+	// and dangling mass go to that node only. The error shrinks by `damping` every iteration.
+	auto reference_pagerank(gdwg::graph<int, int> const& g,
+	                        double damping,
+	                        std::optional<std::size_t> source = std::nullopt,
+	                        int iterations = 500) -> std::vector<double> {
+		auto const nodes = g.nodes();
+		auto const n = nodes.size();
+		auto connections = std::vector<std::vector<int>>{};
+		for (auto const node : nodes) {
+			connections.push_back(g.connections(node));
+		}
+		auto const teleport = [&](std::size_t v) {
+			if (source.has_value()) {
+				return v == *source ? 1.0 : 0.0;
+			}
+			return 1.0 / static_cast<double>(n);
+		};
+		auto rank = std::vector<double>(n, 1.0 / static_cast<double>(n));
+		for (auto iteration = 0; iteration < iterations; ++iteration) {
+			auto next = std::vector<double>(n, 0.0);
+			auto dangling = 0.0;
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				auto const& out = connections[u];
+				if (out.empty()) {
+					dangling += rank[u];
+				}
+				auto const share = damping * rank[u] / static_cast<double>(out.size());
+				for (auto const v : out) {
+					next[static_cast<std::size_t>(v)] += share;
+				}
+			}
+			for (auto v = std::size_t{0}; v < n; ++v) {
+				next[v] += ((1.0 - damping) + damping * dangling) * teleport(v);
+			}
+			rank = next;
+		}
+		return rank;
+	}
+
+	auto max_difference(std::vector<double> const& lhs, std::vector<double> const& rhs) -> double {
+		auto result = 0.0;
+		for (auto i = std::size_t{0}; i < lhs.size(); ++i) {
+			result = std::max(result, std::abs(lhs[i] - rhs[i]));
+		}
+		return result;
+	}
+} // namespace
+
+TEST_CASE("pagerank of a cycle is uniform and parallel edges count once") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("a", "b", 2));
+	CHECK(g.insert_edge("b", "c", 1));
+	CHECK(g.insert_edge("c", "a", 1));
+	auto const rank = gdwg::pagerank(g);
+	REQUIRE(rank.size() == 3);
+	for (auto const r : rank) {
+		CHECK(r == Approx(1.0 / 3.0));
+	}
+	CHECK(gdwg::pagerank(gdwg::graph<int, int>{}).empty());
+}
+
+TEST_CASE("pagerank matches a reference power iteration, including dangling nodes") {
+	auto const g = random_graph(300, 900, 6771U, index_weights(3));
+	auto const expected = reference_pagerank(g, 0.85);
+	auto const rank = gdwg::pagerank(g, {0.85, 1e-12, 1000});
+	CHECK(std::accumulate(rank.cbegin(), rank.cend(), 0.0) == Approx(1.0));
+	CHECK(max_difference(rank, expected) < 1e-9);
+}
+
+TEST_CASE("pagerank splits large graphs across workers without changing the answer") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	// Just enough nodes for four chunks of the 4096-node grain.
+	auto const g = random_graph(17000, 51000, 42U, index_weights(3));
+	auto const expected = reference_pagerank(g, 0.5, std::nullopt, 60);
+	auto const rank = gdwg::pagerank(g, {0.5, 1e-12, 1000});
+	CHECK(max_difference(rank, expected) < 1e-9);
+}
+
+TEST_CASE("personalised_pagerank by forward push approximates the personalised power iteration") {
+	auto const g = random_graph(300, 1200, 1234U, index_weights(3));
+	auto const expected = reference_pagerank(g, 0.85, 7U);
+	auto const estimate = gdwg::personalised_pagerank(g, 7, {0.85, 1e-10});
+	CHECK(max_difference(estimate, expected) < 1e-6);
+	CHECK(std::max_element(estimate.cbegin(), estimate.cend()) - estimate.cbegin() == 7);
+}
+
+TEST_CASE("personalised_pagerank rejects a missing source and options it cannot converge on") {
+	auto g = gdwg::graph<int, int>{1, 2};
+	CHECK(g.insert_edge(1, 2, 0));
+	CHECK(g.insert_edge(2, 1, 0));
+	CHECK_THROWS_WITH(gdwg::personalised_pagerank(g, 3),
+	                  "Cannot call gdwg::personalised_pagerank if source doesn't exist in the "
+	                  "graph");
+	for (auto const damping : {1.0, -0.1, 1.5}) {
+		CHECK_THROWS_WITH(gdwg::personalised_pagerank(g, 1, {damping, 1e-6}),
+		                  "Cannot call gdwg::personalised_pagerank with a damping outside [0, 1)");
+	}
+	for (auto const tolerance : {0.0, -1e-6}) {
+		CHECK_THROWS_WITH(gdwg::personalised_pagerank(g, 1, {0.85, tolerance}),
+		                  "Cannot call gdwg::personalised_pagerank with a tolerance that is not "
+		                  "positive");
+	}
+	auto const teleport = gdwg::personalised_pagerank(g, 1, {0.0, 1e-6});
+	CHECK(teleport == std::vector<double>{1.0, 0.0});
+}
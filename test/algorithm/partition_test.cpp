@@ -0,0 +1,154 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+#include "gdwg/partition.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	using gdwg::testing::random_graph;
+	using gdwg::testing::uniform_weights;
+
+	auto part_sizes(std::vector<std::size_t> const& parts, std::size_t k)
+	   -> std::vector<std::size_t> {
+		REQUIRE(std::all_of(parts.cbegin(), parts.cend(), [k](std::size_t p) { return p < k; }));
+		auto sizes = std::vector<std::size_t>(k, 0U);
+		for (auto const p : parts) {
+			++sizes[p];
+		}
+		return sizes;
+	}
+
+	auto max_part(std::size_t n, std::size_t k, double imbalance) -> std::size_t {
+		return std::max((n + k - 1U) / k,
+		                static_cast<std::size_t>((1.0 + imbalance) * static_cast<double>(n)
+		                                         / static_cast<double>(k)));
+	}
+
+	// A rows x cols grid with unit weights, so that the best cuts are straight lines.
+	auto grid(int rows, int cols) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < rows * cols; ++i) {
+			g.insert_node(i);
+		}
+		for (auto r = 0; r < rows; ++r) {
+			for (auto c = 0; c < cols; ++c) {
+				if (c + 1 < cols) {
+					g.insert_edge(r * cols + c, r * cols + c + 1, 1);
+				}
+				if (r + 1 < rows) {
+					g.insert_edge(r * cols + c, (r + 1) * cols + c, 1);
+				}
+			}
+		}
+		return g;
+	}
+} // namespace
+
+TEST_CASE("partition separates two cliques joined by a bridge") {
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 16; ++i) {
+		g.insert_node(i);
+	}
+	for (auto a = 0; a < 8; ++a) {
+		for (auto b = a + 1; b < 8; ++b) {
+			g.insert_edge(a, b, 3);
+			g.insert_edge(a + 8, b + 8, 3);
+		}
+	}
+	g.insert_edge(7, 8, 1);
+	g.insert_edge(0, 0, 5);
+
+	auto const parts = gdwg::partition(g, 2U);
+	CHECK(part_sizes(parts, 2U) == std::vector<std::size_t>{8, 8});
+	for (auto i = std::size_t{1}; i < 8; ++i) {
+		CHECK(parts[i] == parts[0]);
+		CHECK(parts[i + 8U] == parts[8]);
+	}
+	CHECK(parts[0] != parts[8]);
+	CHECK(gdwg::edge_cut(g, parts) == 1.0);
+
+	CHECK(gdwg::partition(g, 1U) == std::vector<std::size_t>(16, 0U));
+	CHECK(gdwg::partition(gdwg::graph<int, int>{}, 3U).empty());
+}
+
+TEST_CASE("edge_cut sums the weight between parts") {
+	auto g = gdwg::graph<std::string, double>{"a", "b", "c"};
+	CHECK(g.insert_edge("a", "b", 1.5));
+	CHECK(g.insert_edge("b", "a", 2.0));
+	CHECK(g.insert_edge("b", "c", 4.0));
+	CHECK(g.insert_edge("c", "c", 8.0));
+	CHECK(gdwg::edge_cut(g, {0, 0, 1}) == 4.0);
+	CHECK(gdwg::edge_cut(g, {0, 1, 1}) == 3.5);
+	CHECK(gdwg::edge_cut(g, {0, 1, 2}) == 7.5);
+	CHECK_THROWS_MATCHES(gdwg::edge_cut(g, {0, 1}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::edge_cut without exactly one "
+	                                              "part id per node"));
+
+	auto h = gdwg::graph<std::string, std::string>{"a", "b"};
+	CHECK(h.insert_edge("a", "b", "x"));
+	CHECK(h.insert_edge("a", "b", "y"));
+	CHECK(gdwg::edge_cut(h, {0, 1}) == 2.0);
+	auto const halves = gdwg::partition(h, 2U);
+	CHECK(halves[0] != halves[1]);
+}
+
+TEST_CASE("partition rejects zero parts and negative weights") {
+	auto g = gdwg::graph<int, int>{1, 2};
+	CHECK(g.insert_edge(1, 2, -1));
+	CHECK_THROWS_MATCHES(gdwg::partition(g, 0U),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::partition with zero parts"));
+	CHECK_THROWS_MATCHES(gdwg::partition(g, 2U),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::partition on a graph with a "
+	                                              "negative weight"));
+	CHECK_THROWS_MATCHES(gdwg::edge_cut(g, {0, 1}),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::edge_cut on a graph with a "
+	                                              "negative weight"));
+}
+
+TEST_CASE("partition cuts a grid close to straight lines within the balance limit") {
+	auto const g = grid(40, 40);
+	for (auto const k : {2U, 4U, 7U}) {
+		auto const parts = gdwg::partition(g, k);
+		auto const sizes = part_sizes(parts, k);
+		CHECK(*std::max_element(sizes.cbegin(), sizes.cend()) <= max_part(1600U, k, 0.03));
+		// Straight cuts give 40 for two parts and 80 for four, where a random assignment would
+		// cut about 1560 * (k - 1) / k edges.
+		if (k == 2U) {
+			CHECK(gdwg::edge_cut(g, parts) <= 64.0);
+		}
+		else if (k == 4U) {
+			CHECK(gdwg::edge_cut(g, parts) <= 120.0);
+		}
+	}
+}
+
+TEST_CASE("partition respects the balance limit and does not depend on the thread count") {
+	auto const g = random_graph(3000, 12000, 11U, uniform_weights(0, 9));
+
+	auto options = gdwg::partition_options{};
+	options.imbalance = 0.1;
+	auto const threads = gdwg::testing::scoped_max_threads(1U);
+	auto const serial = gdwg::partition(g, 5U, options);
+	gdwg::set_max_threads(4);
+	auto const parallel = gdwg::partition(g, 5U, options);
+	CHECK(serial == parallel);
+
+	auto const sizes = part_sizes(parallel, 5U);
+	CHECK(*std::max_element(sizes.cbegin(), sizes.cend()) <= max_part(3000U, 5U, 0.1));
+
+	// Far better than the 4/5 of the edge weight a random assignment would cut.
+	auto total = 0.0;
+	for (auto const& [from, to, w] : g) {
+		total += from != to ? static_cast<double>(w) : 0.0;
+	}
+	CHECK(gdwg::edge_cut(g, parallel) < 0.6 * total);
+}
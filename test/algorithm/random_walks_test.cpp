@@ -0,0 +1,172 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+#include "gdwg/random_walks.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	constexpr auto none = gdwg::random_walker<int, int>::no_node;
+
+	// How often walks of length 3 from `start` end at each node, out of `walks`.
+	auto last_step_shares(gdwg::random_walker<int, int> const& walker,
+	                      std::size_t start,
+	                      std::size_t walks) -> std::vector<double> {
+		auto const starts = std::vector<std::size_t>(walks, start);
+		auto out = std::vector<std::size_t>(walks * walker.length());
+		walker.walk(starts, out);
+		auto shares = std::vector<double>(walker.nodes().size(), 0.0);
+		for (auto i = std::size_t{0}; i < walks; ++i) {
+			auto const last = out[i * walker.length() + walker.length() - 1U];
+			shares[last] += 1.0 / static_cast<double>(walks);
+		}
+		return shares;
+	}
+} // namespace
+
+TEST_CASE("random walks follow out-edges and stop at dead ends") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("b", "c", 1));
+	CHECK(g.insert_edge("c", "a", 1));
+	CHECK(g.insert_edge("c", "d", 0));
+	auto options = gdwg::walk_options{};
+	options.length = 5;
+	options.walks_per_node = 2;
+	options.weighted = true;
+	auto const walks = gdwg::random_walks(g, options);
+	auto const end = gdwg::random_walker<std::string, int>::no_node;
+	// The zero-weight edge to d is never taken, and d has no way out.
+	auto const rounds = std::vector<std::size_t>{
+	   0, 1, 2, 0, 1, 1, 2, 0, 1, 2, 2, 0, 1, 2, 0, 3, end, end, end, end,
+	   0, 1, 2, 0, 1, 1, 2, 0, 1, 2, 2, 0, 1, 2, 0, 3, end, end, end, end,
+	};
+	CHECK(walks == rounds);
+
+	auto const walker = gdwg::random_walker<std::string, int>(g, options);
+	auto out = std::vector<std::size_t>(10);
+	CHECK_THROWS_MATCHES(walker.walk(std::vector<std::size_t>{0}, out),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::random_walker<N, E>::walk "
+	                                              "unless out holds length() nodes per start"));
+	CHECK_THROWS_MATCHES(walker.walk(std::vector<std::size_t>{0, 4}, out),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::random_walker<N, E>::walk "
+	                                              "with a start that is not a node index"));
+	options.q = 0.0;
+	using walker_type = gdwg::random_walker<std::string, int>;
+	CHECK_THROWS_MATCHES(walker_type(g, options),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::random_walker with a "
+	                                              "non-positive p or q"));
+	options.q = 1.0;
+	CHECK(g.insert_edge("d", "a", -1));
+	CHECK_THROWS_MATCHES(walker_type(g, options),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::random_walker on a graph "
+	                                              "with a negative weight"));
+}
+
+TEST_CASE("weighted walks sum the weights of a multi-edge") {
+	auto g = gdwg::graph<int, int>{0, 1, 2, 3};
+	CHECK(g.insert_edge(0, 1, 1));
+	CHECK(g.insert_edge(0, 2, 1));
+	CHECK(g.insert_edge(0, 2, 2));
+	CHECK(g.insert_edge(0, 3, 4));
+	for (auto const target : {1, 2, 3}) {
+		CHECK(g.insert_edge(target, 0, 1));
+	}
+	auto options = gdwg::walk_options{};
+	options.length = 2;
+	options.weighted = true;
+	auto shares = last_step_shares(gdwg::random_walker<int, int>(g, options), 0U, 100000U);
+	CHECK(shares[1] == Approx(0.125).margin(0.01));
+	CHECK(shares[2] == Approx(0.375).margin(0.01));
+	CHECK(shares[3] == Approx(0.5).margin(0.01));
+
+	options.weighted = false;
+	shares = last_step_shares(gdwg::random_walker<int, int>(g, options), 0U, 100000U);
+	CHECK(shares[1] == Approx(1.0 / 3.0).margin(0.01));
+	CHECK(shares[2] == Approx(1.0 / 3.0).margin(0.01));
+}
+
+TEST_CASE("node2vec p and q steer the walk back or away") {
+	// 0 - 1 - {2, 3} in both directions, with 0 also linked to 2.
+	auto g = gdwg::graph<int, int>{0, 1, 2, 3};
+	for (auto const& [a, b] : std::vector<std::pair<int, int>>{{0, 1}, {1, 2}, {1, 3}, {0, 2}}) {
+		CHECK(g.insert_edge(a, b, 1));
+		CHECK(g.insert_edge(b, a, 1));
+	}
+	auto options = gdwg::walk_options{};
+	options.length = 3;
+	// Walks from 0 that step to 1 first; from there 0 is a return, 2 a link and 3 away.
+	auto const shares_after_one = [&] {
+		auto const walker = gdwg::random_walker<int, int>(g, options);
+		auto const starts = std::vector<std::size_t>(200000, 0U);
+		auto out = std::vector<std::size_t>(starts.size() * 3U);
+		walker.walk(starts, out);
+		auto counts = std::vector<double>(4, 0.0);
+		auto total = 0.0;
+		for (auto i = std::size_t{0}; i < starts.size(); ++i) {
+			if (out[i * 3U + 1U] == 1U) {
+				counts[out[i * 3U + 2U]] += 1.0;
+				total += 1.0;
+			}
+		}
+		for (auto& count : counts) {
+			count /= total;
+		}
+		return counts;
+	};
+	options.p = 0.5;
+	options.q = 2.0;
+	auto shares = shares_after_one();
+	// Factors 2, 1 and 0.5.
+	CHECK(shares[0] == Approx(2.0 / 3.5).margin(0.01));
+	CHECK(shares[2] == Approx(1.0 / 3.5).margin(0.01));
+	CHECK(shares[3] == Approx(0.5 / 3.5).margin(0.01));
+	options.p = 4.0;
+	options.q = 0.25;
+	shares = shares_after_one();
+	// Factors 0.25, 1 and 4.
+	CHECK(shares[0] == Approx(0.25 / 5.25).margin(0.01));
+	CHECK(shares[2] == Approx(1.0 / 5.25).margin(0.01));
+	CHECK(shares[3] == Approx(4.0 / 5.25).margin(0.01));
+}
+
+TEST_CASE("walks do not depend on the number of threads") {
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 200; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 200; ++i) {
+		for (auto const step : {1, 7, 31}) {
+			g.insert_edge(i, (i + step) % 200, i % 5 + 1);
+		}
+	}
+	g.insert_node(200);
+	auto options = gdwg::walk_options{};
+	options.length = 20;
+	options.weighted = true;
+	options.q = 0.5;
+	auto const threads = gdwg::testing::scoped_max_threads(1U);
+	auto const single = gdwg::random_walks(g, options);
+	gdwg::set_max_threads(4);
+	auto const walks = gdwg::random_walks(g, options);
+	CHECK(walks == single);
+	REQUIRE(walks.size() == 201U * 10U * 20U);
+	for (auto w = std::size_t{0}; w < walks.size() / 20U; ++w) {
+		CHECK(walks[w * 20U] == w % 201U);
+		for (auto i = std::size_t{1}; i < 20U; ++i) {
+			auto const from = static_cast<int>(walks[w * 20U + i - 1U]);
+			auto const to = walks[w * 20U + i];
+			CHECK((to == none ? from == 200 : g.is_connected(from, static_cast<int>(to))));
+			if (to == none) {
+				break;
+			}
+		}
+	}
+}
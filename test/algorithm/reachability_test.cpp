@@ -0,0 +1,179 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/reachability.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <deque>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	using gdwg::testing::random_graph;
+
+	// Reachability of every pair by a search from every node.
+	auto closure(gdwg::graph<int, int> const& g) -> std::vector<std::vector<bool>> {
+		auto const n = g.nodes().size();
+		auto reach = std::vector<std::vector<bool>>(n, std::vector<bool>(n, false));
+		for (auto s = std::size_t{0}; s < n; ++s) {
+			auto stack = std::vector<int>{static_cast<int>(s)};
+			reach[s][s] = true;
+			while (not stack.empty()) {
+				auto const u = stack.back();
+				stack.pop_back();
+				for (auto const v : g.connections(u)) {
+					if (not reach[s][static_cast<std::size_t>(v)]) {
+						reach[s][static_cast<std::size_t>(v)] = true;
+						stack.push_back(v);
+					}
+				}
+			}
+		}
+		return reach;
+	}
+
+	// The nodes reachable from `source` by breadth-first search.
+	auto reachable_from(gdwg::graph<int, int> const& g, int source) -> std::set<int> {
+		auto reach = std::set<int>{source};
+		auto queue = std::deque<int>{source};
+		while (not queue.empty()) {
+			auto const u = queue.front();
+			queue.pop_front();
+			for (auto const v : g.connections(u)) {
+				if (reach.insert(v).second) {
+					queue.push_back(v);
+				}
+			}
+		}
+		return reach;
+	}
+
+	auto check_index(gdwg::graph<int, int> const& g, gdwg::reachability_index<int> const& index)
+	   -> void {
+		auto const reach = closure(g);
+		auto const n = static_cast<int>(reach.size());
+		for (auto s = 0; s < n; ++s) {
+			for (auto t = 0; t < n; ++t) {
+				CHECK(index.reachable(s, t)
+				      == reach[static_cast<std::size_t>(s)][static_cast<std::size_t>(t)]);
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("reachability_index answers through cycles and condensed components") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("b", "a", 2));
+	CHECK(g.insert_edge("b", "c", 1));
+	CHECK(g.insert_edge("d", "c", 1));
+	CHECK(g.insert_edge("e", "e", 1));
+	auto const index = gdwg::reachability_index<std::string>(g);
+
+	CHECK(index.reachable("a", "a"));
+	CHECK(index.reachable("b", "a"));
+	CHECK(index.reachable("a", "c"));
+	CHECK(index.reachable("d", "c"));
+	CHECK_FALSE(index.reachable("c", "a"));
+	CHECK_FALSE(index.reachable("a", "d"));
+	CHECK_FALSE(index.reachable("e", "a"));
+	CHECK_THROWS_MATCHES(index.reachable("a", "f"),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::reachability_index<N>::"
+	                                              "reachable if src or dst node don't exist in "
+	                                              "the index"));
+}
+
+TEST_CASE("reachability_index matches the transitive closure of random graphs") {
+	for (auto const seed : {1U, 2U, 3U, 4U}) {
+		// From sparse DAG-like pieces up to a graph with a giant component.
+		for (auto const edges : {60, 150, 400}) {
+			auto const g = random_graph(120, edges, seed);
+			check_index(g, gdwg::reachability_index<int>(g));
+		}
+	}
+}
+
+TEST_CASE("reachability_index folds in inserted nodes and edges") {
+	auto g = random_graph(100, 90, 5U);
+	auto index = gdwg::reachability_index<int>(g);
+	auto engine = std::mt19937{9U};
+	auto node = std::uniform_int_distribution<int>{0, 109};
+	for (auto i = 100; i < 110; ++i) {
+		CHECK(g.insert_node(i));
+		CHECK(index.insert_node(i));
+	}
+	CHECK_FALSE(index.insert_node(3));
+	for (auto i = 0; i < 120; ++i) {
+		auto const src = node(engine);
+		auto const dst = node(engine);
+		g.insert_edge(src, dst, 1);
+		index.insert_edge(src, dst);
+		if (i % 20 == 19) {
+			check_index(g, index);
+		}
+	}
+	CHECK_THROWS_MATCHES(index.insert_edge(0, 200),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::reachability_index<N>::"
+	                                              "insert_edge when either src or dst node does not "
+	                                              "exist"));
+}
+
+TEST_CASE("removals make a reachability_index stale until it is rebuilt") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	CHECK(g.insert_edge(1, 2, 1));
+	CHECK(g.insert_edge(2, 3, 1));
+	auto index = gdwg::reachability_index<int>(g);
+	CHECK(index.reachable(1, 3));
+	CHECK_FALSE(index.stale());
+
+	CHECK(g.erase_edge(2, 3, 1));
+	index.erase_edge(2, 3);
+	CHECK(index.stale());
+	CHECK_THROWS_MATCHES(index.reachable(1, 3),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::reachability_index<N>::"
+	                                              "reachable on a stale index without calling "
+	                                              "rebuild first"));
+	index.rebuild(g);
+	CHECK_FALSE(index.stale());
+	CHECK_FALSE(index.reachable(1, 3));
+	CHECK(index.reachable(1, 2));
+}
+
+TEST_CASE("reachability_index condenses long cycles in graphs large enough for parallel SCC") {
+	// A chain towards lower ids that closes through higher ids is a single component, which the
+	// parallel strongly_connected_components must find past its colour propagation pass cap. The
+	// 2-cycle on -2 and -1 draws its forward-backward pivot, and it can reach the chain.
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	auto constexpr top = 1 << 16;
+	auto g = gdwg::graph<int, int>{-2, -1};
+	for (auto i = 1; i <= top + 2; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = top; i > 1; --i) {
+		g.insert_edge(i, i - 1, 0);
+	}
+	g.insert_edge(1, top + 1, 0);
+	g.insert_edge(top + 1, top + 2, 0);
+	g.insert_edge(top + 2, top, 0);
+	g.insert_edge(-2, -1, 0);
+	g.insert_edge(-1, -2, 0);
+	g.insert_edge(-1, top / 2, 0);
+	auto const index = gdwg::reachability_index<int>(g);
+
+	auto const nodes = g.nodes();
+	for (auto const source : {-2, 1, top / 3, top + 2}) {
+		auto const reach = reachable_from(g, source);
+		auto mismatches = 0;
+		for (auto const target : nodes) {
+			if (index.reachable(source, target) != reach.contains(target)) {
+				++mismatches;
+			}
+		}
+		CHECK(mismatches == 0);
+	}
+}
@@ -0,0 +1,89 @@
+#include "gdwg/components.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/spanning_forest.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+	using gdwg::testing::random_graph;
+	using gdwg::testing::uniform_weights;
+
+	auto total(std::vector<gdwg::graph<int, int>::value_type> const& forest) -> long {
+		auto sum = 0L;
+		for (auto const& edge : forest) {
+			sum += edge.weight;
+		}
+		return sum;
+	}
+
+	auto same_edges(std::vector<gdwg::graph<int, int>::value_type> const& lhs,
+	                std::vector<gdwg::graph<int, int>::value_type> const& rhs) -> bool {
+		auto const equal = [](auto const& a, auto const& b) {
+			return a.from == b.from and a.to == b.to and a.weight == b.weight;
+		};
+		return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend(), equal);
+	}
+} // namespace
+
+TEST_CASE("minimum_spanning_forest uses the lightest weight of each multi-edge in either "
+          "direction") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	CHECK(g.insert_edge("a", "b", 7));
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("c", "b", 2));
+	CHECK(g.insert_edge("a", "c", 2));
+	CHECK(g.insert_edge("c", "c", -5));
+	CHECK(g.insert_edge("d", "e", 4));
+
+	for (auto const algorithm :
+	     {gdwg::spanning_forest_algorithm::kruskal, gdwg::spanning_forest_algorithm::boruvka})
+	{
+		auto const forest = gdwg::minimum_spanning_forest(g, algorithm);
+		REQUIRE(forest.size() == 3);
+		CHECK((forest[0].from == "a" and forest[0].to == "b" and forest[0].weight == 1));
+		CHECK((forest[1].from == "a" and forest[1].to == "c" and forest[1].weight == 2));
+		CHECK((forest[2].from == "d" and forest[2].to == "e" and forest[2].weight == 4));
+
+		auto const as_graph = gdwg::minimum_spanning_forest_graph(g, algorithm);
+		CHECK(as_graph.nodes() == g.nodes());
+		CHECK(as_graph.weights("a", "b") == std::vector<int>{1});
+		CHECK(not as_graph.is_connected("c", "b"));
+	}
+}
+
+TEST_CASE("parallel Boruvka and Kruskal agree on random graphs") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	for (auto const seed : {1U, 2U, 3U}) {
+		auto const g = random_graph(3000, 9000, seed, uniform_weights(1, 50));
+		auto const kruskal =
+		   gdwg::minimum_spanning_forest(g, gdwg::spanning_forest_algorithm::kruskal);
+		auto const boruvka =
+		   gdwg::minimum_spanning_forest(g, gdwg::spanning_forest_algorithm::boruvka);
+		CHECK(same_edges(kruskal, boruvka));
+		CHECK(total(kruskal) == total(boruvka));
+
+		auto const components = gdwg::connected_components(g);
+		auto const trees = std::set<std::size_t>(components.cbegin(), components.cend()).size();
+		CHECK(kruskal.size() == g.nodes().size() - trees);
+	}
+}
+
+TEST_CASE("parallel_sort sorts across chunk boundaries") {
+	auto const threads = gdwg::testing::scoped_max_threads(3U);
+	auto engine = std::mt19937{42U};
+	auto values = std::vector<int>(100000);
+	for (auto& value : values) {
+		value = static_cast<int>(engine() % 1000U);
+	}
+	auto expected = values;
+	std::sort(expected.begin(), expected.end());
+	gdwg::detail::parallel_sort(values.begin(), values.end(), std::less<>{});
+	CHECK(values == expected);
+}
@@ -0,0 +1,166 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/subgraph_matching.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+	using gdwg::testing::random_graph;
+
+	auto collect(gdwg::graph<int, int> const& pattern,
+	             gdwg::graph<int, int> const& target,
+	             gdwg::subgraph_kind kind) -> std::set<std::vector<int>> {
+		auto found = std::set<std::vector<int>>{};
+		auto const count = gdwg::match_subgraphs(
+		   pattern,
+		   target,
+		   [&](std::vector<int> const& images) { CHECK(found.insert(images).second); },
+		   kind);
+		CHECK(count == found.size());
+		return found;
+	}
+
+	// Every injective mapping of the pattern's nodes that keeps its edges, and for an induced
+	// match also its non-edges.
+	auto brute_force(gdwg::graph<int, int> const& pattern,
+	                 gdwg::graph<int, int> const& target,
+	                 gdwg::subgraph_kind kind) -> std::set<std::vector<int>> {
+		auto const pattern_nodes = pattern.nodes();
+		auto const target_nodes = target.nodes();
+		auto found = std::set<std::vector<int>>{};
+		auto images = std::vector<int>{};
+		auto const fits = [&] {
+			for (auto i = std::size_t{0}; i < images.size(); ++i) {
+				for (auto j = std::size_t{0}; j < images.size(); ++j) {
+					auto const wanted = pattern.is_connected(pattern_nodes[i], pattern_nodes[j]);
+					auto const present = target.is_connected(images[i], images[j]);
+					if (wanted ? not present : present and kind == gdwg::subgraph_kind::isomorphism) {
+						return false;
+					}
+				}
+			}
+			return true;
+		};
+		auto const search = [&](auto const& self) -> void {
+			if (not fits()) {
+				return;
+			}
+			if (images.size() == pattern_nodes.size()) {
+				found.insert(images);
+				return;
+			}
+			for (auto const v : target_nodes) {
+				if (std::find(images.cbegin(), images.cend(), v) == images.cend()) {
+					images.push_back(v);
+					self(self);
+					images.pop_back();
+				}
+			}
+		};
+		search(search);
+		return found;
+	}
+} // namespace
+
+TEST_CASE("a directed path matches with and without its chords") {
+	// 1 -> 2 -> 3 -> 4, with a chord 1 -> 3.
+	auto const target = [] {
+		auto g = gdwg::graph<int, int>{1, 2, 3, 4};
+		g.insert_edge(1, 2, 1);
+		g.insert_edge(2, 3, 1);
+		g.insert_edge(3, 4, 1);
+		g.insert_edge(1, 3, 1);
+		return g;
+	}();
+	auto pattern = gdwg::graph<int, int>{0, 1, 2};
+	pattern.insert_edge(0, 1, 1);
+	pattern.insert_edge(1, 2, 1);
+	CHECK(collect(pattern, target, gdwg::subgraph_kind::monomorphism)
+	      == std::set<std::vector<int>>{{1, 2, 3}, {2, 3, 4}, {1, 3, 4}});
+	CHECK(collect(pattern, target, gdwg::subgraph_kind::isomorphism)
+	      == std::set<std::vector<int>>{{2, 3, 4}, {1, 3, 4}});
+}
+
+TEST_CASE("node and edge predicates restrict matches") {
+	auto target = gdwg::graph<std::string, int>{"a1", "a2", "b1", "b2"};
+	CHECK(target.insert_edge("a1", "b1", 5));
+	CHECK(target.insert_edge("a1", "b1", 7));
+	CHECK(target.insert_edge("a2", "b2", 5));
+	CHECK(target.insert_edge("a2", "a1", 7));
+	CHECK(target.insert_edge("b2", "b2", 1));
+	auto pattern = gdwg::graph<char, int>{'a', 'b'};
+	CHECK(pattern.insert_edge('a', 'b', 7));
+	CHECK(pattern.insert_edge('a', 'b', 5));
+	auto const same_letter = [](char label, std::string const& node) { return node[0] == label; };
+
+	auto found = std::vector<std::vector<std::string>>{};
+	auto const count = gdwg::match_subgraphs(
+	   pattern,
+	   target,
+	   [&](std::vector<std::string> const& images) { found.push_back(images); },
+	   gdwg::subgraph_kind::monomorphism,
+	   same_letter,
+	   std::equal_to<>{});
+	CHECK(count == 1U);
+	CHECK(found == std::vector<std::vector<std::string>>{{"a1", "b1"}});
+
+	// Without the weights, both letter pairs fit; a self-loop in the pattern needs one in the
+	// target.
+	CHECK(gdwg::match_subgraphs(
+	         pattern,
+	         target,
+	         [](auto const&) {},
+	         gdwg::subgraph_kind::monomorphism,
+	         same_letter)
+	      == 2U);
+	CHECK(pattern.insert_edge('b', 'b', 3));
+	CHECK(gdwg::match_subgraphs(
+	         pattern,
+	         target,
+	         [](auto const&) {},
+	         gdwg::subgraph_kind::monomorphism,
+	         same_letter)
+	      == 1U);
+	CHECK(gdwg::match_subgraphs(gdwg::graph<char, int>{}, target, [](auto const&) {}) == 1U);
+}
+
+TEST_CASE("returning false from the callback stops the search") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	auto const target = random_graph(60, 600, 3U);
+	auto pattern = gdwg::graph<int, int>{0, 1};
+	pattern.insert_edge(0, 1, 1);
+	auto seen = std::size_t{0};
+	auto const count = gdwg::match_subgraphs(pattern, target, [&](std::vector<int> const&) {
+		++seen;
+		return seen < 10U;
+	});
+	CHECK(count == 10U);
+	CHECK(seen == 10U);
+}
+
+TEST_CASE("parallel matching agrees with brute force on random graphs") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	for (auto const seed : {1U, 4U, 5U, 6U}) {
+		auto const target = random_graph(10, 24, seed);
+		// A directed triangle with a tail, and two disconnected pieces.
+		auto pattern = gdwg::graph<int, int>{0, 1, 2, 3};
+		pattern.insert_edge(0, 1, 1);
+		pattern.insert_edge(1, 2, 1);
+		pattern.insert_edge(2, 0, 1);
+		pattern.insert_edge(3, 2, 1);
+		auto pieces = gdwg::graph<int, int>{0, 1, 2, 3};
+		pieces.insert_edge(0, 1, 1);
+		pieces.insert_edge(2, 3, 1);
+		pieces.insert_edge(3, 2, 1);
+		for (auto const kind : {gdwg::subgraph_kind::monomorphism, gdwg::subgraph_kind::isomorphism})
+		{
+			CHECK(collect(pattern, target, kind) == brute_force(pattern, target, kind));
+			CHECK(collect(pieces, target, kind) == brute_force(pieces, target, kind));
+		}
+	}
+}
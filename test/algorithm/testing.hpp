@@ -0,0 +1,86 @@
+#ifndef GDWG_TEST_ALGORITHM_TESTING_HPP
+#define GDWG_TEST_ALGORITHM_TESTING_HPP
+
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
+
+// Fixtures shared by the algorithm tests.
+namespace gdwg::testing {
+	// Sets the worker limit until the end of the scope, then restores the default, even when a
+	// REQUIRE fails in between. set_max_threads may still change the limit within the scope.
+	class scoped_max_threads {
+	public:
+		explicit scoped_max_threads(std::size_t threads) noexcept {
+			gdwg::set_max_threads(threads);
+		}
+
+		scoped_max_threads(scoped_max_threads const&) = delete;
+		auto operator=(scoped_max_threads const&) -> scoped_max_threads& = delete;
+
+		~scoped_max_threads() {
+			gdwg::set_max_threads(0U);
+		}
+	};
+
+	// Edge i weighs i % period, for random_graph.
+	inline auto index_weights(int period = std::numeric_limits<int>::max()) {
+		return [period](int i, int, int, std::mt19937&) { return i % period; };
+	}
+
+	// Edge weights drawn uniformly from [min, max], for random_graph.
+	inline auto uniform_weights(int min, int max) {
+		return [distribution = std::uniform_int_distribution<int>{min, max}](
+		          int, int, int, std::mt19937& engine) mutable { return distribution(engine); };
+	}
+
+	namespace detail {
+		template<typename Node, typename Weight>
+		auto random_graph(int nodes, int edges, unsigned seed, Node node, Weight weight) {
+			using edge_type = std::invoke_result_t<Weight&, int, int, int, std::mt19937&>;
+			auto g = gdwg::graph<int, edge_type>{};
+			for (auto i = 0; i < nodes; ++i) {
+				g.insert_node(i);
+			}
+			auto engine = std::mt19937{seed};
+			for (auto i = 0; i < edges; ++i) {
+				auto const from = node(engine);
+				auto const to = node(engine);
+				g.insert_edge(from, to, weight(i, from, to, engine));
+			}
+			return g;
+		}
+	} // namespace detail
+
+	// A graph on the nodes 0 to nodes - 1 with `edges` edges between uniformly random endpoints.
+	// Edge i from `from` to `to` weighs weight(i, from, to, engine), where `engine` is the one
+	// that draws the endpoints, so weights may be fixed, follow the edge, or be random too.
+	template<typename Weight>
+	auto random_graph(int nodes, int edges, unsigned seed, Weight weight) {
+		auto const node = [distribution = std::uniform_int_distribution<int>{0, nodes - 1}](
+		                     std::mt19937& engine) mutable { return distribution(engine); };
+		return detail::random_graph(nodes, edges, seed, node, std::move(weight));
+	}
+
+	inline auto random_graph(int nodes, int edges, unsigned seed) -> gdwg::graph<int, int> {
+		return random_graph(nodes, edges, seed, [](int, int, int, std::mt19937&) { return 1; });
+	}
+
+	// As random_graph, but squaring a uniform draw skews the degrees towards low ids.
+	template<typename Weight>
+	auto skewed_random_graph(int nodes, int edges, unsigned seed, Weight weight) {
+		auto const node = [unit = std::uniform_real_distribution<double>{0.0, 1.0},
+		                   nodes](std::mt19937& engine) mutable {
+			auto const x = unit(engine);
+			return static_cast<int>(x * x * nodes);
+		};
+		return detail::random_graph(nodes, edges, seed, node, std::move(weight));
+	}
+} // namespace gdwg::testing
+
+#endif // GDWG_TEST_ALGORITHM_TESTING_HPP
@@ -0,0 +1,140 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/topological_sort.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	// Whether every edge of the graph goes forwards in `order`, which must list every node once.
+	auto respects(gdwg::graph<int, int> const& g, std::vector<int> const& order) -> bool {
+		if (order.size() != g.nodes().size()) {
+			return false;
+		}
+		auto position = std::map<int, std::size_t>{};
+		for (auto i = std::size_t{0}; i < order.size(); ++i) {
+			position.emplace(order[i], i);
+		}
+		for (auto const& [from, to, weight] : g) {
+			if (position.at(from) >= position.at(to)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	auto reaches(gdwg::graph<int, int> const& g, int src, int dst) -> bool {
+		auto stack = std::vector<int>{src};
+		auto seen = std::map<int, bool>{{src, true}};
+		while (not stack.empty()) {
+			auto const u = stack.back();
+			stack.pop_back();
+			if (u == dst) {
+				return true;
+			}
+			for (auto const v : g.connections(u)) {
+				if (seen.emplace(v, true).second) {
+					stack.push_back(v);
+				}
+			}
+		}
+		return false;
+	}
+} // namespace
+
+TEST_CASE("topological_order orders a DAG and detects cycles") {
+	auto g = gdwg::graph<std::string, int>{"shirt", "tie", "jacket", "belt", "trousers"};
+	CHECK(g.insert_edge("shirt", "tie", 1));
+	CHECK(g.insert_edge("tie", "jacket", 1));
+	CHECK(g.insert_edge("trousers", "belt", 1));
+	CHECK(g.insert_edge("belt", "jacket", 1));
+	CHECK(gdwg::topological_order(g)
+	      == std::vector<std::string>{"shirt", "trousers", "tie", "belt", "jacket"});
+
+	CHECK(g.insert_edge("jacket", "shirt", 1));
+	CHECK(gdwg::topological_order(g) == std::nullopt);
+
+	auto loop = gdwg::graph<int, int>{1};
+	CHECK(loop.insert_edge(1, 1, 0));
+	CHECK(gdwg::topological_order(loop) == std::nullopt);
+}
+
+TEST_CASE("incremental_topological_order repairs the order and rejects cycle-closing edges") {
+	auto order = gdwg::incremental_topological_order<int, int>{};
+	for (auto i = 0; i < 4; ++i) {
+		CHECK(order.insert_node(i));
+	}
+	CHECK(not order.insert_node(0));
+	CHECK(order.insert_edge(3, 2, 1));
+	CHECK(order.insert_edge(2, 1, 1));
+	CHECK(order.insert_edge(2, 1, 2));
+	CHECK(not order.insert_edge(2, 1, 2));
+	CHECK(order.order() == std::vector<int>{0, 3, 2, 1});
+	CHECK(order.precedes(3, 1));
+
+	CHECK(order.would_create_cycle(1, 3));
+	CHECK(not order.would_create_cycle(1, 0));
+	CHECK_THROWS_WITH(order.insert_edge(1, 3, 1),
+	                  "Cannot call gdwg::incremental_topological_order<N, E>::insert_edge when the "
+	                  "edge would create a cycle");
+	CHECK_THROWS_WITH(order.insert_edge(1, 1, 1),
+	                  "Cannot call gdwg::incremental_topological_order<N, E>::insert_edge when the "
+	                  "edge would create a cycle");
+	CHECK(order.order() == std::vector<int>{0, 3, 2, 1});
+	CHECK(not order.get_graph().is_connected(1, 3));
+
+	// One weight remains, so the edge still constrains the order.
+	CHECK(order.erase_edge(2, 1, 1));
+	CHECK(order.would_create_cycle(1, 3));
+	CHECK(order.erase_edge(2, 1, 2));
+	CHECK(order.insert_edge(1, 3, 1));
+	CHECK(order.precedes(1, 3));
+
+	CHECK(order.erase_node(3));
+	CHECK(order.insert_node(7));
+	CHECK(order.insert_edge(7, 0, 1));
+	CHECK(respects(order.get_graph(), order.order()));
+	CHECK_THROWS_WITH(order.insert_edge(7, 9, 1),
+	                  "Cannot call gdwg::incremental_topological_order<N, E>::insert_edge when "
+	                  "either src or dst node does not exist");
+}
+
+TEST_CASE("incremental_topological_order stays valid through random edits") {
+	auto constexpr nodes = 60;
+	auto order = gdwg::incremental_topological_order<int, int>{};
+	for (auto i = nodes - 1; i >= 0; --i) {
+		order.insert_node(i);
+	}
+	auto engine = std::mt19937{6771U};
+	auto node = std::uniform_int_distribution<int>{0, nodes - 1};
+	auto rejected = 0;
+	for (auto step = 0; step < 2000; ++step) {
+		auto const src = node(engine);
+		auto const dst = node(engine);
+		if (step % 5 == 4) {
+			for (auto const w : order.get_graph().weights(src, dst)) {
+				CHECK(order.erase_edge(src, dst, w));
+			}
+			continue;
+		}
+		auto const cycle = src == dst or reaches(order.get_graph(), dst, src);
+		CHECK(order.would_create_cycle(src, dst) == cycle);
+		if (cycle) {
+			CHECK_THROWS_AS(order.insert_edge(src, dst, step), std::runtime_error);
+			++rejected;
+		}
+		else {
+			CHECK(order.insert_edge(src, dst, step));
+		}
+		REQUIRE(respects(order.get_graph(), order.order()));
+	}
+	CHECK(rejected > 0);
+
+	auto const copy = gdwg::incremental_topological_order<int, int>(order.get_graph());
+	CHECK(respects(copy.get_graph(), copy.order()));
+	CHECK(copy.get_graph() == order.get_graph());
+}
@@ -0,0 +1,101 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/triangles.hpp"
+#include "testing.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace {
+	using gdwg::testing::index_weights;
+	using gdwg::testing::skewed_random_graph;
+
+	// Reference counts by checking every triple on an adjacency matrix.
+	auto reference_triangles(gdwg::graph<int, int> const& g) -> std::vector<std::size_t> {
+		auto const n = g.nodes().size();
+		auto adjacent = std::vector<std::vector<char>>(n, std::vector<char>(n, 0));
+		for (auto const& [from, to, weight] : g) {
+			if (from != to) {
+				adjacent[static_cast<std::size_t>(from)][static_cast<std::size_t>(to)] = 1;
+				adjacent[static_cast<std::size_t>(to)][static_cast<std::size_t>(from)] = 1;
+			}
+		}
+		auto counts = std::vector<std::size_t>(n, 0U);
+		for (auto a = std::size_t{0}; a < n; ++a) {
+			for (auto b = a + 1U; b < n; ++b) {
+				for (auto c = b + 1U; c < n; ++c) {
+					if (adjacent[a][b] != 0 and adjacent[b][c] != 0 and adjacent[a][c] != 0) {
+						++counts[a];
+						++counts[b];
+						++counts[c];
+					}
+				}
+			}
+		}
+		return counts;
+	}
+} // namespace
+
+TEST_CASE("triangles ignore directions, multi-edges and self-loops") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("b", "a", 2));
+	CHECK(g.insert_edge("b", "c", 1));
+	CHECK(g.insert_edge("b", "c", 3));
+	CHECK(g.insert_edge("c", "a", 1));
+	CHECK(g.insert_edge("c", "d", 1));
+	CHECK(g.insert_edge("d", "a", 1));
+	CHECK(g.insert_edge("d", "d", 1));
+	CHECK(g.insert_edge("e", "d", 1));
+
+	CHECK(gdwg::triangle_count(g) == 2);
+	CHECK(gdwg::triangles(g) == std::vector<std::size_t>{2, 1, 2, 1, 0});
+	auto const coefficients = gdwg::clustering_coefficients(g);
+	REQUIRE(coefficients.size() == 5);
+	CHECK(coefficients[0] == Approx(2.0 / 3.0));
+	CHECK(coefficients[1] == Approx(1.0));
+	CHECK(coefficients[2] == Approx(2.0 / 3.0));
+	CHECK(coefficients[3] == Approx(1.0 / 3.0));
+	CHECK(coefficients[4] == 0.0);
+}
+
+TEST_CASE("every node of a complete graph has a clustering coefficient of one") {
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 6; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 6; ++i) {
+		for (auto j = i + 1; j < 6; ++j) {
+			g.insert_edge(i, j, 0);
+		}
+	}
+	CHECK(gdwg::triangle_count(g) == 20);
+	CHECK(gdwg::triangles(g) == std::vector<std::size_t>(6, 10));
+	CHECK(gdwg::clustering_coefficients(g) == std::vector<double>(6, 1.0));
+}
+
+TEST_CASE("triangle counts match a brute-force count on skewed random graphs") {
+	auto const threads = gdwg::testing::scoped_max_threads(4U);
+	for (auto const seed : {1U, 2U, 3U}) {
+		auto const g = skewed_random_graph(150, 2500, seed, index_weights(3));
+		auto const expected = reference_triangles(g);
+		CHECK(gdwg::triangles(g) == expected);
+		auto total = std::size_t{0};
+		for (auto const count : expected) {
+			total += count;
+		}
+		CHECK(gdwg::triangle_count(g) * 3U == total);
+	}
+}
+
+TEST_CASE("count_common handles lists of very different lengths") {
+	auto longer = std::vector<std::size_t>{};
+	for (auto i = std::size_t{0}; i < 1000; i += 2) {
+		longer.push_back(i);
+	}
+	auto const shorter = std::vector<std::size_t>{1, 4, 7, 500, 998, 999};
+	CHECK(gdwg::detail::count_common(shorter, longer) == 3);
+	CHECK(gdwg::detail::count_common(longer, shorter) == 3);
+	CHECK(gdwg::detail::count_common(longer, longer) == longer.size());
+	CHECK(gdwg::detail::count_common({}, longer) == 0);
+}